@@ -5,29 +5,59 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
 #include <getopt.h>
 
 #include <core/rvv_helpers.h>
+#include <core/sysinfo.h>
+#include <core/rescache.h>
+#include <core/costmodel.h>
+#include <core/lensched.h>
+#include <core/matrix.h>
+#include <core/rawfile.h>
+#include <core/icount.h>
+#include <core/profile.h>
+#include <core/compare.h>
 #include <core/algset.h>
 
 #include <algorithms/memcpy/alg.h>
 #include <algorithms/mac_16_32_32/alg.h>
 #include <algorithms/mac_8_16_32/alg.h>
 #include <algorithms/png_filters/alg.h>
-
-
-/* ids of algorithms */
-#define ALG_ID_MEMCPY			0
-#define ALG_ID_MAC_16_32_32		1
-#define ALG_ID_MAC_8_16_32		2
-#define ALG_ID_PNG_FILTER_UP3		3
-#define ALG_ID_PNG_FILTER_UP4		4
-#define ALG_ID_PNG_FILTER_SUB3		5
-#define ALG_ID_PNG_FILTER_SUB4		6
-#define ALG_ID_PNG_FILTER_AVG3		7
-#define ALG_ID_PNG_FILTER_AVG4		8
-#define ALG_ID_PNG_FILTER_PAETH3	9
-#define ALG_ID_PNG_FILTER_PAETH4	10
+#include <algorithms/stream/alg.h>
+#include <algorithms/ptrchase/alg.h>
+#include <algorithms/uarch/alg.h>
+
+
+/* known algorithms */
+static const alg_desc_t * const alg_descs[] = {
+	&alg_memcpy_desc,
+	&alg_mac_16_32_32_desc,
+	&alg_mac_8_16_32_desc,
+	&alg_png_filters_desc,
+	&alg_stream_desc,
+	&alg_ptrchase_desc,
+	&alg_uarch_desc,
+};
+#define ALG_DESCS_LEN			(sizeof(alg_descs) / sizeof(alg_descs[0]))
+
+/* matrix entries of bits in algs_enabled mask */
+static const char * const alg_mask_specs[] = {
+	"memcpy",
+	"mac_16_32_32",
+	"mac_8_16_32",
+	"png_filters:filter=up:bpp=3",
+	"png_filters:filter=up:bpp=4",
+	"png_filters:filter=sub:bpp=3",
+	"png_filters:filter=sub:bpp=4",
+	"png_filters:filter=avg:bpp=3",
+	"png_filters:filter=avg:bpp=4",
+	"png_filters:filter=paeth:bpp=3",
+	"png_filters:filter=paeth:bpp=4",
+};
+#define ALG_MASK_SPECS_LEN		(sizeof(alg_mask_specs) / sizeof(alg_mask_specs[0]))
 
 /* alg mask helpers */
 #define alg_mask(id)			(1 << id)
@@ -37,6 +67,16 @@
 #define DEFAULT_QUIET			false
 #define DEFAULT_VERIFY			false
 #define DEFAULT_RANDSEED		0
+#define DEFAULT_COMPARE_THRESHOLD	5.0
+#define DEFAULT_ISOLATE			false
+#define DEFAULT_TIMEOUT			60
+
+/* exit codes of compare (failures take precedence over regressions) */
+#define EXIT_REGRESSION			2
+#define EXIT_FAILED			3
+
+/* maximum number of --matrix arguments */
+#define MAX_MATRIX_SPECS		64
 
 
 void print_version(void)
@@ -52,22 +92,44 @@ void print_version(void)
 	fprintf(stderr, "RISC-V RVV support is ");
 #if RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_NO
 	fprintf(stderr, "disabled\n");
-#elif RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_07
-	fprintf(stderr, "enabled (v0.7)\n");
-#elif RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_08
-	fprintf(stderr, "enabled (v0.8)\n");
-#elif RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_09_10_100
-	fprintf(stderr, "enabled (v0.9/v0.10/v1.0)\n");
+#else /* RVVRADAR_RVV_SUPPORT */
+	/* kernels are built once per draft (fat binary; see rvv_helpers.h) */
+	fprintf(stderr, "enabled (%s)\n", RVVRADAR_RVV_DRAFTS_STR);
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 #else /* RVVRADAR_RV_SUPPORT */
 	fprintf(stderr, "disabled\n");
 #endif /* RVVRADAR_RV_SUPPORT */
+
+	fprintf(stderr, "x86 SIMD support is ");
+#if RVVRADAR_X86_SUPPORT
+	fprintf(stderr, "enabled (sse2, ssse3, avx2, avx512)\n");
+#else /* RVVRADAR_X86_SUPPORT */
+	fprintf(stderr, "disabled\n");
+#endif /* RVVRADAR_X86_SUPPORT */
+
+	/* probed at runtime */
+	char isa[64];
+	sysinfo_get_isa_str(sysinfo_get_isa(), isa, sizeof(isa));
+	fprintf(stderr, "Supported by cpu: %s", isa);
+	if (sysinfo_get_vlen() > 0)
+		fprintf(stderr, " (VLEN=%u, draft %s)",
+			sysinfo_get_vlen(), sysinfo_get_rvv_draft_str());
+	fprintf(stderr, "\n");
 }
 
 
 void print_usage(const char *name)
 {
+	/* algorithms and parameters */
+	char *descs_str = NULL;
+	size_t descs_str_len = 0;
+	FILE *f = open_memstream(&descs_str, &descs_str_len);
+	if (f != NULL) {
+		matrix_print_descs(alg_descs, ALG_DESCS_LEN, "       ", f);
+		fclose(f);
+	}
+
 	print_version();
 	fprintf(stderr, "\n");
 	fprintf(stderr,
@@ -76,6 +138,8 @@ void print_usage(const char *name)
 		"Options:\n"
 		"  --algs_enabled|-a <algs_mask>\n"
 		"     Bitmask of algorithms to run (hexadecimal).\n"
+		"     (Shortcut for --matrix entries; at least one of both\n"
+		"     has to be given)\n"
 		"       bit             algorithm\n"
 		"         0             memcpy\n"
 		"         1             mac_16_32_32 (32bit += 16bit * 16bit)\n"
@@ -89,6 +153,16 @@ void print_usage(const char *name)
 		"         9             png_filter_paeth3\n"
 		"        10             png_filter_paeth4\n"
 		"\n"
+		"  --matrix|-x <alg>[:<param>=<value>[,<value>...]]...\n"
+		"     Run algorithm with all combinations of the given parameter\n"
+		"     values (cartesian product). Parameters not given are run\n"
+		"     with their defaults. The special parameter len overrides\n"
+		"     the length schedule for this entry.\n"
+		"     Can be given multiple times to run a subset of the product.\n"
+		"     (e.g. -x png_filters:filter=up,sub:bpp=1,2,3,4,6,8)\n"
+		"     Algorithms and parameters (values):\n"
+		"%s"
+		"\n"
 		"  --iterations|-i <#iterations>\n"
 		"     Number of iterations to run each algorithm implementation.\n"
 		"\n"
@@ -96,6 +170,7 @@ void print_usage(const char *name)
 		"     Initial number of elements to run algorithm implementations\n"
 		"     with.\n"
 		"     (Will be doubled until len_end is reached).\n"
+		"     (Shortcut for --len_schedule geo:<len_start>:<len_end>:2)\n"
 		"\n"
 		"  [--len_end|-e <#elements>]\n"
 		"     Final number of elements to run algorithm implementations\n"
@@ -103,6 +178,23 @@ void print_usage(const char *name)
 		"     (len_start will be doubled until len_end is reached).\n"
 		"     (Default: value given with --len_start)\n"
 		"\n"
+		"  --len_schedule|-l <schedule>\n"
+		"     Schedule of numbers of elements to run algorithm\n"
+		"     implementations with (alternative to len_start/len_end).\n"
+		"       geo:<start>:<end>:<factor>\n"
+		"         geometric; multiplied by factor (>1.0) per step\n"
+		"       lin:<start>:<end>:<step>\n"
+		"         linear; incremented by step\n"
+		"       list:<len>[,<len>...]\n"
+		"         explicit list\n"
+		"       vlen:<kstart>:<kend>[:<delta>]\n"
+		"         k*VLMAX-delta, k*VLMAX, k*VLMAX+delta for k in\n"
+		"         [kstart, kend] (VLMAX of e8/m1; delta default: 1)\n"
+		"       rand:<min>:<max>:<count>[:<seed>]\n"
+		"         count random lengths in [min, max] (seed default: 0)\n"
+		"     The schedule is recorded in the output (csv column\n"
+		"     len_schedule, jsonl meta record; seed of rand explicit).\n"
+		"\n"
 		"  [--randseed|-r <seed>]\n"
 		"     Set random seed for test data.\n"
 		"     (Default: %u)\n"
@@ -115,6 +207,91 @@ void print_usage(const char *name)
 		"     interference (caches, ...) as possible.\n"
 		"     (Default: %s)\n"
 		"\n"
+		"  [--cache|-c <file>]\n"
+		"     Persistent results cache.\n"
+		"     Results found in the cache for the running machine (cpu,\n"
+		"     rvv draft, VLEN and build of RVVRadar) and the same\n"
+		"     iterations, randseed and isolate are restored instead of\n"
+		"     measured.\n"
+		"     Missing or stale results are measured and stored.\n"
+		"     The cache is not used if verify is set.\n"
+		"     (Default: disabled)\n"
+		"\n"
+		"  [--costmodel|-m <file>]\n"
+		"     Fit a piecewise-linear cost model (setup + per element\n"
+		"     cost, split on knees like cache-levels) over all lengths\n"
+		"     for each implementation and determine crossover lengths\n"
+		"     between implementations of the same algorithm.\n"
+		"     The model is written as csv to the given file and printed\n"
+		"     human readable (if quiet is not set).\n"
+		"     (Default: disabled)\n"
+		"\n"
+		"  [--format|-f <format>]\n"
+		"     Format of results on stdout.\n"
+		"       csv    comma separated values (see Output)\n"
+		"       jsonl  JSON Lines: one metadata record (version, build\n"
+		"              flags, rvv draft, VLEN, cpu, clock) followed by\n"
+		"              one record per implementation\n"
+		"     (Default: csv)\n"
+		"\n"
+		"  [--raw|-w <file>]\n"
+		"     Write all single measurements to a binary raw samples\n"
+		"     file with index (memory-mappable, see core/rawfile.h).\n"
+		"     Records refer to entries by raw_index (jsonl only).\n"
+		"     (Default: disabled)\n"
+		"\n"
+		"  [--compare|-b <results>]\n"
+		"     Compare results against a previous run (baseline; csv or\n"
+		"     jsonl output of RVVRadar). Results are matched by set,\n"
+		"     algorithm, parameters and implementation. A result is a\n"
+		"     regression if its median is slower by more than the\n"
+		"     threshold and the difference is significant (z-test on\n"
+		"     medians). A result with fails (verification, crash or\n"
+		"     timeout) is a failure if it was error free in the\n"
+		"     baseline. Regressions and failures are reported on stderr\n"
+		"     (all results if quiet is not set).\n"
+		"     Exit codes: 0 .. ok; %i .. regressions; %i .. failures\n"
+		"     (with or without regressions); other .. error.\n"
+		"     (Default: disabled)\n"
+		"\n"
+		"  [--compare_threshold|-t <percent>]\n"
+		"     Relative threshold of median changes for compare.\n"
+		"     (Default: %.1f)\n"
+		"\n"
+		"  [--isolate|-k]\n"
+		"     Run each implementation isolated in a forked child\n"
+		"     process. Crashes (e.g. SIGILL on unsupported instructions,\n"
+		"     SIGSEGV on buffer overruns) and timeouts are reported as\n"
+		"     fails with the terminating signal (status) and the run\n"
+		"     continues.\n"
+		"     (Default: %s)\n"
+		"\n"
+		"  [--timeout|-o <seconds>]\n"
+		"     Watchdog timeout per implementation (all iterations) for\n"
+		"     isolate (0 .. none).\n"
+		"     (Default: %u)\n"
+		"\n"
+		"  [--icount|-n <file>]\n"
+		"     Instruction count profiling mode (RISC-V; run under\n"
+		"     qemu-riscv64 with the TCG plugin tools/qemu_icount.c).\n"
+		"     The instructions executed by each implementation are\n"
+		"     counted by the plugin (scalar, vector config, vector\n"
+		"     load/store and vector arithmetic) and read from the\n"
+		"     counts file written by the plugin (out=<file>). Counts per\n"
+		"     run are appended as columns (csv) or field icount (jsonl).\n"
+		"     The cache is not used if icount is set.\n"
+		"     (Default: disabled)\n"
+		"\n"
+		"  [--profile|-p <file>]\n"
+		"     Sampling profiler (perf events; cycles or cpu-clock).\n"
+		"     The instruction pointer is sampled during the measured\n"
+		"     executions and resolved against the symbol table of the\n"
+		"     binary. The hot spots of each implementation (symbol,\n"
+		"     offset, address, samples and share) are written as csv to\n"
+		"     the given file. Can not be combined with isolate.\n"
+		"     The cache is not used if profile is set.\n"
+		"     (Default: disabled)\n"
+		"\n"
 		"  [--quiet|-q]\n"
 		"     Prevent human readable output (progress and statistics).\n"
 		"     (Default: %s)\n"
@@ -129,9 +306,17 @@ void print_usage(const char *name)
 		"          and errors (independent of quiet).\n"
 		"\n",
 		name,
+		descs_str ? descs_str : "",
 		DEFAULT_RANDSEED,
 		DEFAULT_VERIFY ? "true" : "false",
+		EXIT_REGRESSION,
+		EXIT_FAILED,
+		DEFAULT_COMPARE_THRESHOLD,
+		DEFAULT_ISOLATE ? "true" : "false",
+		DEFAULT_TIMEOUT,
 		DEFAULT_QUIET ? "true" : "false");
+
+	free(descs_str);
 }
 
 
@@ -148,6 +333,25 @@ int main(int argc, char **argv)
 	unsigned int len_start = 0;
 	unsigned int alg_ena_mask = 0;
 	unsigned int len_end = 0;
+	const char *len_schedule = NULL;
+	const char *cache_path = NULL;
+	rescache_t *rescache = NULL;
+	const char *costmodel_path = NULL;
+	costmodel_t *costmodel = NULL;
+	const char *compare_path = NULL;
+	double compare_threshold = DEFAULT_COMPARE_THRESHOLD;
+	compare_t *compare = NULL;
+	bool isolate = DEFAULT_ISOLATE;
+	unsigned int timeout = DEFAULT_TIMEOUT;
+	enum algset_format format = ALGSET_FORMAT_CSV;
+	const char *raw_path = NULL;
+	rawfile_t *rawfile = NULL;
+	const char *icount_path = NULL;
+	icount_t *icount = NULL;
+	const char *profile_path = NULL;
+	profile_t *profile = NULL;
+	const char *matrix_specs[MAX_MATRIX_SPECS];
+	unsigned int nmatrix_specs = 0;
 
 	/* parameter parsing */
 
@@ -159,12 +363,24 @@ int main(int argc, char **argv)
 		{"iterations",		required_argument,	0,	'i'	},
 		{"len_start",		required_argument,	0,	's'	},
 		{"len_end",		required_argument,	0,	'e'	},
+		{"len_schedule",	required_argument,	0,	'l'	},
 		{"algs_enabled",	required_argument,	0,	'a'	},
+		{"matrix",		required_argument,	0,	'x'	},
+		{"cache",		required_argument,	0,	'c'	},
+		{"costmodel",		required_argument,	0,	'm'	},
+		{"compare",		required_argument,	0,	'b'	},
+		{"compare_threshold",	required_argument,	0,	't'	},
+		{"format",		required_argument,	0,	'f'	},
+		{"raw",			required_argument,	0,	'w'	},
+		{"isolate",		no_argument,		0,	'k'	},
+		{"timeout",		required_argument,	0,	'o'	},
+		{"icount",		required_argument,	0,	'n'	},
+		{"profile",		required_argument,	0,	'p'	},
 		{"help",		no_argument,		0,	'h'	},
 		{0,			0,			0,	0	}
 	};
 
-	while ((opt = getopt_long(argc, argv, "qr:vi:s:e:a:h",
+	while ((opt = getopt_long(argc, argv, "qr:vi:s:e:l:a:x:c:m:b:t:f:w:ko:n:p:h",
 				  long_options, &long_index )) != -1) {
 		int ret = -1;
 		switch (opt) {
@@ -186,9 +402,60 @@ int main(int argc, char **argv)
 		case 'e':
 			len_end = atoi(optarg);
 			break;
+		case 'l':
+			len_schedule = optarg;
+			break;
 		case 'a':
 			sscanf(optarg, "%X", &alg_ena_mask);
 			break;
+		case 'x':
+			if (nmatrix_specs == MAX_MATRIX_SPECS) {
+				fprintf(stderr,
+					"Error: Too many arguments \"--matrix\" (max %u)!\n",
+					MAX_MATRIX_SPECS);
+				return -1;
+			}
+			matrix_specs[nmatrix_specs++] = optarg;
+			break;
+		case 'c':
+			cache_path = optarg;
+			break;
+		case 'm':
+			costmodel_path = optarg;
+			break;
+		case 'b':
+			compare_path = optarg;
+			break;
+		case 't':
+			compare_threshold = atof(optarg);
+			break;
+		case 'f':
+			if (strcmp(optarg, "csv") == 0)
+				format = ALGSET_FORMAT_CSV;
+			else if (strcmp(optarg, "jsonl") == 0)
+				format = ALGSET_FORMAT_JSONL;
+			else {
+				fprintf(stderr,
+					"Error: Invalid argument \"--format\" (%s)!\n", optarg);
+				print_usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'w':
+			raw_path = optarg;
+			break;
+		case 'k':
+			isolate = true;
+			break;
+		case 'o':
+			timeout = atoi(optarg);
+			break;
+		case 'n':
+			icount_path = optarg;
+			break;
+		case 'p':
+			profile_path = optarg;
+			break;
 		case 'h':
 			ret = 0;
 		default:
@@ -197,9 +464,9 @@ int main(int argc, char **argv)
 		}
 	}
 
-	if (alg_ena_mask == 0) {
+	if (alg_ena_mask == 0 && nmatrix_specs == 0) {
 		fprintf(stderr,
-			"Error: Missing, or invalid argument \"--algs_enabled\"!\n");
+			"Error: Missing, or invalid argument \"--algs_enabled\" or \"--matrix\"!\n");
 		print_usage(argv[0]);
 		return -1;
 	}
@@ -211,23 +478,81 @@ int main(int argc, char **argv)
 		return -1;
 	}
 
-	if (len_start == 0) {
+	/* samples are taken in the process running the implementations */
+	if (profile_path != NULL && isolate) {
 		fprintf(stderr,
-			"Error: Missing, or invalid \"--len_start\"!\n");
+			"Error: \"--profile\" can not be combined with \"--isolate\"!\n");
 		print_usage(argv[0]);
 		return -1;
 	}
-	if (len_end == 0)
-		len_end = len_start;
 
-	if (len_end < len_start) {
+	char len_schedule_buf[64];
+	if (len_schedule != NULL) {
+		if (len_start != 0 || len_end != 0) {
+			fprintf(stderr,
+				"Error: \"--len_schedule\" can not be combined with \"--len_start\"/\"--len_end\"!\n");
+			print_usage(argv[0]);
+			return -1;
+		}
+	} else {
+		if (len_start == 0) {
+			fprintf(stderr,
+				"Error: Missing, or invalid \"--len_start\" or \"--len_schedule\"!\n");
+			print_usage(argv[0]);
+			return -1;
+		}
+		if (len_end == 0)
+			len_end = len_start;
+
+		if (len_end < len_start) {
+			fprintf(stderr,
+				"Error: Invalid argument: len_end(%i) < len_start(%i)!\n",
+				len_end, len_start);
+			print_usage(argv[0]);
+			return -1;
+		}
+
+		/* start with len_start and double len until len_end */
+		snprintf(len_schedule_buf, sizeof(len_schedule_buf),
+			 "geo:%u:%u:2", len_start, len_end);
+		len_schedule = len_schedule_buf;
+	}
+
+	lensched_t *lensched = lensched_create(len_schedule);
+	if (lensched == NULL) {
 		fprintf(stderr,
-			"Error: Invalid argument: len_end(%i) < len_start(%i)!\n",
-			len_end, len_start);
+			"Error: Invalid argument \"--len_schedule\" (%s): %s!\n",
+			len_schedule, strerror(errno));
 		print_usage(argv[0]);
 		return -1;
 	}
 
+	/* build up parameter matrix */
+	matrix_t *matrix = matrix_create(alg_descs, ALG_DESCS_LEN, lensched);
+	if (matrix == NULL) {
+		perror("Error creating parameter matrix");
+		ret = -1;
+		goto __ret_lensched_destroy;
+	}
+
+	for (int i = 0; i < ALG_MASK_SPECS_LEN; i++)
+		if (alg_enabled(alg_ena_mask, i))
+			if (matrix_add(matrix, alg_mask_specs[i]) < 0) {
+				perror("Error adding algorithm");
+				ret = -1;
+				goto __ret_matrix_destroy;
+			}
+
+	for (int i = 0; i < nmatrix_specs; i++)
+		if (matrix_add(matrix, matrix_specs[i]) < 0) {
+			fprintf(stderr,
+				"Error: Invalid argument \"--matrix\" (%s): %s!\n",
+				matrix_specs[i], strerror(errno));
+			print_usage(argv[0]);
+			ret = -1;
+			goto __ret_matrix_destroy;
+		}
+
 	if (!quiet) {
 		print_version();
 		fprintf(stderr, "\n");
@@ -235,112 +560,187 @@ int main(int argc, char **argv)
 		fprintf(stderr, "   + randseed:       %u\n", randseed);
 		fprintf(stderr, "   + verify:         %s\n", verify ? "true" : "false");
 		fprintf(stderr, "   + iterations:     %u\n", iterations);
-		fprintf(stderr, "   + len_start:      %u\n", len_start);
-		fprintf(stderr, "   + len_end:        %u\n", len_end);
-		fprintf(stderr, "   + algs_enabled: 0x%X\n", alg_ena_mask);
+		fprintf(stderr, "   + len_schedule:   %s\n", lensched->spec);
+		fprintf(stderr, "   + lens:          ");
+		for (int i = 0; i < lensched->nlens; i++)
+			fprintf(stderr, " %u", lensched->lens[i]);
+		fprintf(stderr, "\n");
+		fprintf(stderr, "   + algs_enabled:   0x%X\n", alg_ena_mask);
+		for (int i = 0; i < nmatrix_specs; i++)
+			fprintf(stderr, "   + matrix:         %s\n", matrix_specs[i]);
+		fprintf(stderr, "   + algorithms:     %lu\n", matrix_count(matrix));
+		fprintf(stderr, "   + cache:          %s\n", cache_path ? cache_path : "disabled");
+		fprintf(stderr, "   + costmodel:      %s\n", costmodel_path ? costmodel_path : "disabled");
+		fprintf(stderr, "   + compare:        %s\n", compare_path ? compare_path : "disabled");
+		if (compare_path)
+			fprintf(stderr, "   + threshold:      %.1f%%\n", compare_threshold);
+		fprintf(stderr, "   + format:         %s\n", format == ALGSET_FORMAT_JSONL ? "jsonl" : "csv");
+		fprintf(stderr, "   + raw:            %s\n", raw_path ? raw_path : "disabled");
+		fprintf(stderr, "   + isolate:        %s\n", isolate ? "true" : "false");
+		if (isolate)
+			fprintf(stderr, "   + timeout:        %us\n", timeout);
+		fprintf(stderr, "   + icount:         %s\n", icount_path ? icount_path : "disabled");
+		fprintf(stderr, "   + profile:        %s\n", profile_path ? profile_path : "disabled");
+	}
+
+	/* load results cache */
+	if (cache_path != NULL) {
+		rescache = rescache_load(cache_path);
+		if (rescache == NULL) {
+			perror("Error loading results cache");
+			ret = -1;
+			goto __ret_matrix_destroy;
+		}
+		if (!quiet)
+			fprintf(stderr, "   + machine key:    %s\n", rescache->machine_key);
 	}
 
 	/* build up set of algorithms */
 
 	algset_t *algset = algset_create("RVVRadar");
-	if (algset == NULL)
-		return -1;
-
-	/* start with len_start and double len until len_end */
-	for (int len = len_start; len <= len_end; len <<= 1) {
-
-		if (alg_enabled(alg_ena_mask, ALG_ID_MEMCPY))
-			if (alg_memcpy_add(algset, len) < 0) {
-				perror("Error adding memcpy");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
-
-		if (alg_enabled(alg_ena_mask, ALG_ID_MAC_16_32_32))
-			if (alg_mac_16_32_32_add(algset, len) < 0) {
-				perror("Error adding mac_16_32_32");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
-
-		if (alg_enabled(alg_ena_mask, ALG_ID_MAC_8_16_32))
-			if (alg_mac_8_16_32_add(algset, len) < 0) {
-				perror("Error adding mac_8_16_32");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
-
-		if (alg_enabled(alg_ena_mask, ALG_ID_PNG_FILTER_UP3))
-			if (alg_png_filters_add(algset, up, bpp3, len) < 0) {
-				perror("Error adding png_filter_up3");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
-
-		if (alg_enabled(alg_ena_mask, ALG_ID_PNG_FILTER_UP4))
-			if (alg_png_filters_add(algset, up, bpp4, len) < 0) {
-				perror("Error adding png_filter_up4");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
-
-		if (alg_enabled(alg_ena_mask, ALG_ID_PNG_FILTER_SUB3))
-			if (alg_png_filters_add(algset, sub, bpp3, len) < 0) {
-				perror("Error adding png_filter_sub3");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
-
-		if (alg_enabled(alg_ena_mask, ALG_ID_PNG_FILTER_SUB4))
-			if (alg_png_filters_add(algset, sub, bpp4, len) < 0) {
-				perror("Error adding png_filter_sub4");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
+	if (algset == NULL) {
+		ret = -1;
+		goto __ret_rescache_destroy;
+	}
+	algset_set_rescache(algset, rescache);
+	algset_set_format(algset, format);
+	algset_set_isolate(algset, isolate, timeout);
+	algset_set_len_schedule(algset, lensched->spec);
+
+	if (compare_path != NULL) {
+		compare = compare_load(compare_path, compare_threshold / 100.0);
+		if (compare == NULL) {
+			perror("Error loading results to compare");
+			ret = -1;
+			goto __ret_algset_destroy;
+		}
+		algset_set_compare(algset, compare);
+	}
 
-		if (alg_enabled(alg_ena_mask, ALG_ID_PNG_FILTER_AVG3))
-			if (alg_png_filters_add(algset, avg, bpp3, len) < 0) {
-				perror("Error adding png_filter_avg3");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
+	if (raw_path != NULL) {
+		rawfile = rawfile_create(raw_path);
+		if (rawfile == NULL) {
+			perror("Error creating raw samples file");
+			ret = -1;
+			goto __ret_algset_destroy;
+		}
+		algset_set_rawfile(algset, rawfile);
+	}
 
-		if (alg_enabled(alg_ena_mask, ALG_ID_PNG_FILTER_AVG4))
-			if (alg_png_filters_add(algset, avg, bpp4, len) < 0) {
-				perror("Error adding png_filter_avg4");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
+	if (icount_path != NULL) {
+		icount = icount_open(icount_path);
+		if (icount == NULL) {
+			if (errno == ENODATA)
+				fprintf(stderr,
+					"Error: No instruction counts in \"%s\" (not running under qemu with plugin?)!\n",
+					icount_path);
+			else
+				perror("Error opening instruction counts file");
+			ret = -1;
+			goto __ret_algset_destroy;
+		}
+		algset_set_icount(algset, icount);
+	}
 
-		if (alg_enabled(alg_ena_mask, ALG_ID_PNG_FILTER_PAETH3))
-			if (alg_png_filters_add(algset, paeth, bpp3, len) < 0) {
-				perror("Error adding png_filter_paeth3");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
+	if (profile_path != NULL) {
+		profile = profile_create(profile_path);
+		if (profile == NULL) {
+			perror("Error creating profiler (perf_event_paranoid?)");
+			ret = -1;
+			goto __ret_algset_destroy;
+		}
+		if (!quiet)
+			fprintf(stderr, "   + event:          %s (period %" PRIu64 ")\n",
+				profile->event, profile->period);
+		algset_set_profile(algset, profile);
+	}
 
-		if (alg_enabled(alg_ena_mask, ALG_ID_PNG_FILTER_PAETH4))
-			if (alg_png_filters_add(algset, paeth, bpp4, len) < 0) {
-				perror("Error adding png_filter_paeth4");
-				ret = -1;
-				goto __ret_algset_destroy;
-			}
+	if (costmodel_path != NULL) {
+		costmodel = costmodel_create();
+		if (costmodel == NULL) {
+			ret = -1;
+			goto __ret_algset_destroy;
+		}
+		algset_set_costmodel(algset, costmodel);
 	}
 
-	/* execution */
-	algset_reset(algset);
+	/*
+	 * algorithms are created (expanded from matrix), run and destroyed
+	 * one after the other
+	 */
+	algset_set_source(algset, matrix_add_next, matrix);
 
+	/* execution */
 	if (algset_run(algset, randseed, iterations, verify, !quiet) < 0) {
 		perror("Error on run");
 		ret = -1;
 		goto __ret_algset_destroy;
 	}
 
+	/* finalize raw samples file */
+	if (rawfile != NULL) {
+		int r = rawfile_close(rawfile);
+		rawfile = NULL;
+		if (r < 0) {
+			perror("Error writing raw samples file");
+			ret = -1;
+			goto __ret_algset_destroy;
+		}
+	}
+
+	/* save results cache */
+	if (rescache != NULL) {
+		if (rescache_save(rescache) < 0) {
+			perror("Error saving results cache");
+			ret = -1;
+			goto __ret_algset_destroy;
+		}
+		if (!quiet)
+			fprintf(stderr, " + cache: %u restored, %u measured and stored\n",
+				rescache->hits, rescache->stores);
+	}
+
+	/* fit and write cost model */
+	if (costmodel != NULL) {
+		FILE *f = fopen(costmodel_path, "w");
+		if (f == NULL) {
+			perror("Error opening costmodel file");
+			ret = -1;
+			goto __ret_algset_destroy;
+		}
+		costmodel_fit(costmodel);
+		costmodel_print_csv(costmodel, f);
+		fclose(f);
+		if (!quiet)
+			costmodel_print_pretty(costmodel, " ", stderr);
+	}
+
 	ret = 0;
 
+	/* report comparison (regressions independent of quiet) */
+	if (compare != NULL) {
+		compare_print_report(compare, !quiet, stderr);
+		if (compare->nfailed > 0)
+			ret = EXIT_FAILED;
+		else if (compare->nregressions > 0)
+			ret = EXIT_REGRESSION;
+	}
+
 	/* cleanup */
 
 __ret_algset_destroy:
+	if (rawfile != NULL)
+		rawfile_close(rawfile);
+	icount_close(icount);
+	profile_destroy(profile);
+	compare_destroy(compare);
+	costmodel_destroy(costmodel);
 	algset_destroy(algset);
+__ret_rescache_destroy:
+	rescache_destroy(rescache);
+__ret_matrix_destroy:
+	matrix_destroy(matrix);
+__ret_lensched_destroy:
+	lensched_destroy(lensched);
 	exit(ret);
 }
@@ -8,6 +8,7 @@
 #include <string.h>
 
 #include <core/rvv_helpers.h>
+#include <core/c_variants.h>
 #include "alg.h"
 
 
@@ -81,12 +82,19 @@ static int impl_postexec(impl_t *impl, bool verify)
 static int impl_add(
 	alg_t *alg,
 	const char *name,
+	const impl_req_t *req,
 	mac_16_32_32_fp_t mac_16_32_32)
 {
 	impl_t *impl;
 
+	/* kernel not built for the rvv draft of the cpu (see RVV_SELECT) or
+	 * not generated (jit not supported by the cpu; see rvvjit_supported) */
+	if (mac_16_32_32 == NULL)
+		return 0;
+
 	impl = alg_add_impl(alg,
 			    name,
+			    req,
 			    NULL,
 			    impl_preexec,
 			    impl_exec_wrapper,
@@ -106,40 +114,61 @@ static int impl_add(
 
 extern void mac_16_32_32_c_byte_noavect(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
 extern void mac_16_32_32_c_byte_avect(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
+#define MAC_16_32_32_C_MATRIX_DECLARE(_v_) extern void mac_16_32_32_c_byte_##_v_(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
+C_MATRIX_FOREACH(MAC_16_32_32_C_MATRIX_DECLARE)
+extern void mac_16_32_32_vext_128(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
+extern void mac_16_32_32_vext_256(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
+extern void mac_16_32_32_vext_512(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
 #if RVVRADAR_RVV_SUPPORT
-#if (\
-	RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_07 || \
-	RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_08 \
-    )
+RVV_DECLARE(mac_16_32_32_rvv_e16_widening, (int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len));
+RVV_DECLARE(mac_16_32_32_rvv_intrinsics_e16_widening, (int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len));
 /*
  * These implementation only makes sense for rvv v0.7 and v0.8
  * In newer specs, there are no signed loads. Instead a unsigned load
  * must be combined with vsext, which adds an additional penalty.
  * Since these implementations generally are known to be less performant
  * it was decided to drop them completely for newer rvv drafts.
+ * (only built for v0.7 and v0.8 -> not registered on newer drafts)
  */
-extern void mac_16_32_32_rvv_e32(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
-#endif /* RVVRADAR_RVV_SUPPORT_VER_07/08 */
-extern void mac_16_32_32_rvv_e16_widening(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
+RVV_DECLARE(mac_16_32_32_rvv_e32, (int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len));
+/* results are accessed as e32 elements */
+static const impl_req_t req_rvv = { .isa = SYSINFO_ISA_RVV, .align = 4 };
+/* generated at runtime (see impl_jit.c) */
+extern void *mac_16_32_32_jit_get(void);
 #endif /* RVVRADAR_RVV_SUPPORT */
+#if RVVRADAR_X86_SUPPORT
+extern void mac_16_32_32_x86_sse2(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
+extern void mac_16_32_32_x86_avx2(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
+extern void mac_16_32_32_x86_avx512(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len);
+static const impl_req_t req_sse2 = { .isa = SYSINFO_ISA_SSE2 };
+static const impl_req_t req_avx2 = { .isa = SYSINFO_ISA_AVX2 };
+static const impl_req_t req_avx512 = { .isa = SYSINFO_ISA_AVX512 };
+#endif /* RVVRADAR_X86_SUPPORT */
 
 static int impls_add(alg_t *alg)
 {
 	int ret = 0;
 
-	ret |= impl_add(alg, "c byte noavect",				(mac_16_32_32_fp_t)mac_16_32_32_c_byte_noavect);
-	ret |= impl_add(alg, "c byte avect",				(mac_16_32_32_fp_t)mac_16_32_32_c_byte_avect);
+	ret |= impl_add(alg, "c byte noavect",				NULL, (mac_16_32_32_fp_t)mac_16_32_32_c_byte_noavect);
+	ret |= impl_add(alg, "c byte avect",				NULL, (mac_16_32_32_fp_t)mac_16_32_32_c_byte_avect);
+#define MAC_16_32_32_C_MATRIX_ADD(_v_) ret |= impl_add(alg, "c byte " #_v_, NULL, (mac_16_32_32_fp_t)mac_16_32_32_c_byte_##_v_);
+	C_MATRIX_FOREACH(MAC_16_32_32_C_MATRIX_ADD)
+	ret |= impl_add(alg, "vext 128bit",				NULL, (mac_16_32_32_fp_t)mac_16_32_32_vext_128);
+	ret |= impl_add(alg, "vext 256bit",				NULL, (mac_16_32_32_fp_t)mac_16_32_32_vext_256);
+	ret |= impl_add(alg, "vext 512bit",				NULL, (mac_16_32_32_fp_t)mac_16_32_32_vext_512);
 
-#if RVVRADAR_RVV_SUPPORT
+#if RVVRADAR_X86_SUPPORT
+	ret |= impl_add(alg, "x86 sse2",				&req_sse2, (mac_16_32_32_fp_t)mac_16_32_32_x86_sse2);
+	ret |= impl_add(alg, "x86 avx2",				&req_avx2, (mac_16_32_32_fp_t)mac_16_32_32_x86_avx2);
+	ret |= impl_add(alg, "x86 avx512",				&req_avx512, (mac_16_32_32_fp_t)mac_16_32_32_x86_avx512);
+#endif /* RVVRADAR_X86_SUPPORT */
 
-#if (\
-	RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_07 || \
-	RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_08 \
-    )
-	ret |= impl_add(alg, "rvv 32bit elements",			(mac_16_32_32_fp_t)mac_16_32_32_rvv_e32);
-#endif /* RVVRADAR_RVV_SUPPORT_VER_07/08 */
+#if RVVRADAR_RVV_SUPPORT
 
-	ret |= impl_add(alg, "rvv 16bit elements with widening",	(mac_16_32_32_fp_t)mac_16_32_32_rvv_e16_widening);
+	ret |= impl_add(alg, "rvv 32bit elements",			&req_rvv, (mac_16_32_32_fp_t)RVV_SELECT(mac_16_32_32_rvv_e32));
+	ret |= impl_add(alg, "rvv 16bit elements with widening",	&req_rvv, (mac_16_32_32_fp_t)RVV_SELECT(mac_16_32_32_rvv_e16_widening));
+	ret |= impl_add(alg, "rvv intrinsics 16bit elements with widening",	&req_rvv, (mac_16_32_32_fp_t)RVV_SELECT(mac_16_32_32_rvv_intrinsics_e16_widening));
+	ret |= impl_add(alg, "rvv jit",				&req_rvv, (mac_16_32_32_fp_t)mac_16_32_32_jit_get());
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 	if (ret)
@@ -153,20 +182,23 @@ static int alg_preexec(struct alg *alg, int seed)
 {
 	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
 
+	/* len may be padded (see alg_add_impl) */
+	d->len = alg->len;
+
 	/* alloc */
-	d->mul1 = malloc(d->len * sizeof(*d->mul1));
+	d->mul1 = alg_alloc(alg, d->len * sizeof(*d->mul1));
 	if (d->mul1 == NULL)
 		goto __err_mul1;
-	d->mul2 = malloc(d->len * sizeof(*d->mul2));
+	d->mul2 = alg_alloc(alg, d->len * sizeof(*d->mul2));
 	if (d->mul2 == NULL)
 		goto __err_mul2;
-	d->add = malloc(d->len * sizeof(*d->add));
+	d->add = alg_alloc(alg, d->len * sizeof(*d->add));
 	if (d->add == NULL)
 		goto __err_add;
-	d->add_res = malloc(d->len * sizeof(*d->add_res));
+	d->add_res = alg_alloc(alg, d->len * sizeof(*d->add_res));
 	if (d->add_res == NULL)
 		goto __err_res;
-	d->compare = malloc(d->len * sizeof(*d->compare));
+	d->compare = alg_alloc(alg, d->len * sizeof(*d->compare));
 	if (d->compare == NULL)
 		goto __err_compare;
 
@@ -222,6 +254,7 @@ int alg_mac_16_32_32_add(algset_t *algset, unsigned int len)
 	alg_t *alg = alg_create(
 			     "mac 32bit += 16bit * 16bit",
 			     parastr,
+			     len,
 			     alg_preexec,
 			     alg_postexec,
 			     sizeof(struct data));
@@ -246,3 +279,16 @@ int alg_mac_16_32_32_add(algset_t *algset, unsigned int len)
 
 	return 0;
 }
+
+
+static int alg_mac_16_32_32_desc_add(algset_t *algset, unsigned int len, const unsigned int *values)
+{
+	return alg_mac_16_32_32_add(algset, len);
+}
+
+
+const alg_desc_t alg_mac_16_32_32_desc = {
+	.name = "mac_16_32_32",
+	.description = "32bit += 16bit * 16bit",
+	.add = alg_mac_16_32_32_desc_add,
+};
@@ -9,6 +9,9 @@
 
 #include <core/algset.h>
 
+/* descriptor (no parameters) */
+extern const alg_desc_t alg_mac_16_32_32_desc;
+
 int alg_mac_16_32_32_add(algset_t *algset, unsigned int len);
 
 #endif /* ALG_MAC_16_32_32_H */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+
+#include <core/sysinfo.h>
+#include <core/rvvjit.h>
+
+
+/*
+ * mac(a0: add_res, a1: mul1, a2: mul2, a3: len)
+ *
+ * like rvv 16bit elements with widening, but the element width is
+ * switched with vl preserving vsetvli (rs1 = rd = zero; same SEW/LMUL
+ * ratio) and the pointer increments are shifts of vl
+ *
+ * add_res ..	[v0-v7](e32)
+ * mul1 ..	[v8-v11](e16)
+ * mul2 ..	[v12-v15](e16)
+ * t0 .. vl; t1 .. vl * 2 (bytes of e16); t2 .. vl * 4 (bytes of e32)
+ */
+static void *mac_16_32_32_jit_generate(void)
+{
+	unsigned int loop, end;
+
+	rvvjit_t *jit = rvvjit_create();
+	if (jit == NULL)
+		return NULL;
+
+	end = rvvjit_branch_fwd(jit, RVVJIT_BEQ, RVVJIT_A3, RVVJIT_ZERO);
+	loop = rvvjit_label(jit);
+
+	rvvjit_vsetvli(jit, RVVJIT_T0, RVVJIT_A3, 32, 8);
+	rvvjit_vle(jit, 32, 0, RVVJIT_A0);
+	rvvjit_vsetvli(jit, RVVJIT_ZERO, RVVJIT_ZERO, 16, 4);
+	rvvjit_vle(jit, 16, 8, RVVJIT_A1);
+	rvvjit_vle(jit, 16, 12, RVVJIT_A2);
+	rvvjit_vwmacc_vv(jit, 0, 8, 12);
+	rvvjit_vsetvli(jit, RVVJIT_ZERO, RVVJIT_ZERO, 32, 8);
+	rvvjit_vse(jit, 32, 0, RVVJIT_A0);
+
+	rvvjit_slli(jit, RVVJIT_T1, RVVJIT_T0, 1);
+	rvvjit_slli(jit, RVVJIT_T2, RVVJIT_T0, 2);
+	rvvjit_add(jit, RVVJIT_A1, RVVJIT_A1, RVVJIT_T1);
+	rvvjit_add(jit, RVVJIT_A2, RVVJIT_A2, RVVJIT_T1);
+	rvvjit_add(jit, RVVJIT_A0, RVVJIT_A0, RVVJIT_T2);
+	rvvjit_sub(jit, RVVJIT_A3, RVVJIT_A3, RVVJIT_T0);
+	rvvjit_branch(jit, RVVJIT_BNE, RVVJIT_A3, RVVJIT_ZERO, loop);
+
+	rvvjit_resolve(jit, end);
+	rvvjit_ret(jit);
+
+	return rvvjit_finalize(jit);
+}
+
+
+/* generated once; NULL if not supported by the cpu (see rvvjit_supported) */
+void *mac_16_32_32_jit_get(void)
+{
+	static void *kernel = NULL;
+
+	if (kernel == NULL && rvvjit_supported())
+		kernel = mac_16_32_32_jit_generate();
+
+	return kernel;
+}
@@ -25,7 +25,7 @@
  */
 
 /* using only widest element (e32) */
-void mac_16_32_32_rvv_e32(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len)
+void RVV_SYM(mac_16_32_32_rvv_e32)(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len)
 {
 	unsigned int vl;
 
@@ -59,7 +59,7 @@ void mac_16_32_32_rvv_e32(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsign
 
 
 /* using e16 and widen to e32 on MAC */
-void mac_16_32_32_rvv_e16_widening(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len)
+void RVV_SYM(mac_16_32_32_rvv_e16_widening)(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len)
 {
 	unsigned int vl;
 
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <core/rvv_helpers.h>
+
+
+#if RVVRADAR_RVV_INTRINSICS
+
+#include <riscv_vector.h>
+
+/*
+ * using e16 and widen to e32 on MAC (same as the inline asm kernel; see
+ * impl_rvv.c)
+ */
+void RVV_SYM(mac_16_32_32_rvv_intrinsics_e16_widening)(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len)
+{
+	while (len) {
+		/* 16bit elements in groups of 4 vregs -> 32bit in groups of 8 */
+		size_t vl = __riscv_vsetvl_e16m4(len);
+
+		vint32m8_t acc = __riscv_vle32_v_i32m8(add_res, vl);
+		vint16m4_t a = __riscv_vle16_v_i16m4(mul1, vl);
+		mul1 += vl;
+		vint16m4_t b = __riscv_vle16_v_i16m4(mul2, vl);
+		mul2 += vl;
+
+		/* acc = acc + (a * b) */
+		acc = __riscv_vwmacc_vv_i32m8(acc, a, b, vl);
+
+		__riscv_vse32_v_i32m8(add_res, acc, vl);
+		add_res += vl;
+
+		len -= vl;
+	}
+}
+
+#endif /* RVVRADAR_RVV_INTRINSICS */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+
+#if RVVRADAR_X86_SUPPORT
+
+#include <immintrin.h>
+
+/*
+ * Target attributes: see SYSINFO_ISA_* in core/sysinfo.h
+ * Tails are calculated by scalar code.
+ */
+
+static void mac_16_32_32_x86_tail(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len)
+{
+	for (unsigned int i = 0; i < len; i++)
+		add_res[i] = add_res[i] + (mul1[i] * mul2[i]);
+}
+
+
+/*
+ * 8 elements per loop
+ * 32bit products are assembled from low and high part of 16bit
+ * multiplications (no sign extension in sse2)
+ */
+__attribute__((target("sse2")))
+void mac_16_32_32_x86_sse2(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len)
+{
+	for (; len >= 8; len -= 8) {
+		__m128i a = _mm_loadu_si128((__m128i *)mul1);
+		__m128i b = _mm_loadu_si128((__m128i *)mul2);
+		__m128i lo = _mm_mullo_epi16(a, b);
+		__m128i hi = _mm_mulhi_epi16(a, b);
+
+		__m128i r0 = _mm_loadu_si128((__m128i *)add_res);
+		__m128i r1 = _mm_loadu_si128((__m128i *)(add_res + 4));
+		r0 = _mm_add_epi32(r0, _mm_unpacklo_epi16(lo, hi));
+		r1 = _mm_add_epi32(r1, _mm_unpackhi_epi16(lo, hi));
+		_mm_storeu_si128((__m128i *)add_res, r0);
+		_mm_storeu_si128((__m128i *)(add_res + 4), r1);
+
+		add_res += 8;
+		mul1 += 8;
+		mul2 += 8;
+	}
+
+	mac_16_32_32_x86_tail(add_res, mul1, mul2, len);
+}
+
+
+/* 8 elements per loop; sign extension to 32bit before multiplication */
+__attribute__((target("avx2")))
+void mac_16_32_32_x86_avx2(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len)
+{
+	for (; len >= 8; len -= 8) {
+		__m256i a = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i *)mul1));
+		__m256i b = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i *)mul2));
+		__m256i r = _mm256_loadu_si256((__m256i *)add_res);
+
+		r = _mm256_add_epi32(r, _mm256_mullo_epi32(a, b));
+		_mm256_storeu_si256((__m256i *)add_res, r);
+
+		add_res += 8;
+		mul1 += 8;
+		mul2 += 8;
+	}
+
+	mac_16_32_32_x86_tail(add_res, mul1, mul2, len);
+}
+
+
+/* 16 elements per loop; sign extension to 32bit before multiplication */
+__attribute__((target("avx512f")))
+void mac_16_32_32_x86_avx512(int32_t *add_res, int16_t *mul1, int16_t *mul2, unsigned int len)
+{
+	for (; len >= 16; len -= 16) {
+		__m512i a = _mm512_cvtepi16_epi32(_mm256_loadu_si256((__m256i *)mul1));
+		__m512i b = _mm512_cvtepi16_epi32(_mm256_loadu_si256((__m256i *)mul2));
+		__m512i r = _mm512_loadu_si512((void *)add_res);
+
+		r = _mm512_add_epi32(r, _mm512_mullo_epi32(a, b));
+		_mm512_storeu_si512((void *)add_res, r);
+
+		add_res += 16;
+		mul1 += 16;
+		mul2 += 16;
+	}
+
+	mac_16_32_32_x86_tail(add_res, mul1, mul2, len);
+}
+
+#endif /* RVVRADAR_X86_SUPPORT */
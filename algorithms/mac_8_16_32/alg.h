@@ -9,6 +9,9 @@
 
 #include <core/algset.h>
 
+/* descriptor (no parameters) */
+extern const alg_desc_t alg_mac_8_16_32_desc;
+
 int alg_mac_8_16_32_add(algset_t *algset, unsigned int len);
 
 #endif /* ALG_MAC_8_16_32_H */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+
+#include <core/sysinfo.h>
+#include <core/rvvjit.h>
+
+
+/*
+ * mac(a0: res, a1: add, a2: mul1, a3: mul2, a4: len)
+ *
+ * like rvv 8bit elements with double widening, but the element width is
+ * switched with vl preserving vsetvli (rs1 = rd = zero; same SEW/LMUL
+ * ratio) and the pointer increments are shifts of vl
+ *
+ * mul1 ..	[v0-v1](e8)
+ * mul2 ..	[v2-v3](e8)
+ * mul1 * mul2 ..	[v4-v7](e16)
+ * add ..	[v0-v3](e16)
+ * res ..	[v8-v15](e32)
+ * t0 .. vl; t1 .. vl * 2 (bytes of e16); t2 .. vl * 4 (bytes of e32)
+ */
+static void *mac_8_16_32_jit_generate(void)
+{
+	unsigned int loop, end;
+
+	rvvjit_t *jit = rvvjit_create();
+	if (jit == NULL)
+		return NULL;
+
+	end = rvvjit_branch_fwd(jit, RVVJIT_BEQ, RVVJIT_A4, RVVJIT_ZERO);
+	loop = rvvjit_label(jit);
+
+	rvvjit_vsetvli(jit, RVVJIT_T0, RVVJIT_A4, 8, 2);
+	rvvjit_vle(jit, 8, 0, RVVJIT_A2);
+	rvvjit_vle(jit, 8, 2, RVVJIT_A3);
+	rvvjit_vwmul_vv(jit, 4, 0, 2);
+	rvvjit_vsetvli(jit, RVVJIT_ZERO, RVVJIT_ZERO, 16, 4);
+	rvvjit_vle(jit, 16, 0, RVVJIT_A1);
+	rvvjit_vwadd_vv(jit, 8, 0, 4);
+	rvvjit_vsetvli(jit, RVVJIT_ZERO, RVVJIT_ZERO, 32, 8);
+	rvvjit_vse(jit, 32, 8, RVVJIT_A0);
+
+	rvvjit_slli(jit, RVVJIT_T1, RVVJIT_T0, 1);
+	rvvjit_slli(jit, RVVJIT_T2, RVVJIT_T0, 2);
+	rvvjit_add(jit, RVVJIT_A2, RVVJIT_A2, RVVJIT_T0);
+	rvvjit_add(jit, RVVJIT_A3, RVVJIT_A3, RVVJIT_T0);
+	rvvjit_add(jit, RVVJIT_A1, RVVJIT_A1, RVVJIT_T1);
+	rvvjit_add(jit, RVVJIT_A0, RVVJIT_A0, RVVJIT_T2);
+	rvvjit_sub(jit, RVVJIT_A4, RVVJIT_A4, RVVJIT_T0);
+	rvvjit_branch(jit, RVVJIT_BNE, RVVJIT_A4, RVVJIT_ZERO, loop);
+
+	rvvjit_resolve(jit, end);
+	rvvjit_ret(jit);
+
+	return rvvjit_finalize(jit);
+}
+
+
+/* generated once; NULL if not supported by the cpu (see rvvjit_supported) */
+void *mac_8_16_32_jit_get(void)
+{
+	static void *kernel = NULL;
+
+	if (kernel == NULL && rvvjit_supported())
+		kernel = mac_8_16_32_jit_generate();
+
+	return kernel;
+}
@@ -25,7 +25,7 @@
  */
 
 /* using only widest element (e32) */
-void mac_8_16_32_rvv_e32(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
+void RVV_SYM(mac_8_16_32_rvv_e32)(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
 {
 	unsigned int vl;
 
@@ -59,7 +59,7 @@ void mac_8_16_32_rvv_e32(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2,
 
 
 /* using e16 and widen to e32 on MAC */
-void mac_8_16_32_rvv_e16_widening(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
+void RVV_SYM(mac_8_16_32_rvv_e16_widening)(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
 {
 	unsigned int vl;
 
@@ -113,7 +113,7 @@ void mac_8_16_32_rvv_e16_widening(int32_t *res, int16_t *add, int8_t *mul1, int8
 
 
 /* using e8 and widen two times(MUL, ADD) to e32 */
-void mac_8_16_32_rvv_e8_widening(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
+void RVV_SYM(mac_8_16_32_rvv_e8_widening)(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
 {
 	unsigned int vl;
 
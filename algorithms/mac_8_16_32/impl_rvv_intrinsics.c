@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <core/rvv_helpers.h>
+
+
+#if RVVRADAR_RVV_INTRINSICS
+
+#include <riscv_vector.h>
+
+/*
+ * using e8 with double widening (same as the inline asm kernel; see
+ * impl_rvv.c)
+ */
+void RVV_SYM(mac_8_16_32_rvv_intrinsics_e8_widening)(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
+{
+	while (len) {
+		/* 8bit elements in groups of 2 vregs -> 32bit in groups of 8 */
+		size_t vl = __riscv_vsetvl_e8m2(len);
+
+		vint8m2_t a = __riscv_vle8_v_i8m2(mul1, vl);
+		mul1 += vl;
+		vint8m2_t b = __riscv_vle8_v_i8m2(mul2, vl);
+		mul2 += vl;
+		vint16m4_t c = __riscv_vle16_v_i16m4(add, vl);
+		add += vl;
+
+		/* r = c + (a * b) (product fits into 16bit) */
+		vint16m4_t prod = __riscv_vwmul_vv_i16m4(a, b, vl);
+		vint32m8_t r = __riscv_vwadd_vv_i32m8(c, prod, vl);
+
+		__riscv_vse32_v_i32m8(res, r, vl);
+		res += vl;
+
+		len -= vl;
+	}
+}
+
+#endif /* RVVRADAR_RVV_INTRINSICS */
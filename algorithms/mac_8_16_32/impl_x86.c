@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+
+#if RVVRADAR_X86_SUPPORT
+
+#include <immintrin.h>
+
+/*
+ * Target attributes: see SYSINFO_ISA_* in core/sysinfo.h
+ * Tails are calculated by scalar code.
+ * Products of 8bit values fit into 16bit -> multiplication in 16bit,
+ * widening to 32bit for the addition.
+ */
+
+static void mac_8_16_32_x86_tail(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
+{
+	for (unsigned int i = 0; i < len; i++)
+		res[i] = add[i] + (mul1[i] * mul2[i]);
+}
+
+
+/*
+ * 16 elements per loop
+ * sign extension by unpacking a value with itself and arithmetic shift
+ * (no sign extension in sse2)
+ */
+__attribute__((target("sse2")))
+void mac_8_16_32_x86_sse2(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
+{
+	for (; len >= 16; len -= 16) {
+		__m128i a = _mm_loadu_si128((__m128i *)mul1);
+		__m128i b = _mm_loadu_si128((__m128i *)mul2);
+
+		/* 8bit -> 16bit; multiply */
+		__m128i p0 = _mm_mullo_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8),
+					     _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8));
+		__m128i p1 = _mm_mullo_epi16(_mm_srai_epi16(_mm_unpackhi_epi8(a, a), 8),
+					     _mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8));
+
+		/* 16bit -> 32bit; add */
+		__m128i c0 = _mm_loadu_si128((__m128i *)add);
+		__m128i c1 = _mm_loadu_si128((__m128i *)(add + 8));
+		__m128i r0 = _mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(c0, c0), 16),
+					   _mm_srai_epi32(_mm_unpacklo_epi16(p0, p0), 16));
+		__m128i r1 = _mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(c0, c0), 16),
+					   _mm_srai_epi32(_mm_unpackhi_epi16(p0, p0), 16));
+		__m128i r2 = _mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(c1, c1), 16),
+					   _mm_srai_epi32(_mm_unpacklo_epi16(p1, p1), 16));
+		__m128i r3 = _mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(c1, c1), 16),
+					   _mm_srai_epi32(_mm_unpackhi_epi16(p1, p1), 16));
+
+		_mm_storeu_si128((__m128i *)res, r0);
+		_mm_storeu_si128((__m128i *)(res + 4), r1);
+		_mm_storeu_si128((__m128i *)(res + 8), r2);
+		_mm_storeu_si128((__m128i *)(res + 12), r3);
+
+		res += 16;
+		add += 16;
+		mul1 += 16;
+		mul2 += 16;
+	}
+
+	mac_8_16_32_x86_tail(res, add, mul1, mul2, len);
+}
+
+
+/* 16 elements per loop */
+__attribute__((target("avx2")))
+void mac_8_16_32_x86_avx2(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
+{
+	for (; len >= 16; len -= 16) {
+		__m256i a = _mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i *)mul1));
+		__m256i b = _mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i *)mul2));
+		__m256i p = _mm256_mullo_epi16(a, b);
+		__m256i c = _mm256_loadu_si256((__m256i *)add);
+
+		__m256i r0 = _mm256_add_epi32(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(c)),
+					      _mm256_cvtepi16_epi32(_mm256_castsi256_si128(p)));
+		__m256i r1 = _mm256_add_epi32(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(c, 1)),
+					      _mm256_cvtepi16_epi32(_mm256_extracti128_si256(p, 1)));
+
+		_mm256_storeu_si256((__m256i *)res, r0);
+		_mm256_storeu_si256((__m256i *)(res + 8), r1);
+
+		res += 16;
+		add += 16;
+		mul1 += 16;
+		mul2 += 16;
+	}
+
+	mac_8_16_32_x86_tail(res, add, mul1, mul2, len);
+}
+
+
+/* 32 elements per loop (16bit multiplication requires avx512bw) */
+__attribute__((target("avx512f,avx512bw")))
+void mac_8_16_32_x86_avx512(int32_t *res, int16_t *add, int8_t *mul1, int8_t *mul2, unsigned int len)
+{
+	for (; len >= 32; len -= 32) {
+		__m512i a = _mm512_cvtepi8_epi16(_mm256_loadu_si256((__m256i *)mul1));
+		__m512i b = _mm512_cvtepi8_epi16(_mm256_loadu_si256((__m256i *)mul2));
+		__m512i p = _mm512_mullo_epi16(a, b);
+		__m512i c = _mm512_loadu_si512((void *)add);
+
+		__m512i r0 = _mm512_add_epi32(_mm512_cvtepi16_epi32(_mm512_castsi512_si256(c)),
+					      _mm512_cvtepi16_epi32(_mm512_castsi512_si256(p)));
+		__m512i r1 = _mm512_add_epi32(_mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(c, 1)),
+					      _mm512_cvtepi16_epi32(_mm512_extracti64x4_epi64(p, 1)));
+
+		_mm512_storeu_si512((void *)res, r0);
+		_mm512_storeu_si512((void *)(res + 16), r1);
+
+		res += 32;
+		add += 32;
+		mul1 += 32;
+		mul2 += 32;
+	}
+
+	mac_8_16_32_x86_tail(res, add, mul1, mul2, len);
+}
+
+#endif /* RVVRADAR_X86_SUPPORT */
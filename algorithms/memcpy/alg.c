@@ -8,6 +8,7 @@
 #include <string.h>
 
 #include <core/rvv_helpers.h>
+#include <core/c_variants.h>
 #include "alg.h"
 
 
@@ -81,12 +82,19 @@ static int impl_postexec(impl_t *impl, bool verify)
 static int impl_add(
 	alg_t *alg,
 	const char *name,
+	const impl_req_t *req,
 	memcpy_fp_t memcpy)
 {
 	impl_t *impl;
 
+	/* kernel not built for the rvv draft of the cpu (see RVV_SELECT) or
+	 * not generated (jit not supported by the cpu; see rvvjit_supported) */
+	if (memcpy == NULL)
+		return 0;
+
 	impl = alg_add_impl(alg,
 			    name,
+			    req,
 			    NULL,
 			    impl_preexec,
 			    impl_exec_wrapper,
@@ -106,33 +114,79 @@ static int impl_add(
 
 extern void memcpy_c_byte_avect(char *dest, char *src, unsigned int len);
 extern void memcpy_c_byte_noavect(char *dest, char *src, unsigned int len);
+#define MEMCPY_C_MATRIX_DECLARE(_v_) extern void memcpy_c_byte_##_v_(char *dest, char *src, unsigned int len);
+C_MATRIX_FOREACH(MEMCPY_C_MATRIX_DECLARE)
+extern void memcpy_vext_128(void *dest, void *src, unsigned int len);
+extern void memcpy_vext_256(void *dest, void *src, unsigned int len);
+extern void memcpy_vext_512(void *dest, void *src, unsigned int len);
 #if RVVRADAR_RV_SUPPORT
 extern void memcpy_rv_wlenx4(void *dest, void *src, unsigned int len);
+/* four 32bit words per loop */
+static const impl_req_t req_rv_wlenx4 = { .isa = SYSINFO_ISA_RV, .len_multiple = 16, .align = 4 };
 #if RVVRADAR_RVV_SUPPORT
-extern void memcpy_rvv_32_m1(void *dest, void *src, unsigned int len);
-extern void memcpy_rvv_8_m1(void *dest, void *src, unsigned int len);
-extern void memcpy_rvv_8_m2(void *dest, void *src, unsigned int len);
-extern void memcpy_rvv_8_m4(void *dest, void *src, unsigned int len);
-extern void memcpy_rvv_8_m8(void *dest, void *src, unsigned int len);
+RVV_DECLARE(memcpy_rvv_32_m1, (void *dest, void *src, unsigned int len));
+RVV_DECLARE(memcpy_rvv_8_m1, (void *dest, void *src, unsigned int len));
+RVV_DECLARE(memcpy_rvv_8_m2, (void *dest, void *src, unsigned int len));
+RVV_DECLARE(memcpy_rvv_8_m4, (void *dest, void *src, unsigned int len));
+RVV_DECLARE(memcpy_rvv_8_m8, (void *dest, void *src, unsigned int len));
+RVV_DECLARE(memcpy_rvv_intrinsics_8_m1, (void *dest, void *src, unsigned int len));
+RVV_DECLARE(memcpy_rvv_intrinsics_8_m8, (void *dest, void *src, unsigned int len));
+/* kernels expanded from impl_rvv_gen.c.in (e<sew> elements) */
+#define MEMCPY_RVV_GEN_DECLARE(_sew_, _lmul_, _unroll_, _tail_) \
+	RVV_DECLARE(memcpy_rvv_gen_e##_sew_##_m##_lmul_##_u##_unroll_##_##_tail_, (void *dest, void *src, unsigned int len));
+RVV_GEN_FOREACH(memcpy_impl, MEMCPY_RVV_GEN_DECLARE)
+static const impl_req_t req_rvv_gen_e8 = { .isa = SYSINFO_ISA_RVV };
+static const impl_req_t req_rvv_gen_e16 = { .isa = SYSINFO_ISA_RVV, .len_multiple = 2, .align = 2 };
+static const impl_req_t req_rvv_gen_e32 = { .isa = SYSINFO_ISA_RVV, .len_multiple = 4, .align = 4 };
+/* e32 elements */
+static const impl_req_t req_rvv_e32 = { .isa = SYSINFO_ISA_RVV, .len_multiple = 4, .align = 4 };
+static const impl_req_t req_rvv = { .isa = SYSINFO_ISA_RVV };
+/* generated at runtime (see impl_jit.c) */
+extern void *memcpy_jit_get(void);
 #endif /* RVVRADAR_RVV_SUPPORT */
 #endif /* RVVRADAR_RV_SUPPORT */
+#if RVVRADAR_X86_SUPPORT
+extern void memcpy_x86_sse2(void *dest, void *src, unsigned int len);
+extern void memcpy_x86_avx2(void *dest, void *src, unsigned int len);
+extern void memcpy_x86_avx512(void *dest, void *src, unsigned int len);
+static const impl_req_t req_sse2 = { .isa = SYSINFO_ISA_SSE2 };
+static const impl_req_t req_avx2 = { .isa = SYSINFO_ISA_AVX2 };
+static const impl_req_t req_avx512 = { .isa = SYSINFO_ISA_AVX512 };
+#endif /* RVVRADAR_X86_SUPPORT */
 
 static int impls_add(alg_t *alg)
 {
 	int ret = 0;
 
-	ret |= impl_add(alg, "c byte noavect",	 			(memcpy_fp_t)memcpy_c_byte_noavect);
+	ret |= impl_add(alg, "c byte noavect",	 			NULL, (memcpy_fp_t)memcpy_c_byte_noavect);
 #if RVVRADAR_RV_SUPPORT
-	ret |= impl_add(alg, "4 int regs",	 			(memcpy_fp_t)memcpy_rv_wlenx4);
+	ret |= impl_add(alg, "4 int regs",	 			&req_rv_wlenx4, (memcpy_fp_t)memcpy_rv_wlenx4);
 #endif /* RVVRADAR_RV_SUPPORT */
-	ret |= impl_add(alg, "c byte avect",	 			(memcpy_fp_t)memcpy_c_byte_avect);
-	ret |= impl_add(alg, "system",		 			(memcpy_fp_t)memcpy);
+	ret |= impl_add(alg, "c byte avect",	 			NULL, (memcpy_fp_t)memcpy_c_byte_avect);
+#define MEMCPY_C_MATRIX_ADD(_v_) ret |= impl_add(alg, "c byte " #_v_, NULL, (memcpy_fp_t)memcpy_c_byte_##_v_);
+	C_MATRIX_FOREACH(MEMCPY_C_MATRIX_ADD)
+	ret |= impl_add(alg, "system",		 			NULL, (memcpy_fp_t)memcpy);
+	ret |= impl_add(alg, "vext 128bit",				NULL, (memcpy_fp_t)memcpy_vext_128);
+	ret |= impl_add(alg, "vext 256bit",				NULL, (memcpy_fp_t)memcpy_vext_256);
+	ret |= impl_add(alg, "vext 512bit",				NULL, (memcpy_fp_t)memcpy_vext_512);
+#if RVVRADAR_X86_SUPPORT
+	ret |= impl_add(alg, "x86 sse2",				&req_sse2, (memcpy_fp_t)memcpy_x86_sse2);
+	ret |= impl_add(alg, "x86 avx2",				&req_avx2, (memcpy_fp_t)memcpy_x86_avx2);
+	ret |= impl_add(alg, "x86 avx512",				&req_avx512, (memcpy_fp_t)memcpy_x86_avx512);
+#endif /* RVVRADAR_X86_SUPPORT */
 #if RVVRADAR_RVV_SUPPORT
-	ret |= impl_add(alg, "rvv 32bit elements (no grouping)",	(memcpy_fp_t)memcpy_rvv_32_m1);
-	ret |= impl_add(alg, "rvv 8bit elements (no grouping)",  	(memcpy_fp_t)memcpy_rvv_8_m1);
-	ret |= impl_add(alg, "rvv 8bit elements (group two)",  		(memcpy_fp_t)memcpy_rvv_8_m2);
-	ret |= impl_add(alg, "rvv 8bit elements (group four)",  	(memcpy_fp_t)memcpy_rvv_8_m4);
-	ret |= impl_add(alg, "rvv 8bit elements (group eight)",  	(memcpy_fp_t)memcpy_rvv_8_m8);
+	ret |= impl_add(alg, "rvv 32bit elements (no grouping)",	&req_rvv_e32, (memcpy_fp_t)RVV_SELECT(memcpy_rvv_32_m1));
+	ret |= impl_add(alg, "rvv 8bit elements (no grouping)",  	&req_rvv, (memcpy_fp_t)RVV_SELECT(memcpy_rvv_8_m1));
+	ret |= impl_add(alg, "rvv 8bit elements (group two)",  		&req_rvv, (memcpy_fp_t)RVV_SELECT(memcpy_rvv_8_m2));
+	ret |= impl_add(alg, "rvv 8bit elements (group four)",  	&req_rvv, (memcpy_fp_t)RVV_SELECT(memcpy_rvv_8_m4));
+	ret |= impl_add(alg, "rvv 8bit elements (group eight)",  	&req_rvv, (memcpy_fp_t)RVV_SELECT(memcpy_rvv_8_m8));
+	ret |= impl_add(alg, "rvv intrinsics 8bit elements (no grouping)",	&req_rvv, (memcpy_fp_t)RVV_SELECT(memcpy_rvv_intrinsics_8_m1));
+	ret |= impl_add(alg, "rvv intrinsics 8bit elements (group eight)",	&req_rvv, (memcpy_fp_t)RVV_SELECT(memcpy_rvv_intrinsics_8_m8));
+#define MEMCPY_RVV_GEN_ADD(_sew_, _lmul_, _unroll_, _tail_) \
+	ret |= impl_add(alg, "rvv gen e" #_sew_ " m" #_lmul_ " u" #_unroll_ " " #_tail_, &req_rvv_gen_e##_sew_, \
+			(memcpy_fp_t)RVV_SELECT(memcpy_rvv_gen_e##_sew_##_m##_lmul_##_u##_unroll_##_##_tail_));
+	RVV_GEN_FOREACH(memcpy_impl, MEMCPY_RVV_GEN_ADD)
+	ret |= impl_add(alg, "rvv jit",					&req_rvv, (memcpy_fp_t)memcpy_jit_get());
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 	if (ret)
@@ -147,14 +201,17 @@ static int alg_preexec(struct alg *alg, int seed)
 	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
 	int ret = 0;
 
+	/* len may be padded (see alg_add_impl) */
+	d->len = alg->len;
+
 	/* alloc */
-	d->src = malloc(d->len);
+	d->src = alg_alloc(alg, d->len);
 	if (d->src == NULL) {
 		ret = -1;
 		goto __err_src;
 	}
 
-	d->dest = malloc(d->len);
+	d->dest = alg_alloc(alg, d->len);
 	if (d->dest == NULL) {
 		ret = -1;
 		goto __err_dest;
@@ -188,14 +245,9 @@ static int alg_postexec(struct alg *alg)
 int alg_memcpy_add(algset_t *algset, unsigned int len)
 {
 	/*
-	 * fixup data len
-	 *
-	 * some implementations only allow muliples of x bytes
-	 * multiples of 4*64 bit will work for every test
-	 * -> ensure len is a multiple of 4*64 bits (= 32 bytes)
+	 * len is padded to the multiples required by the implementations
+	 * (see req_* above) when the algorithm is added to the set
 	 */
-	unsigned int multiple = 4 * 64 / 8;
-	len = ((len + multiple - 1) / multiple) * multiple;
 
 	/* build parameter string */
 	char parastr[256] = "\0";
@@ -205,6 +257,7 @@ int alg_memcpy_add(algset_t *algset, unsigned int len)
 	alg_t *alg = alg_create(
 			     "memcpy",
 			     parastr,
+			     len,
 			     alg_preexec,
 			     alg_postexec,
 			     sizeof(struct data));
@@ -229,3 +282,16 @@ int alg_memcpy_add(algset_t *algset, unsigned int len)
 
 	return 0;
 }
+
+
+static int alg_memcpy_desc_add(algset_t *algset, unsigned int len, const unsigned int *values)
+{
+	return alg_memcpy_add(algset, len);
+}
+
+
+const alg_desc_t alg_memcpy_desc = {
+	.name = "memcpy",
+	.description = "copy bytes",
+	.add = alg_memcpy_desc_add,
+};
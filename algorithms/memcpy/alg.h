@@ -9,6 +9,9 @@
 
 #include <core/algset.h>
 
+/* descriptor (no parameters) */
+extern const alg_desc_t alg_memcpy_desc;
+
 int alg_memcpy_add(algset_t *algset, unsigned int len);
 
 #endif /* ALG_MEMCPY_H */
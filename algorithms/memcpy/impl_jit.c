@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+
+#include <core/sysinfo.h>
+#include <core/rvvjit.h>
+
+
+/*
+ * memcpy(a0: dest, a1: src, a2: len) specialized to VLEN
+ *
+ * e8 elements in groups of eight registers; main loop with vl = VLMAX
+ * (no vsetvli per iteration) and as many groups per iteration (unroll) as
+ * needed to copy >= 256 bytes; tail stripmined with vsetvli.
+ *
+ * t0 .. VLMAX (bytes per group)
+ * t1 .. bytes per iteration of main loop
+ * t2 .. vl of tail
+ */
+static void *memcpy_jit_generate(unsigned int vlen)
+{
+	unsigned int lmul = 8;
+	unsigned int unroll = 256 / vlen;
+	unsigned int loop, tail, end;
+
+	if (unroll < 1)
+		unroll = 1;
+	if (unroll > 4)
+		unroll = 4;
+
+	rvvjit_t *jit = rvvjit_create();
+	if (jit == NULL)
+		return NULL;
+
+	rvvjit_vsetvli(jit, RVVJIT_T0, RVVJIT_ZERO, 8, lmul);
+	rvvjit_slli(jit, RVVJIT_T1, RVVJIT_T0, __builtin_ctz(unroll));
+	tail = rvvjit_branch_fwd(jit, RVVJIT_BLTU, RVVJIT_A2, RVVJIT_T1);
+
+	/* main loop */
+	loop = rvvjit_label(jit);
+	for (unsigned int i = 0; i < unroll; i++) {
+		rvvjit_vle(jit, 8, i * lmul, RVVJIT_A1);
+		rvvjit_add(jit, RVVJIT_A1, RVVJIT_A1, RVVJIT_T0);
+	}
+	for (unsigned int i = 0; i < unroll; i++) {
+		rvvjit_vse(jit, 8, i * lmul, RVVJIT_A0);
+		rvvjit_add(jit, RVVJIT_A0, RVVJIT_A0, RVVJIT_T0);
+	}
+	rvvjit_sub(jit, RVVJIT_A2, RVVJIT_A2, RVVJIT_T1);
+	rvvjit_branch(jit, RVVJIT_BGEU, RVVJIT_A2, RVVJIT_T1, loop);
+
+	/* tail */
+	rvvjit_resolve(jit, tail);
+	end = rvvjit_branch_fwd(jit, RVVJIT_BEQ, RVVJIT_A2, RVVJIT_ZERO);
+	loop = rvvjit_label(jit);
+	rvvjit_vsetvli(jit, RVVJIT_T2, RVVJIT_A2, 8, lmul);
+	rvvjit_vle(jit, 8, 0, RVVJIT_A1);
+	rvvjit_vse(jit, 8, 0, RVVJIT_A0);
+	rvvjit_add(jit, RVVJIT_A1, RVVJIT_A1, RVVJIT_T2);
+	rvvjit_add(jit, RVVJIT_A0, RVVJIT_A0, RVVJIT_T2);
+	rvvjit_sub(jit, RVVJIT_A2, RVVJIT_A2, RVVJIT_T2);
+	rvvjit_branch(jit, RVVJIT_BNE, RVVJIT_A2, RVVJIT_ZERO, loop);
+
+	rvvjit_resolve(jit, end);
+	rvvjit_ret(jit);
+
+	return rvvjit_finalize(jit);
+}
+
+
+/* generated once; NULL if not supported by the cpu (see rvvjit_supported) */
+void *memcpy_jit_get(void)
+{
+	static void *kernel = NULL;
+
+	if (kernel == NULL && rvvjit_supported())
+		kernel = memcpy_jit_generate(sysinfo_get_vlen());
+
+	return kernel;
+}
@@ -14,7 +14,7 @@
 /* use e32 elements; no grouping
  * (len must be a multiple of 4 bytes)
  */
-void memcpy_rvv_32_m1(uint8_t *dest, uint8_t *src, unsigned int len)
+void RVV_SYM(memcpy_rvv_32_m1)(uint8_t *dest, uint8_t *src, unsigned int len)
 {
 	unsigned int vl;
 	len >>= 2;
@@ -35,7 +35,7 @@ void memcpy_rvv_32_m1(uint8_t *dest, uint8_t *src, unsigned int len)
 }
 
 /* use e8 elements; no grouping */
-void memcpy_rvv_8_m1(uint8_t *dest, uint8_t *src, unsigned int len)
+void RVV_SYM(memcpy_rvv_8_m1)(uint8_t *dest, uint8_t *src, unsigned int len)
 {
 	unsigned int vl;
 
@@ -57,7 +57,7 @@ void memcpy_rvv_8_m1(uint8_t *dest, uint8_t *src, unsigned int len)
 
 
 /* use e8 elements; group two registers */
-void memcpy_rvv_8_m2(uint8_t *dest, uint8_t *src, unsigned int len)
+void RVV_SYM(memcpy_rvv_8_m2)(uint8_t *dest, uint8_t *src, unsigned int len)
 {
 	unsigned int vl;
 
@@ -79,7 +79,7 @@ void memcpy_rvv_8_m2(uint8_t *dest, uint8_t *src, unsigned int len)
 
 
 /* use e8 elements; group four registers */
-void memcpy_rvv_8_m4(uint8_t *dest, uint8_t *src, unsigned int len)
+void RVV_SYM(memcpy_rvv_8_m4)(uint8_t *dest, uint8_t *src, unsigned int len)
 {
 	unsigned int vl;
 
@@ -101,7 +101,7 @@ void memcpy_rvv_8_m4(uint8_t *dest, uint8_t *src, unsigned int len)
 
 
 /* use e8 elements; group eight registers */
-void memcpy_rvv_8_m8(uint8_t *dest, uint8_t *src, unsigned int len)
+void RVV_SYM(memcpy_rvv_8_m8)(uint8_t *dest, uint8_t *src, unsigned int len)
 {
 	unsigned int vl;
 
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <core/rvv_helpers.h>
+
+
+#if RVVRADAR_RVV_INTRINSICS
+
+#include <riscv_vector.h>
+
+/*
+ * same as the inline asm kernels (see impl_rvv.c), but register
+ * allocation and scheduling are left to the compiler
+ */
+
+/* use e8 elements; no grouping */
+void RVV_SYM(memcpy_rvv_intrinsics_8_m1)(uint8_t *dest, uint8_t *src, unsigned int len)
+{
+	while (len) {
+		size_t vl = __riscv_vsetvl_e8m1(len);
+
+		vuint8m1_t v = __riscv_vle8_v_u8m1(src, vl);
+		src += vl;
+
+		__riscv_vse8_v_u8m1(dest, v, vl);
+		dest += vl;
+
+		len -= vl;
+	}
+}
+
+
+/* use e8 elements; group eight registers */
+void RVV_SYM(memcpy_rvv_intrinsics_8_m8)(uint8_t *dest, uint8_t *src, unsigned int len)
+{
+	while (len) {
+		size_t vl = __riscv_vsetvl_e8m8(len);
+
+		vuint8m8_t v = __riscv_vle8_v_u8m8(src, vl);
+		src += vl;
+
+		__riscv_vse8_v_u8m8(dest, v, vl);
+		dest += vl;
+
+		len -= vl;
+	}
+}
+
+#endif /* RVVRADAR_RVV_INTRINSICS */
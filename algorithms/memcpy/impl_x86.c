@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+
+#if RVVRADAR_X86_SUPPORT
+
+#include <immintrin.h>
+
+/*
+ * Target attributes: see SYSINFO_ISA_* in core/sysinfo.h
+ * Unaligned loads/stores; tails are copied bytewise.
+ */
+
+/* 16 bytes per loop */
+__attribute__((target("sse2")))
+void memcpy_x86_sse2(uint8_t *dest, uint8_t *src, unsigned int len)
+{
+	uint8_t *dest_end = dest + len;
+
+	for (; len >= 16; len -= 16) {
+		_mm_storeu_si128((__m128i *)dest, _mm_loadu_si128((__m128i *)src));
+		src += 16;
+		dest += 16;
+	}
+
+	while (dest < dest_end)
+		*dest++ = *src++;
+}
+
+
+/* 32 bytes per loop */
+__attribute__((target("avx2")))
+void memcpy_x86_avx2(uint8_t *dest, uint8_t *src, unsigned int len)
+{
+	uint8_t *dest_end = dest + len;
+
+	for (; len >= 32; len -= 32) {
+		_mm256_storeu_si256((__m256i *)dest, _mm256_loadu_si256((__m256i *)src));
+		src += 32;
+		dest += 32;
+	}
+
+	while (dest < dest_end)
+		*dest++ = *src++;
+}
+
+
+/* 64 bytes per loop */
+__attribute__((target("avx512f")))
+void memcpy_x86_avx512(uint8_t *dest, uint8_t *src, unsigned int len)
+{
+	uint8_t *dest_end = dest + len;
+
+	for (; len >= 64; len -= 64) {
+		_mm512_storeu_si512((void *)dest, _mm512_loadu_si512((void *)src));
+		src += 64;
+		dest += 64;
+	}
+
+	while (dest < dest_end)
+		*dest++ = *src++;
+}
+
+#endif /* RVVRADAR_X86_SUPPORT */
@@ -10,6 +10,7 @@
 #include <errno.h>
 
 #include <core/rvv_helpers.h>
+#include <core/c_variants.h>
 #include "alg.h"
 
 
@@ -83,12 +84,19 @@ static int impl_postexec(impl_t *impl, bool verify)
 static int impl_add(
 	alg_t *alg,
 	const char *name,
+	const impl_req_t *req,
 	png_filters_fp_t png_filters)
 {
 	impl_t *impl;
 
+	/* kernel not built for the rvv draft of the cpu (see RVV_SELECT) or
+	 * not generated (jit not supported by the cpu; see rvvjit_supported) */
+	if (png_filters == NULL)
+		return 0;
+
 	impl = alg_add_impl(alg,
 			    name,
+			    req,
 			    NULL,
 			    impl_preexec,
 			    impl_exec_wrapper,
@@ -106,28 +114,115 @@ static int impl_add(
 
 
 
+#if RVVRADAR_RVV_SUPPORT
+/*
+ * requirements of rvv implementations
+ * at least one pixel per vector register -> VLEN >= bpp * 8
+ * (VLEN >= 32 of all drafts covers bpp <= 4; bpp=6/8 requires VLEN >=
+ * 64, which the V extension of riscv-v-spec-1.0 guarantees: VLEN >= 128)
+ */
+static impl_req_t req_rvv_get(alg_t *alg)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	impl_req_t req = {
+		.isa = SYSINFO_ISA_RVV,
+		.min_vlen = d->bpp * 8,
+	};
+	return req;
+}
+
+
+/* jit kernels of sub and avg are specialized to bpp (see *_impl_jit.c) */
+static unsigned int alg_bpp_get(alg_t *alg)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	return d->bpp;
+}
+#endif /* RVVRADAR_RVV_SUPPORT */
+
+#if RVVRADAR_X86_SUPPORT
+static const impl_req_t req_sse2 = { .isa = SYSINFO_ISA_SSE2 };
+static const impl_req_t req_ssse3 = { .isa = SYSINFO_ISA_SSSE3 };
+static const impl_req_t req_avx2 = { .isa = SYSINFO_ISA_AVX2 };
+static const impl_req_t req_avx512 = { .isa = SYSINFO_ISA_AVX512 };
+
+/* x86 implementations of sub, avg and paeth only handle bpp 3 and 4 */
+static bool x86_bpp_supported(alg_t *alg)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	return d->bpp == 3 || d->bpp == 4;
+}
+#endif /* RVVRADAR_X86_SUPPORT */
+
+/*
+ * vext implementations of sub, avg and paeth (GCC vector extension)
+ * Each pixel depends on its left neighbor -> one pixel per vector (8
+ * lanes, bpp <= 8); wider vectors do not help -> built once (unlike
+ * up_impl_vext.c.in). Pixels are assembled in a register from 4/2/1 byte
+ * accesses (memcpy of bpp bytes to/from the vector goes through the
+ * stack, which leads to store-forwarding stalls in the serially
+ * dependent loops).
+ */
+
+
 /* up implementations */
 
 extern void png_filters_up_c_byte_avect(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
 extern void png_filters_up_c_byte_noavect(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#define PNG_FILTERS_UP_C_MATRIX_DECLARE(_v_) extern void png_filters_up_c_byte_##_v_(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+C_MATRIX_FOREACH(PNG_FILTERS_UP_C_MATRIX_DECLARE)
+extern void png_filters_up_vext_128(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+extern void png_filters_up_vext_256(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+extern void png_filters_up_vext_512(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#if RVVRADAR_X86_SUPPORT
+extern void png_filters_up_x86_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+extern void png_filters_up_x86_avx2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+extern void png_filters_up_x86_avx512(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#endif /* RVVRADAR_X86_SUPPORT */
 #if RVVRADAR_RVV_SUPPORT
-extern void png_filters_up_rvv_m1(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
-extern void png_filters_up_rvv_m2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
-extern void png_filters_up_rvv_m4(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
-extern void png_filters_up_rvv_m8(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+RVV_DECLARE(png_filters_up_rvv_m1, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_DECLARE(png_filters_up_rvv_m2, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_DECLARE(png_filters_up_rvv_m4, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_DECLARE(png_filters_up_rvv_m8, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_DECLARE(png_filters_up_rvv_intrinsics_m8, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+/* kernels expanded from up_impl_rvv_gen.c.in */
+#define PNG_FILTERS_UP_RVV_GEN_DECLARE(_sew_, _lmul_, _unroll_, _tail_) \
+	RVV_DECLARE(png_filters_up_rvv_gen_e##_sew_##_m##_lmul_##_u##_unroll_##_##_tail_, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_GEN_FOREACH(png_filters_up_impl, PNG_FILTERS_UP_RVV_GEN_DECLARE)
+/* generated at runtime (see *_impl_jit.c) */
+extern void *png_filters_up_jit_get(void);
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 static int impls_add_up(alg_t *alg)
 {
 	int ret = 0;
+#if RVVRADAR_RVV_SUPPORT
+	const impl_req_t req_rvv = req_rvv_get(alg);
+#endif /* RVVRADAR_RVV_SUPPORT */
 
-	ret |= impl_add(alg, "c byte noavect",	(png_filters_fp_t)png_filters_up_c_byte_noavect);
-	ret |= impl_add(alg, "c byte avect",	(png_filters_fp_t)png_filters_up_c_byte_avect);
+	ret |= impl_add(alg, "c byte noavect",	NULL, (png_filters_fp_t)png_filters_up_c_byte_noavect);
+	ret |= impl_add(alg, "c byte avect",	NULL, (png_filters_fp_t)png_filters_up_c_byte_avect);
+#define PNG_FILTERS_UP_C_MATRIX_ADD(_v_) ret |= impl_add(alg, "c byte " #_v_, NULL, (png_filters_fp_t)png_filters_up_c_byte_##_v_);
+	C_MATRIX_FOREACH(PNG_FILTERS_UP_C_MATRIX_ADD)
+	ret |= impl_add(alg, "vext 128bit",	NULL, (png_filters_fp_t)png_filters_up_vext_128);
+	ret |= impl_add(alg, "vext 256bit",	NULL, (png_filters_fp_t)png_filters_up_vext_256);
+	ret |= impl_add(alg, "vext 512bit",	NULL, (png_filters_fp_t)png_filters_up_vext_512);
+#if RVVRADAR_X86_SUPPORT
+	ret |= impl_add(alg, "x86 sse2",	&req_sse2, (png_filters_fp_t)png_filters_up_x86_sse2);
+	ret |= impl_add(alg, "x86 avx2",	&req_avx2, (png_filters_fp_t)png_filters_up_x86_avx2);
+	ret |= impl_add(alg, "x86 avx512",	&req_avx512, (png_filters_fp_t)png_filters_up_x86_avx512);
+#endif /* RVVRADAR_X86_SUPPORT */
 #if RVVRADAR_RVV_SUPPORT
-	ret |= impl_add(alg, "rvv_m1",		(png_filters_fp_t)png_filters_up_rvv_m1);
-	ret |= impl_add(alg, "rvv_m2",		(png_filters_fp_t)png_filters_up_rvv_m2);
-	ret |= impl_add(alg, "rvv_m4",		(png_filters_fp_t)png_filters_up_rvv_m4);
-	ret |= impl_add(alg, "rvv_m8",		(png_filters_fp_t)png_filters_up_rvv_m8);
+	ret |= impl_add(alg, "rvv_m1",		&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_up_rvv_m1));
+	ret |= impl_add(alg, "rvv_m2",		&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_up_rvv_m2));
+	ret |= impl_add(alg, "rvv_m4",		&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_up_rvv_m4));
+	ret |= impl_add(alg, "rvv_m8",		&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_up_rvv_m8));
+	ret |= impl_add(alg, "rvv intrinsics m8",	&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_up_rvv_intrinsics_m8));
+#define PNG_FILTERS_UP_RVV_GEN_ADD(_sew_, _lmul_, _unroll_, _tail_) \
+	ret |= impl_add(alg, "rvv gen e" #_sew_ " m" #_lmul_ " u" #_unroll_ " " #_tail_, &req_rvv, \
+			(png_filters_fp_t)RVV_SELECT(png_filters_up_rvv_gen_e##_sew_##_m##_lmul_##_u##_unroll_##_##_tail_));
+	RVV_GEN_FOREACH(png_filters_up_impl, PNG_FILTERS_UP_RVV_GEN_ADD)
+	ret |= impl_add(alg, "rvv jit",		&req_rvv, (png_filters_fp_t)png_filters_up_jit_get());
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 	if (ret)
@@ -142,20 +237,41 @@ static int impls_add_up(alg_t *alg)
 
 extern void png_filters_sub_c_byte_avect(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
 extern void png_filters_sub_c_byte_noavect(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#define PNG_FILTERS_SUB_C_MATRIX_DECLARE(_v_) extern void png_filters_sub_c_byte_##_v_(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+C_MATRIX_FOREACH(PNG_FILTERS_SUB_C_MATRIX_DECLARE)
+extern void png_filters_sub_vext(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#if RVVRADAR_X86_SUPPORT
+extern void png_filters_sub_x86_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#endif /* RVVRADAR_X86_SUPPORT */
 #if RVVRADAR_RVV_SUPPORT
-extern void png_filters_sub_rvv_dload(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
-extern void png_filters_sub_rvv_reuse(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+RVV_DECLARE(png_filters_sub_rvv_dload, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_DECLARE(png_filters_sub_rvv_reuse, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_DECLARE(png_filters_sub_rvv_intrinsics_reuse, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+extern void *png_filters_sub_jit_get(unsigned int bpp);
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 static int impls_add_sub(alg_t *alg)
 {
 	int ret = 0;
+#if RVVRADAR_RVV_SUPPORT
+	const impl_req_t req_rvv = req_rvv_get(alg);
+#endif /* RVVRADAR_RVV_SUPPORT */
 
-	ret |= impl_add(alg, "c byte noavect",	(png_filters_fp_t)png_filters_sub_c_byte_noavect);
-	ret |= impl_add(alg, "c byte avect",	(png_filters_fp_t)png_filters_sub_c_byte_avect);
+	ret |= impl_add(alg, "c byte noavect",	NULL, (png_filters_fp_t)png_filters_sub_c_byte_noavect);
+	ret |= impl_add(alg, "c byte avect",	NULL, (png_filters_fp_t)png_filters_sub_c_byte_avect);
+#define PNG_FILTERS_SUB_C_MATRIX_ADD(_v_) ret |= impl_add(alg, "c byte " #_v_, NULL, (png_filters_fp_t)png_filters_sub_c_byte_##_v_);
+	C_MATRIX_FOREACH(PNG_FILTERS_SUB_C_MATRIX_ADD)
+	ret |= impl_add(alg, "vext",		NULL, (png_filters_fp_t)png_filters_sub_vext);
+#if RVVRADAR_X86_SUPPORT
+	if (x86_bpp_supported(alg)) {
+		ret |= impl_add(alg, "x86 sse2",	&req_sse2, (png_filters_fp_t)png_filters_sub_x86_sse2);
+	}
+#endif /* RVVRADAR_X86_SUPPORT */
 #if RVVRADAR_RVV_SUPPORT
-	ret |= impl_add(alg, "rvv_dload",	(png_filters_fp_t)png_filters_sub_rvv_dload);
-	ret |= impl_add(alg, "rvv_reuse",	(png_filters_fp_t)png_filters_sub_rvv_reuse);
+	ret |= impl_add(alg, "rvv_dload",	&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_sub_rvv_dload));
+	ret |= impl_add(alg, "rvv_reuse",	&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_sub_rvv_reuse));
+	ret |= impl_add(alg, "rvv intrinsics reuse",	&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_sub_rvv_intrinsics_reuse));
+	ret |= impl_add(alg, "rvv jit",		&req_rvv, (png_filters_fp_t)png_filters_sub_jit_get(alg_bpp_get(alg)));
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 	if (ret)
@@ -170,18 +286,39 @@ static int impls_add_sub(alg_t *alg)
 
 extern void png_filters_avg_c_byte_avect(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
 extern void png_filters_avg_c_byte_noavect(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#define PNG_FILTERS_AVG_C_MATRIX_DECLARE(_v_) extern void png_filters_avg_c_byte_##_v_(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+C_MATRIX_FOREACH(PNG_FILTERS_AVG_C_MATRIX_DECLARE)
+extern void png_filters_avg_vext(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#if RVVRADAR_X86_SUPPORT
+extern void png_filters_avg_x86_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#endif /* RVVRADAR_X86_SUPPORT */
 #if RVVRADAR_RVV_SUPPORT
-extern void png_filters_avg_rvv(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+RVV_DECLARE(png_filters_avg_rvv, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_DECLARE(png_filters_avg_rvv_intrinsics, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+extern void *png_filters_avg_jit_get(unsigned int bpp);
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 static int impls_add_avg(alg_t *alg)
 {
 	int ret = 0;
+#if RVVRADAR_RVV_SUPPORT
+	const impl_req_t req_rvv = req_rvv_get(alg);
+#endif /* RVVRADAR_RVV_SUPPORT */
 
-	ret |= impl_add(alg, "c byte noavect",	(png_filters_fp_t)png_filters_avg_c_byte_noavect);
-	ret |= impl_add(alg, "c byte avect",	(png_filters_fp_t)png_filters_avg_c_byte_avect);
+	ret |= impl_add(alg, "c byte noavect",	NULL, (png_filters_fp_t)png_filters_avg_c_byte_noavect);
+	ret |= impl_add(alg, "c byte avect",	NULL, (png_filters_fp_t)png_filters_avg_c_byte_avect);
+#define PNG_FILTERS_AVG_C_MATRIX_ADD(_v_) ret |= impl_add(alg, "c byte " #_v_, NULL, (png_filters_fp_t)png_filters_avg_c_byte_##_v_);
+	C_MATRIX_FOREACH(PNG_FILTERS_AVG_C_MATRIX_ADD)
+	ret |= impl_add(alg, "vext",		NULL, (png_filters_fp_t)png_filters_avg_vext);
+#if RVVRADAR_X86_SUPPORT
+	if (x86_bpp_supported(alg)) {
+		ret |= impl_add(alg, "x86 sse2",	&req_sse2, (png_filters_fp_t)png_filters_avg_x86_sse2);
+	}
+#endif /* RVVRADAR_X86_SUPPORT */
 #if RVVRADAR_RVV_SUPPORT
-	ret |= impl_add(alg, "rvv",		(png_filters_fp_t)png_filters_avg_rvv);
+	ret |= impl_add(alg, "rvv",		&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_avg_rvv));
+	ret |= impl_add(alg, "rvv intrinsics",	&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_avg_rvv_intrinsics));
+	ret |= impl_add(alg, "rvv jit",		&req_rvv, (png_filters_fp_t)png_filters_avg_jit_get(alg_bpp_get(alg)));
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 	if (ret)
@@ -196,20 +333,41 @@ static int impls_add_avg(alg_t *alg)
 
 extern void png_filters_paeth_c_byte_avect(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
 extern void png_filters_paeth_c_byte_noavect(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#define PNG_FILTERS_PAETH_C_MATRIX_DECLARE(_v_) extern void png_filters_paeth_c_byte_##_v_(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+C_MATRIX_FOREACH(PNG_FILTERS_PAETH_C_MATRIX_DECLARE)
+extern void png_filters_paeth_vext(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#if RVVRADAR_X86_SUPPORT
+extern void png_filters_paeth_x86_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+extern void png_filters_paeth_x86_ssse3(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+#endif /* RVVRADAR_X86_SUPPORT */
 #if RVVRADAR_RVV_SUPPORT
-extern void png_filters_paeth_rvv_bulk_load(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
-extern void png_filters_paeth_rvv(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row);
+RVV_DECLARE(png_filters_paeth_rvv_bulk_load, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_DECLARE(png_filters_paeth_rvv, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
+RVV_DECLARE(png_filters_paeth_rvv_intrinsics, (unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row));
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 static int impls_add_paeth(alg_t *alg)
 {
 	int ret = 0;
+#if RVVRADAR_RVV_SUPPORT
+	const impl_req_t req_rvv = req_rvv_get(alg);
+#endif /* RVVRADAR_RVV_SUPPORT */
 
-	ret |= impl_add(alg, "c byte noavect",	(png_filters_fp_t)png_filters_paeth_c_byte_noavect);
-	ret |= impl_add(alg, "c byte avect",	(png_filters_fp_t)png_filters_paeth_c_byte_avect);
+	ret |= impl_add(alg, "c byte noavect",	NULL, (png_filters_fp_t)png_filters_paeth_c_byte_noavect);
+	ret |= impl_add(alg, "c byte avect",	NULL, (png_filters_fp_t)png_filters_paeth_c_byte_avect);
+#define PNG_FILTERS_PAETH_C_MATRIX_ADD(_v_) ret |= impl_add(alg, "c byte " #_v_, NULL, (png_filters_fp_t)png_filters_paeth_c_byte_##_v_);
+	C_MATRIX_FOREACH(PNG_FILTERS_PAETH_C_MATRIX_ADD)
+	ret |= impl_add(alg, "vext",		NULL, (png_filters_fp_t)png_filters_paeth_vext);
+#if RVVRADAR_X86_SUPPORT
+	if (x86_bpp_supported(alg)) {
+		ret |= impl_add(alg, "x86 sse2",	&req_sse2, (png_filters_fp_t)png_filters_paeth_x86_sse2);
+		ret |= impl_add(alg, "x86 ssse3",	&req_ssse3, (png_filters_fp_t)png_filters_paeth_x86_ssse3);
+	}
+#endif /* RVVRADAR_X86_SUPPORT */
 #if RVVRADAR_RVV_SUPPORT
-	ret |= impl_add(alg, "rvv bulk load",	(png_filters_fp_t)png_filters_paeth_rvv_bulk_load);
-	ret |= impl_add(alg, "rvv",		(png_filters_fp_t)png_filters_paeth_rvv);
+	ret |= impl_add(alg, "rvv bulk load",	&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_paeth_rvv_bulk_load));
+	ret |= impl_add(alg, "rvv",		&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_paeth_rvv));
+	ret |= impl_add(alg, "rvv intrinsics",	&req_rvv, (png_filters_fp_t)RVV_SELECT(png_filters_paeth_rvv_intrinsics));
 #endif /* RVVRADAR_RVV_SUPPORT */
 
 	if (ret)
@@ -224,17 +382,20 @@ static int alg_preexec(struct alg *alg, int seed)
 {
 	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
 
+	/* len may be padded (see alg_create) */
+	d->rowbytes = alg->len * d->bpp;
+
 	/* alloc */
-	d->prev_row = malloc(d->rowbytes);
+	d->prev_row = alg_alloc(alg, d->rowbytes);
 	if (d->prev_row == NULL)
 		goto __err_alloc_prev_row;
-	d->row_orig = malloc(d->rowbytes);
+	d->row_orig = alg_alloc(alg, d->rowbytes);
 	if (d->row_orig == NULL)
 		goto __err_alloc_row_orig;
-	d->row = malloc(d->rowbytes);
+	d->row = alg_alloc(alg, d->rowbytes);
 	if (d->row == NULL)
 		goto __err_alloc_row;
-	d->row_compare = malloc(d->rowbytes);
+	d->row_compare = alg_alloc(alg, d->rowbytes);
 	if (d->row_compare == NULL)
 		goto __err_alloc_row_compare;
 
@@ -292,58 +453,81 @@ static int alg_postexec(struct alg *alg)
 }
 
 
+/* parameters */
+
+static const char * const filter_names[] = { "up", "sub", "avg", "paeth", NULL };
+static const unsigned int filter_defaults[] = { up, sub, avg, paeth };
+
+/*
+ * bpp of png color types with 8 and 16 bit depth
+ * (gray, gray+alpha, rgb, rgba)
+ */
+static const unsigned int bpp_allowed[] = { 1, 2, 3, 4, 6, 8 };
+static const unsigned int bpp_defaults[] = { 3, 4 };
+
+static const param_desc_t params[] = {
+	{
+		.name = "filter",
+		.type = PARAM_TYPE_ENUM,
+		.enum_names = filter_names,
+		.defaults = PARAM_VALUES(filter_defaults),
+	},
+	{
+		.name = "bpp",
+		.type = PARAM_TYPE_UINT,
+		.allowed = PARAM_VALUES(bpp_allowed),
+		.defaults = PARAM_VALUES(bpp_defaults),
+	},
+};
+
+
 int alg_png_filters_add(
 	algset_t *algset,
 	enum alg_png_filters_filter filter,
-	enum alg_png_filters_bpp bpp,
+	unsigned int bpp,
 	unsigned int len)
 {
 	int ret = 0;
-	unsigned int bppval;
 
-	/* parse parameter bpp */
-	switch (bpp) {
-	case bpp3:
-		bppval = 3;
-		break;
-	case bpp4:
-		bppval = 4;
-		break;
-	default:
+	/* check parameters */
+	if (filter > paeth) {
 		errno = EINVAL;
 		return -1;
 	}
-
-	/* parse parameter filter and build name string */
-	char namestr[256] = "\0";
-	switch (filter) {
-	case up:
-		sprintf(namestr, "png_filters_up%i", bppval);
-		break;
-	case sub:
-		sprintf(namestr, "png_filters_sub%i", bppval);
-		break;
-	case avg:
-		sprintf(namestr, "png_filters_avg%i", bppval);
-		break;
-	case paeth:
-		sprintf(namestr, "png_filters_paeth%i", bppval);
-		break;
-	default:
+	int i;
+	for (i = 0; i < sizeof(bpp_allowed) / sizeof(bpp_allowed[0]); i++)
+		if (bpp_allowed[i] == bpp)
+			break;
+	if (i == sizeof(bpp_allowed) / sizeof(bpp_allowed[0])) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	unsigned int rowbytes = len * bppval;
+	/* build name string */
+	char namestr[256] = "\0";
+	snprintf(namestr, 256, "png_filters_%s%u", filter_names[filter], bpp);
+
+	/*
+	 * rowbytes of the parameter string (see alg_preexec)
+	 * png implementations do not pad len (no len_multiple) -> len is
+	 * final; implementations padding len have to pad it here as well to
+	 * keep the parameter string consistent (see stream)
+	 */
+	unsigned int rowbytes = len * bpp;
 
 	/* build parameter string */
 	char parastr[256] = "\0";
-	snprintf(parastr, 256, "len=%u,rowbytes=%u", len, rowbytes);
+	unsigned int values[] = { filter, bpp };
+	int pos = alg_desc_parastr(&alg_png_filters_desc, len, values, parastr, 256);
+	if (pos < 0)
+		return -1;
+	snprintf(parastr + pos, pos < 256 ? 256 - pos : 0, ",rowbytes=%u", rowbytes);
 
 	/* create algorithm */
 	alg_t *alg = alg_create(
 			     namestr,
 			     parastr,
+			     len,
 			     alg_preexec,
 			     alg_postexec,
 			     sizeof(struct data));
@@ -353,8 +537,10 @@ int alg_png_filters_add(
 	/* set private data */
 	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
 	d->filter = filter;
-	d->bpp = bppval;
-	d->rowbytes = rowbytes;
+	d->bpp = bpp;
+
+	/* row is filtered in place */
+	alg->inplace = true;
 
 	/* add implementations according to parameter filter */
 	switch (filter) {
@@ -387,3 +573,18 @@ int alg_png_filters_add(
 
 	return 0;
 }
+
+
+static int alg_png_filters_desc_add(algset_t *algset, unsigned int len, const unsigned int *values)
+{
+	return alg_png_filters_add(algset, values[0], values[1], len);
+}
+
+
+const alg_desc_t alg_png_filters_desc = {
+	.name = "png_filters",
+	.description = "png (de)filters on a row",
+	.params = params,
+	.nparams = sizeof(params) / sizeof(params[0]),
+	.add = alg_png_filters_desc_add,
+};
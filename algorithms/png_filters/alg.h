@@ -15,19 +15,23 @@ enum alg_png_filters_filter {
 	avg,
 	paeth
 };
-enum alg_png_filters_bpp {bpp3, bpp4};
+
+/*
+ * descriptor (parameters: filter, bpp)
+ */
+extern const alg_desc_t alg_png_filters_desc;
 
 /*
  * add a png filter algorithm
  * algset .. set to add to
  * filter .. which algorithm to add (see above)
- * bpp .. number of bytes/colorchannels per pixel (see above)
- * len .. number of pixels to process
+ * bpp .. number of bytes/colorchannels per pixel (1, 2, 3, 4, 6 or 8)
+ * len .. number of pixels to process (row width)
  */
 int alg_png_filters_add(
 	algset_t *algset,
 	enum alg_png_filters_filter filter,
-	enum alg_png_filters_bpp bpp,
+	unsigned int bpp,
 	unsigned int len);
 
 #endif /* ALG_PNG_FILTERS_H */
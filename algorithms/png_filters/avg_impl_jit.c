@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+
+#include <core/sysinfo.h>
+#include <core/rvvjit.h>
+
+
+/* pixels per iteration of main loop */
+#define UNROLL	4
+
+
+/* one pixel: a = x + (a + b) / 2 */
+static void avg_pixel(rvvjit_t *jit, unsigned int bpp)
+{
+	/* b = *prev_row */
+	rvvjit_vle(jit, 8, 4, RVVJIT_A3);
+	rvvjit_addi(jit, RVVJIT_A3, RVVJIT_A3, bpp);
+	/* x = *row */
+	rvvjit_vle(jit, 8, 8, RVVJIT_A2);
+	/* tmp = a + b (widening) */
+	rvvjit_vwaddu_vv(jit, 12, 2, 4);
+	/* a = tmp / 2 (narrowing) */
+	rvvjit_vnsrl_wi(jit, 2, 12, 1);
+	/* a += x */
+	rvvjit_vadd_vv(jit, 2, 2, 8);
+	/* *row = a */
+	rvvjit_vse(jit, 8, 2, RVVJIT_A2);
+	rvvjit_addi(jit, RVVJIT_A2, RVVJIT_A2, bpp);
+}
+
+
+/*
+ * avg(a0: bpp, a1: rowbytes, a2: row, a3: prev_row) specialized to bpp
+ *
+ * row:      | a | x |
+ * prev_row: |   | b |
+ *
+ * vl = bpp is an immediate (vsetivli; set once) and the pointer
+ * increments are constants; UNROLL pixels per iteration.
+ *
+ * a .. 	[v2](e8)
+ * b ..		[v4](e8)
+ * x ..		[v8](e8)
+ * tmp .. 	[v12-v13](e16)
+ * t5 .. end of row; t6 .. last start of main loop iteration
+ */
+static void *png_filters_avg_jit_generate(unsigned int bpp)
+{
+	unsigned int loop, tail, end;
+
+	rvvjit_t *jit = rvvjit_create();
+	if (jit == NULL)
+		return NULL;
+
+	rvvjit_vsetivli(jit, RVVJIT_ZERO, bpp, 8, 1);
+	rvvjit_add(jit, RVVJIT_T5, RVVJIT_A2, RVVJIT_A1);
+
+	/* first pixel: a = x + b / 2 */
+	rvvjit_vle(jit, 8, 4, RVVJIT_A3);
+	rvvjit_addi(jit, RVVJIT_A3, RVVJIT_A3, bpp);
+	rvvjit_vle(jit, 8, 8, RVVJIT_A2);
+	rvvjit_vsrl_vi(jit, 4, 4, 1);
+	rvvjit_vadd_vv(jit, 2, 4, 8);
+	rvvjit_vse(jit, 8, 2, RVVJIT_A2);
+	rvvjit_addi(jit, RVVJIT_A2, RVVJIT_A2, bpp);
+
+	/* main loop */
+	rvvjit_addi(jit, RVVJIT_T6, RVVJIT_T5, -(int)(UNROLL * bpp));
+	tail = rvvjit_branch_fwd(jit, RVVJIT_BLTU, RVVJIT_T6, RVVJIT_A2);
+	loop = rvvjit_label(jit);
+	for (unsigned int i = 0; i < UNROLL; i++)
+		avg_pixel(jit, bpp);
+	rvvjit_branch(jit, RVVJIT_BGEU, RVVJIT_T6, RVVJIT_A2, loop);
+
+	/* remaining pixels */
+	rvvjit_resolve(jit, tail);
+	end = rvvjit_branch_fwd(jit, RVVJIT_BGEU, RVVJIT_A2, RVVJIT_T5);
+	loop = rvvjit_label(jit);
+	avg_pixel(jit, bpp);
+	rvvjit_branch(jit, RVVJIT_BLTU, RVVJIT_A2, RVVJIT_T5, loop);
+
+	rvvjit_resolve(jit, end);
+	rvvjit_ret(jit);
+
+	return rvvjit_finalize(jit);
+}
+
+
+/*
+ * generated once per bpp; NULL if not supported by the cpu (see
+ * rvvjit_supported) or bpp > 8
+ */
+void *png_filters_avg_jit_get(unsigned int bpp)
+{
+	static void *kernels[9] = { NULL };
+
+	if (bpp < 1 || bpp > 8)
+		return NULL;
+
+	if (kernels[bpp] == NULL && rvvjit_supported())
+		kernels[bpp] = png_filters_avg_jit_generate(bpp);
+
+	return kernels[bpp];
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <core/rvv_helpers.h>
+
+
+#if RVVRADAR_RVV_INTRINSICS
+
+#include <riscv_vector.h>
+
+/*
+ * one pixel per vector (e8/m1); result of the previous pixel is reused
+ * (same as png_filters_avg_rvv, but scheduled by the compiler)
+ */
+void RVV_SYM(png_filters_avg_rvv_intrinsics)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	uint8_t *rp_end = row + rowbytes;
+	size_t vl = __riscv_vsetvl_e8m1(bpp);
+
+	/*
+	 * row:      | a | x |
+	 * prev_row: |   | b |
+	 */
+
+	/* first pixel: a = x + b / 2 */
+	vuint8m1_t x = __riscv_vle8_v_u8m1(row, vl);
+	vuint8m1_t b = __riscv_vle8_v_u8m1(prev_row, vl);
+	prev_row += bpp;
+	vuint8m1_t a = __riscv_vadd_vv_u8m1(x, __riscv_vsrl_vx_u8m1(b, 1, vl), vl);
+	__riscv_vse8_v_u8m1(row, a, vl);
+	row += bpp;
+
+	/* remaining pixels: a = x + (a + b) / 2 (sum widened to 16bit) */
+	while (row < rp_end) {
+		x = __riscv_vle8_v_u8m1(row, vl);
+		b = __riscv_vle8_v_u8m1(prev_row, vl);
+		prev_row += bpp;
+
+		vuint16m2_t sum = __riscv_vwaddu_vv_u16m2(a, b, vl);
+		a = __riscv_vadd_vv_u8m1(x, __riscv_vnsrl_wx_u8m1(sum, 1, vl), vl);
+
+		__riscv_vse8_v_u8m1(row, a, vl);
+		row += bpp;
+	}
+}
+
+#endif /* RVVRADAR_RVV_INTRINSICS */
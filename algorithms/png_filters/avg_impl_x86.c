@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#if RVVRADAR_X86_SUPPORT
+
+#include <immintrin.h>
+
+/*
+ * Each pixel depends on its left neighbor -> one pixel per vector (wider
+ * vectors do not help); only bpp 3 and 4 (see alg.c)
+ * Target attributes: see SYSINFO_ISA_* in core/sysinfo.h
+ */
+
+/*
+ * load/store a single pixel of bpp 3 or 4 from/to the lowest 32bit of a
+ * vector register
+ */
+__attribute__((target("sse2"), always_inline))
+static inline __m128i load_pixel(const uint8_t *p, unsigned int bpp)
+{
+	uint32_t v;
+
+	/* assembled in a register (no store forwarding stall) */
+	if (bpp == 3) {
+		uint16_t lo;
+		memcpy(&lo, p, 2);
+		v = lo | (uint32_t)p[2] << 16;
+	} else
+		memcpy(&v, p, 4);
+
+	return _mm_cvtsi32_si128(v);
+}
+
+
+__attribute__((target("sse2"), always_inline))
+static inline void store_pixel(uint8_t *p, __m128i v, unsigned int bpp)
+{
+	uint32_t x = _mm_cvtsi128_si32(v);
+
+	if (bpp == 3) {
+		uint16_t lo = x;
+		memcpy(p, &lo, 2);
+		p[2] = x >> 16;
+	} else
+		memcpy(p, &x, 4);
+}
+
+
+/*
+ * a = x + (a + b) / 2 (a = 0 for the first pixel)
+ * pavgb rounds up -> subtract the lost lowest bit ((a ^ b) & 1)
+ */
+__attribute__((target("sse2"), always_inline))
+static inline void avg_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	uint8_t *rp_end = row + rowbytes;
+	const __m128i one = _mm_set1_epi8(1);
+	__m128i a = _mm_setzero_si128();
+
+	while (row < rp_end) {
+		__m128i b = load_pixel(prev_row, bpp);
+		__m128i avg = _mm_avg_epu8(a, b);
+		avg = _mm_sub_epi8(avg, _mm_and_si128(_mm_xor_si128(a, b), one));
+
+		a = _mm_add_epi8(load_pixel(row, bpp), avg);
+		store_pixel(row, a, bpp);
+
+		row += bpp;
+		prev_row += bpp;
+	}
+}
+
+
+/* constant bpp -> specialized loops */
+__attribute__((target("sse2")))
+void png_filters_avg_x86_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	if (bpp == 3)
+		avg_sse2(3, rowbytes, row, prev_row);
+	else
+		avg_sse2(4, rowbytes, row, prev_row);
+}
+
+#endif /* RVVRADAR_X86_SUPPORT */
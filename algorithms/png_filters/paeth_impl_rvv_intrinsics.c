@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <core/rvv_helpers.h>
+
+
+#if RVVRADAR_RVV_INTRINSICS
+
+#include <riscv_vector.h>
+
+/* zero extend e8 to e16 and reinterpret as signed */
+static inline vint16m2_t widen(vuint8m1_t v, size_t vl)
+{
+	return __riscv_vreinterpret_v_u16m2_i16m2(__riscv_vzext_vf2_u16m2(v, vl));
+}
+
+
+static inline vint16m2_t abs16(vint16m2_t v, size_t vl)
+{
+	return __riscv_vmax_vv_i16m2(v, __riscv_vneg_v_i16m2(v, vl), vl);
+}
+
+
+/*
+ * one pixel per vector (e8/m1; predictor calculated in e16/m2)
+ * (same as png_filters_paeth_rvv, but scheduled by the compiler)
+ */
+void RVV_SYM(png_filters_paeth_rvv_intrinsics)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	uint8_t *rp_end = row + rowbytes;
+	size_t vl = __riscv_vsetvl_e8m1(bpp);
+
+	/*
+	 * row:      | a | x |
+	 * prev_row: | c | b |
+	 */
+
+	/* first pixel: a = x + b */
+	vuint8m1_t x = __riscv_vle8_v_u8m1(row, vl);
+	vuint8m1_t c = __riscv_vle8_v_u8m1(prev_row, vl);
+	prev_row += bpp;
+	vuint8m1_t a = __riscv_vadd_vv_u8m1(x, c, vl);
+	__riscv_vse8_v_u8m1(row, a, vl);
+	row += bpp;
+
+	/* remaining pixels */
+	while (row < rp_end) {
+		vuint8m1_t b = __riscv_vle8_v_u8m1(prev_row, vl);
+		prev_row += bpp;
+		x = __riscv_vle8_v_u8m1(row, vl);
+
+		/* p = b - c; pc = a - c */
+		vint16m2_t c16 = widen(c, vl);
+		vint16m2_t p = __riscv_vsub_vv_i16m2(widen(b, vl), c16, vl);
+		vint16m2_t pc = __riscv_vsub_vv_i16m2(widen(a, vl), c16, vl);
+
+		/* pa = abs(p); pb = abs(pc); pc = abs(p + pc) */
+		vint16m2_t pa = abs16(p, vl);
+		vint16m2_t pb = abs16(pc, vl);
+		pc = abs16(__riscv_vadd_vv_i16m2(p, pc, vl), vl);
+
+		/* if (pb < pa) { pa = pb; a = b; } */
+		vbool8_t mask = __riscv_vmslt_vv_i16m2_b8(pb, pa, vl);
+		pa = __riscv_vmerge_vvm_i16m2(pa, pb, mask, vl);
+		a = __riscv_vmerge_vvm_u8m1(a, b, mask, vl);
+
+		/* if (pc < pa) a = c; */
+		mask = __riscv_vmslt_vv_i16m2_b8(pc, pa, vl);
+		a = __riscv_vmerge_vvm_u8m1(a, c, mask, vl);
+
+		/* *row = a + x */
+		a = __riscv_vadd_vv_u8m1(a, x, vl);
+		__riscv_vse8_v_u8m1(row, a, vl);
+		row += bpp;
+
+		c = b;
+	}
+}
+
+#endif /* RVVRADAR_RVV_INTRINSICS */
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#if RVVRADAR_X86_SUPPORT
+
+#include <immintrin.h>
+
+/*
+ * Each pixel depends on its left neighbor -> one pixel per vector (wider
+ * vectors do not help); only bpp 3 and 4 (see alg.c)
+ * Predictor is calculated in 16bit lanes. The sse2 and ssse3
+ * implementations only differ in abs (emulated vs. pabsw).
+ * Target attributes: see SYSINFO_ISA_* in core/sysinfo.h
+ */
+
+/*
+ * load/store a single pixel of bpp 3 or 4 from/to the lowest 32bit of a
+ * vector register
+ */
+__attribute__((target("sse2"), always_inline))
+static inline __m128i load_pixel(const uint8_t *p, unsigned int bpp)
+{
+	uint32_t v;
+
+	/* assembled in a register (no store forwarding stall) */
+	if (bpp == 3) {
+		uint16_t lo;
+		memcpy(&lo, p, 2);
+		v = lo | (uint32_t)p[2] << 16;
+	} else
+		memcpy(&v, p, 4);
+
+	return _mm_cvtsi32_si128(v);
+}
+
+
+__attribute__((target("sse2"), always_inline))
+static inline void store_pixel(uint8_t *p, __m128i v, unsigned int bpp)
+{
+	uint32_t x = _mm_cvtsi128_si32(v);
+
+	if (bpp == 3) {
+		uint16_t lo = x;
+		memcpy(p, &lo, 2);
+		p[2] = x >> 16;
+	} else
+		memcpy(p, &x, 4);
+}
+
+
+__attribute__((target("sse2"), always_inline))
+static inline __m128i if_then_else(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+
+__attribute__((target("sse2"), always_inline))
+static inline __m128i abs_sse2(__m128i v)
+{
+	return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+}
+
+
+__attribute__((target("ssse3"), always_inline))
+static inline __m128i abs_ssse3(__m128i v)
+{
+	return _mm_abs_epi16(v);
+}
+
+
+/*
+ * row:      | a | x |
+ * prev_row: | c | b |
+ *
+ * a = c = 0 for the first pixel -> predictor is b
+ */
+#define PAETH_LOOP(_abs_)								\
+	do {										\
+		uint8_t *rp_end = row + rowbytes;					\
+		const __m128i zero = _mm_setzero_si128();				\
+		__m128i a = zero;							\
+		__m128i c = zero;							\
+											\
+		while (row < rp_end) {							\
+			__m128i b = _mm_unpacklo_epi8(load_pixel(prev_row, bpp), zero);	\
+			__m128i pa = _mm_sub_epi16(b, c);				\
+			__m128i pb = _mm_sub_epi16(a, c);				\
+			__m128i pc = _mm_add_epi16(pa, pb);				\
+											\
+			pa = _abs_(pa);							\
+			pb = _abs_(pb);							\
+			pc = _abs_(pc);							\
+											\
+			/* a if pa is smallest, else b if pb is smallest, else c */	\
+			__m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));	\
+			__m128i nearest = if_then_else(_mm_cmpeq_epi16(pa, smallest), a,	\
+					if_then_else(_mm_cmpeq_epi16(pb, smallest), b, c));	\
+											\
+			__m128i x = _mm_add_epi8(load_pixel(row, bpp),			\
+						 _mm_packus_epi16(nearest, nearest));	\
+			store_pixel(row, x, bpp);					\
+											\
+			a = _mm_unpacklo_epi8(x, zero);					\
+			c = b;								\
+			row += bpp;							\
+			prev_row += bpp;						\
+		}									\
+	} while (0)
+
+
+__attribute__((target("sse2"), always_inline))
+static inline void paeth_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	PAETH_LOOP(abs_sse2);
+}
+
+
+__attribute__((target("ssse3"), always_inline))
+static inline void paeth_ssse3(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	PAETH_LOOP(abs_ssse3);
+}
+
+
+/* constant bpp -> specialized loops */
+__attribute__((target("sse2")))
+void png_filters_paeth_x86_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	if (bpp == 3)
+		paeth_sse2(3, rowbytes, row, prev_row);
+	else
+		paeth_sse2(4, rowbytes, row, prev_row);
+}
+
+
+__attribute__((target("ssse3")))
+void png_filters_paeth_x86_ssse3(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	if (bpp == 3)
+		paeth_ssse3(3, rowbytes, row, prev_row);
+	else
+		paeth_ssse3(4, rowbytes, row, prev_row);
+}
+
+#endif /* RVVRADAR_X86_SUPPORT */
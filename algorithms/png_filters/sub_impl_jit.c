@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+
+#include <core/sysinfo.h>
+#include <core/rvvjit.h>
+
+
+/* pixels per iteration of main loop */
+#define UNROLL	4
+
+
+/*
+ * sub(a0: bpp, a1: rowbytes, a2: row, a3: prev_row) specialized to bpp
+ *
+ * row:      | a | x |
+ *
+ * a = a + x
+ *
+ * vl = bpp is an immediate (vsetivli; set once) and the pointer
+ * increments are constants; UNROLL pixels per iteration.
+ *
+ * a .. 	[v0](e8)
+ * x ..		[v8](e8)
+ * t5 .. end of row; t6 .. last start of main loop iteration
+ */
+static void *png_filters_sub_jit_generate(unsigned int bpp)
+{
+	unsigned int loop, tail, end;
+
+	rvvjit_t *jit = rvvjit_create();
+	if (jit == NULL)
+		return NULL;
+
+	rvvjit_vsetivli(jit, RVVJIT_ZERO, bpp, 8, 1);
+	rvvjit_add(jit, RVVJIT_T5, RVVJIT_A2, RVVJIT_A1);
+
+	/* a = *row */
+	rvvjit_vle(jit, 8, 0, RVVJIT_A2);
+	rvvjit_addi(jit, RVVJIT_A2, RVVJIT_A2, bpp);
+
+	/* main loop */
+	rvvjit_addi(jit, RVVJIT_T6, RVVJIT_T5, -(int)(UNROLL * bpp));
+	tail = rvvjit_branch_fwd(jit, RVVJIT_BLTU, RVVJIT_T6, RVVJIT_A2);
+	loop = rvvjit_label(jit);
+	for (unsigned int i = 0; i < UNROLL; i++) {
+		rvvjit_vle(jit, 8, 8, RVVJIT_A2);
+		rvvjit_vadd_vv(jit, 0, 0, 8);
+		rvvjit_vse(jit, 8, 0, RVVJIT_A2);
+		rvvjit_addi(jit, RVVJIT_A2, RVVJIT_A2, bpp);
+	}
+	rvvjit_branch(jit, RVVJIT_BGEU, RVVJIT_T6, RVVJIT_A2, loop);
+
+	/* remaining pixels */
+	rvvjit_resolve(jit, tail);
+	end = rvvjit_branch_fwd(jit, RVVJIT_BGEU, RVVJIT_A2, RVVJIT_T5);
+	loop = rvvjit_label(jit);
+	rvvjit_vle(jit, 8, 8, RVVJIT_A2);
+	rvvjit_vadd_vv(jit, 0, 0, 8);
+	rvvjit_vse(jit, 8, 0, RVVJIT_A2);
+	rvvjit_addi(jit, RVVJIT_A2, RVVJIT_A2, bpp);
+	rvvjit_branch(jit, RVVJIT_BLTU, RVVJIT_A2, RVVJIT_T5, loop);
+
+	rvvjit_resolve(jit, end);
+	rvvjit_ret(jit);
+
+	return rvvjit_finalize(jit);
+}
+
+
+/*
+ * generated once per bpp; NULL if not supported by the cpu (see
+ * rvvjit_supported) or bpp > 8
+ */
+void *png_filters_sub_jit_get(unsigned int bpp)
+{
+	static void *kernels[9] = { NULL };
+
+	if (bpp < 1 || bpp > 8)
+		return NULL;
+
+	if (kernels[bpp] == NULL && rvvjit_supported())
+		kernels[bpp] = png_filters_sub_jit_generate(bpp);
+
+	return kernels[bpp];
+}
@@ -19,7 +19,7 @@
 /* simple m1
  * two loads on same field
  */
-void png_filters_sub_rvv_dload(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+void RVV_SYM(png_filters_sub_rvv_dload)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
 {
 	uint8_t *rp_end = row + rowbytes;
 	uint8_t *row_next = row + bpp;
@@ -58,7 +58,7 @@ void png_filters_sub_rvv_dload(unsigned int bpp, unsigned int rowbytes, uint8_t
  *  * riscv-v-spec-0.7.1/0.8.1/0.9 -- Chapter 2 ("VLEN >= SLEN >= 32")
  *  * riscv-v-spec-1.0 -- Chapter 18
  */
-void png_filters_sub_rvv_reuse(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+void RVV_SYM(png_filters_sub_rvv_reuse)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
 {
 	uint8_t *rp_end = row + rowbytes;
 
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <core/rvv_helpers.h>
+
+
+#if RVVRADAR_RVV_INTRINSICS
+
+#include <riscv_vector.h>
+
+/*
+ * one pixel per vector (e8/m1); result of the previous pixel is reused
+ * (same as png_filters_sub_rvv_reuse, but scheduled by the compiler)
+ */
+void RVV_SYM(png_filters_sub_rvv_intrinsics_reuse)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	uint8_t *rp_end = row + rowbytes;
+	size_t vl = __riscv_vsetvl_e8m1(bpp);
+
+	/* a = *row */
+	vuint8m1_t a = __riscv_vle8_v_u8m1(row, vl);
+	row += bpp;
+
+	while (row < rp_end) {
+		/* a = a + x */
+		vuint8m1_t x = __riscv_vle8_v_u8m1(row, vl);
+		a = __riscv_vadd_vv_u8m1(a, x, vl);
+
+		/* *row = a */
+		__riscv_vse8_v_u8m1(row, a, vl);
+		row += bpp;
+	}
+}
+
+#endif /* RVVRADAR_RVV_INTRINSICS */
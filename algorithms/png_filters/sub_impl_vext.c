@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+/* GCC vector extension (vector_size); one pixel per vector (see alg.c) */
+typedef uint8_t vu8_t __attribute__((vector_size(8)));
+typedef int16_t vi16_t __attribute__((vector_size(16)));
+
+
+/* pixels from/to 4/2/1 byte accesses; little endian (risc-v, x86) */
+static inline __attribute__((always_inline)) vu8_t load_pixel(const uint8_t *p, unsigned int bpp)
+{
+	uint64_t v = 0;
+	unsigned int i = 0;
+
+	if (bpp == 8) {
+		memcpy(&v, p, 8);
+		return (vu8_t)v;
+	}
+
+	if (bpp & 4) {
+		uint32_t t;
+		memcpy(&t, p, 4);
+		v = t;
+		i = 4;
+	}
+	if (bpp & 2) {
+		uint16_t t;
+		memcpy(&t, p + i, 2);
+		v |= (uint64_t)t << (i * 8);
+		i += 2;
+	}
+	if (bpp & 1)
+		v |= (uint64_t)p[i] << (i * 8);
+
+	return (vu8_t)v;
+}
+
+
+static inline __attribute__((always_inline)) void store_pixel(uint8_t *p, vu8_t pix, unsigned int bpp)
+{
+	uint64_t v = (uint64_t)pix;
+	unsigned int i = 0;
+
+	if (bpp == 8) {
+		memcpy(p, &v, 8);
+		return;
+	}
+
+	if (bpp & 4) {
+		uint32_t t = v;
+		memcpy(p, &t, 4);
+		i = 4;
+	}
+	if (bpp & 2) {
+		uint16_t t = v >> (i * 8);
+		memcpy(p + i, &t, 2);
+		i += 2;
+	}
+	if (bpp & 1)
+		p[i] = v >> (i * 8);
+}
+
+
+/* call _fn_ with constant bpp -> specialized loops */
+#define BPP_DISPATCH(_fn_, ...)					\
+	do {							\
+		switch (bpp) {					\
+		case 1: _fn_(1, __VA_ARGS__); break;		\
+		case 2: _fn_(2, __VA_ARGS__); break;		\
+		case 3: _fn_(3, __VA_ARGS__); break;		\
+		case 4: _fn_(4, __VA_ARGS__); break;		\
+		case 6: _fn_(6, __VA_ARGS__); break;		\
+		default: _fn_(bpp, __VA_ARGS__); break;		\
+		}						\
+	} while (0)
+
+
+/* a = a + x (a = 0 for the first pixel) */
+static inline __attribute__((always_inline)) void sub_vext(unsigned int bpp, unsigned int rowbytes, uint8_t *row)
+{
+	uint8_t *rp_end = row + rowbytes;
+	vu8_t a = { 0 };
+
+	while (row < rp_end) {
+		a += load_pixel(row, bpp);
+		store_pixel(row, a, bpp);
+		row += bpp;
+	}
+}
+
+
+void png_filters_sub_vext(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	BPP_DISPATCH(sub_vext, rowbytes, row);
+}
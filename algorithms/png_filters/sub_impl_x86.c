@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#if RVVRADAR_X86_SUPPORT
+
+#include <immintrin.h>
+
+/*
+ * Each pixel depends on its left neighbor -> one pixel per vector (wider
+ * vectors do not help); only bpp 3 and 4 (see alg.c)
+ * Target attributes: see SYSINFO_ISA_* in core/sysinfo.h
+ */
+
+/*
+ * load/store a single pixel of bpp 3 or 4 from/to the lowest 32bit of a
+ * vector register
+ */
+__attribute__((target("sse2"), always_inline))
+static inline __m128i load_pixel(const uint8_t *p, unsigned int bpp)
+{
+	uint32_t v;
+
+	/* assembled in a register (no store forwarding stall) */
+	if (bpp == 3) {
+		uint16_t lo;
+		memcpy(&lo, p, 2);
+		v = lo | (uint32_t)p[2] << 16;
+	} else
+		memcpy(&v, p, 4);
+
+	return _mm_cvtsi32_si128(v);
+}
+
+
+__attribute__((target("sse2"), always_inline))
+static inline void store_pixel(uint8_t *p, __m128i v, unsigned int bpp)
+{
+	uint32_t x = _mm_cvtsi128_si32(v);
+
+	if (bpp == 3) {
+		uint16_t lo = x;
+		memcpy(p, &lo, 2);
+		p[2] = x >> 16;
+	} else
+		memcpy(p, &x, 4);
+}
+
+
+/* a = a + x (a = 0 for the first pixel) */
+__attribute__((target("sse2"), always_inline))
+static inline void sub_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row)
+{
+	uint8_t *rp_end = row + rowbytes;
+	__m128i a = _mm_setzero_si128();
+
+	while (row < rp_end) {
+		a = _mm_add_epi8(a, load_pixel(row, bpp));
+		store_pixel(row, a, bpp);
+		row += bpp;
+	}
+}
+
+
+/* constant bpp -> specialized loops */
+__attribute__((target("sse2")))
+void png_filters_sub_x86_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	if (bpp == 3)
+		sub_sse2(3, rowbytes, row);
+	else
+		sub_sse2(4, rowbytes, row);
+}
+
+#endif /* RVVRADAR_X86_SUPPORT */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+
+#include <core/sysinfo.h>
+#include <core/rvvjit.h>
+
+
+/*
+ * up(a0: bpp, a1: rowbytes, a2: row, a3: prev_row) specialized to VLEN
+ *
+ * row:      | x |
+ * prev_row: | b |
+ *
+ * b = b + x
+ *
+ * e8 elements in groups of eight registers; main loop with vl = VLMAX and
+ * two groups per iteration for VLEN < 256; tail stripmined with vsetvli.
+ *
+ * b (group i) ..	[v(i * 8)](e8)
+ * x (group i) ..	[v(16 + i * 8)](e8)
+ * t0 .. VLMAX; t1 .. bytes per iteration; t2 .. vl of tail
+ * t3/t4 .. load pointers of row/prev_row
+ */
+static void *png_filters_up_jit_generate(unsigned int vlen)
+{
+	unsigned int lmul = 8;
+	unsigned int unroll = vlen < 256 ? 2 : 1;
+	unsigned int loop, tail, end;
+
+	rvvjit_t *jit = rvvjit_create();
+	if (jit == NULL)
+		return NULL;
+
+	rvvjit_vsetvli(jit, RVVJIT_T0, RVVJIT_ZERO, 8, lmul);
+	rvvjit_slli(jit, RVVJIT_T1, RVVJIT_T0, __builtin_ctz(unroll));
+	tail = rvvjit_branch_fwd(jit, RVVJIT_BLTU, RVVJIT_A1, RVVJIT_T1);
+
+	/* main loop */
+	loop = rvvjit_label(jit);
+	rvvjit_addi(jit, RVVJIT_T3, RVVJIT_A2, 0);
+	rvvjit_addi(jit, RVVJIT_T4, RVVJIT_A3, 0);
+	for (unsigned int i = 0; i < unroll; i++) {
+		rvvjit_vle(jit, 8, i * lmul, RVVJIT_T3);
+		rvvjit_vle(jit, 8, 16 + i * lmul, RVVJIT_T4);
+		rvvjit_add(jit, RVVJIT_T3, RVVJIT_T3, RVVJIT_T0);
+		rvvjit_add(jit, RVVJIT_T4, RVVJIT_T4, RVVJIT_T0);
+	}
+	for (unsigned int i = 0; i < unroll; i++) {
+		rvvjit_vadd_vv(jit, i * lmul, i * lmul, 16 + i * lmul);
+		rvvjit_vse(jit, 8, i * lmul, RVVJIT_A2);
+		rvvjit_add(jit, RVVJIT_A2, RVVJIT_A2, RVVJIT_T0);
+	}
+	rvvjit_addi(jit, RVVJIT_A3, RVVJIT_T4, 0);
+	rvvjit_sub(jit, RVVJIT_A1, RVVJIT_A1, RVVJIT_T1);
+	rvvjit_branch(jit, RVVJIT_BGEU, RVVJIT_A1, RVVJIT_T1, loop);
+
+	/* tail */
+	rvvjit_resolve(jit, tail);
+	end = rvvjit_branch_fwd(jit, RVVJIT_BEQ, RVVJIT_A1, RVVJIT_ZERO);
+	loop = rvvjit_label(jit);
+	rvvjit_vsetvli(jit, RVVJIT_T2, RVVJIT_A1, 8, lmul);
+	rvvjit_vle(jit, 8, 0, RVVJIT_A2);
+	rvvjit_vle(jit, 8, 16, RVVJIT_A3);
+	rvvjit_vadd_vv(jit, 0, 0, 16);
+	rvvjit_vse(jit, 8, 0, RVVJIT_A2);
+	rvvjit_add(jit, RVVJIT_A2, RVVJIT_A2, RVVJIT_T2);
+	rvvjit_add(jit, RVVJIT_A3, RVVJIT_A3, RVVJIT_T2);
+	rvvjit_sub(jit, RVVJIT_A1, RVVJIT_A1, RVVJIT_T2);
+	rvvjit_branch(jit, RVVJIT_BNE, RVVJIT_A1, RVVJIT_ZERO, loop);
+
+	rvvjit_resolve(jit, end);
+	rvvjit_ret(jit);
+
+	return rvvjit_finalize(jit);
+}
+
+
+/* generated once; NULL if not supported by the cpu (see rvvjit_supported) */
+void *png_filters_up_jit_get(void)
+{
+	static void *kernel = NULL;
+
+	if (kernel == NULL && rvvjit_supported())
+		kernel = png_filters_up_jit_generate(sysinfo_get_vlen());
+
+	return kernel;
+}
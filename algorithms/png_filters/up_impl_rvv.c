@@ -16,7 +16,7 @@
  * different vector sizes m1, m2, m4, m8
  */
 
-void png_filters_up_rvv_m1(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+void RVV_SYM(png_filters_up_rvv_m1)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
 {
 	/*
 	 * row:      | x |
@@ -48,7 +48,7 @@ void png_filters_up_rvv_m1(unsigned int bpp, unsigned int rowbytes, uint8_t *row
 }
 
 
-void png_filters_up_rvv_m2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+void RVV_SYM(png_filters_up_rvv_m2)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
 {
 	/*
 	 * row:      | x |
@@ -80,7 +80,7 @@ void png_filters_up_rvv_m2(unsigned int bpp, unsigned int rowbytes, uint8_t *row
 }
 
 
-void png_filters_up_rvv_m4(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+void RVV_SYM(png_filters_up_rvv_m4)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
 {
 	/*
 	 * row:      | x |
@@ -112,7 +112,7 @@ void png_filters_up_rvv_m4(unsigned int bpp, unsigned int rowbytes, uint8_t *row
 }
 
 
-void png_filters_up_rvv_m8(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+void RVV_SYM(png_filters_up_rvv_m8)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
 {
 	/*
 	 * row:      | x |
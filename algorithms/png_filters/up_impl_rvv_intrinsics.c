@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <core/rvv_helpers.h>
+
+
+#if RVVRADAR_RVV_INTRINSICS
+
+#include <riscv_vector.h>
+
+/*
+ * add rows in vectors of e8/m8 and save result back
+ * (same as png_filters_up_rvv_m8, but scheduled by the compiler)
+ */
+void RVV_SYM(png_filters_up_rvv_intrinsics_m8)(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	while (rowbytes) {
+		size_t vl = __riscv_vsetvl_e8m8(rowbytes);
+
+		vuint8m8_t x = __riscv_vle8_v_u8m8(row, vl);
+		vuint8m8_t b = __riscv_vle8_v_u8m8(prev_row, vl);
+		prev_row += vl;
+
+		/* *row = x + b */
+		__riscv_vse8_v_u8m8(row, __riscv_vadd_vv_u8m8(x, b, vl), vl);
+		row += vl;
+
+		rowbytes -= vl;
+	}
+}
+
+#endif /* RVVRADAR_RVV_INTRINSICS */
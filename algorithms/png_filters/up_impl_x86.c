@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+
+#if RVVRADAR_X86_SUPPORT
+
+#include <immintrin.h>
+
+/*
+ * add rows in vectors (independent of bpp)
+ * Target attributes: see SYSINFO_ISA_* in core/sysinfo.h
+ * Tails are calculated by scalar code.
+ */
+
+static void png_filters_up_x86_tail(unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	for (unsigned int i = 0; i < rowbytes; i++)
+		row[i] = row[i] + prev_row[i];
+}
+
+
+__attribute__((target("sse2")))
+void png_filters_up_x86_sse2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	for (; rowbytes >= 16; rowbytes -= 16) {
+		__m128i x = _mm_loadu_si128((__m128i *)row);
+		__m128i b = _mm_loadu_si128((__m128i *)prev_row);
+		_mm_storeu_si128((__m128i *)row, _mm_add_epi8(x, b));
+		row += 16;
+		prev_row += 16;
+	}
+
+	png_filters_up_x86_tail(rowbytes, row, prev_row);
+}
+
+
+__attribute__((target("avx2")))
+void png_filters_up_x86_avx2(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	for (; rowbytes >= 32; rowbytes -= 32) {
+		__m256i x = _mm256_loadu_si256((__m256i *)row);
+		__m256i b = _mm256_loadu_si256((__m256i *)prev_row);
+		_mm256_storeu_si256((__m256i *)row, _mm256_add_epi8(x, b));
+		row += 32;
+		prev_row += 32;
+	}
+
+	png_filters_up_x86_tail(rowbytes, row, prev_row);
+}
+
+
+/* 8bit addition requires avx512bw */
+__attribute__((target("avx512f,avx512bw")))
+void png_filters_up_x86_avx512(unsigned int bpp, unsigned int rowbytes, uint8_t *row, uint8_t *prev_row)
+{
+	for (; rowbytes >= 64; rowbytes -= 64) {
+		__m512i x = _mm512_loadu_si512((void *)row);
+		__m512i b = _mm512_loadu_si512((void *)prev_row);
+		_mm512_storeu_si512((void *)row, _mm512_add_epi8(x, b));
+		row += 64;
+		prev_row += 64;
+	}
+
+	png_filters_up_x86_tail(rowbytes, row, prev_row);
+}
+
+#endif /* RVVRADAR_X86_SUPPORT */
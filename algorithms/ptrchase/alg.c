@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "alg.h"
+
+
+/*
+ * Randomized pointer chase
+ * The working set of len bytes is divided into lines of PTRCHASE_LINE
+ * bytes. The first word of each line points to the next line of a random
+ * cyclic permutation (Sattolo) over all lines -> no spatial locality and
+ * no pattern for the prefetchers; each load depends on the previous one.
+ * Each run follows the cycle for the number of loads given in the
+ * parameter string (whole cycles, at least PTRCHASE_MIN_LOADS) ->
+ * load-to-use latency = tdmedian / loads (see tools/memhier.sh).
+ * For working sets larger than the TLB reach, the latency includes page
+ * walks (as seen by random accesses of applications).
+ */
+
+/* size of a line (one pointer per cache line) */
+#define PTRCHASE_LINE			64
+
+/* minimum loads per run (small working sets are followed multiple times) */
+#define PTRCHASE_MIN_LOADS		65536
+
+/* unroll of the implementations (loads has to be a multiple of) */
+#define PTRCHASE_UNROLL			8
+
+
+/* algorithm specific data */
+struct data {
+	unsigned int loads;	// loads per run
+	uint8_t *buf;		// lines
+	void *end;		// pointer reached
+};
+
+
+/* implementation specific data */
+typedef void *(*ptrchase_fp_t)(void *start, unsigned int loads);
+struct impldata {
+	ptrchase_fp_t ptrchase;	// ptrchase to be called by wrapper
+};
+
+
+static int impl_exec_wrapper(impl_t *impl, bool verify)
+{
+	struct data *d = IMPL_GET_ALG_PRIV_DATA(struct data*, impl);
+	struct impldata *sd = IMPL_GET_PRIV_DATA(struct impldata*, impl);
+	d->end = sd->ptrchase(d->buf, d->loads);
+	return 0;
+}
+
+
+static int impl_postexec(impl_t *impl, bool verify)
+{
+	/* result-verify disabled -> nothing to do */
+	if (!verify)
+		return 0;
+
+	struct data *d = IMPL_GET_ALG_PRIV_DATA(struct data*, impl);
+
+	/* whole cycles -> back at start */
+	if (d->end != d->buf) {
+		fprintf(stderr, "%s: ERROR: end=%p != start=%p\n", __FILE__, d->end, d->buf);
+		return 1;	/* data error */
+	}
+
+	return 0;
+}
+
+
+static int impl_add(
+	alg_t *alg,
+	const char *name,
+	const impl_req_t *req,
+	ptrchase_fp_t ptrchase)
+{
+	impl_t *impl;
+
+	impl = alg_add_impl(alg,
+			    name,
+			    req,
+			    NULL,
+			    NULL,
+			    impl_exec_wrapper,
+			    impl_postexec,
+			    NULL,
+			    sizeof(struct impldata));
+	if (impl == NULL)
+		return -1;
+
+	struct impldata *sd = IMPL_GET_PRIV_DATA(struct impldata*, impl);
+	sd->ptrchase = ptrchase;
+
+	return 0;
+}
+
+
+
+extern void *ptrchase_c(void *start, unsigned int loads);
+/* whole lines; lines aligned */
+static const impl_req_t req_c = { .len_multiple = PTRCHASE_LINE, .align = PTRCHASE_LINE };
+
+static int impls_add(alg_t *alg)
+{
+	int ret = 0;
+
+	ret |= impl_add(alg, "c",	&req_c, (ptrchase_fp_t)ptrchase_c);
+
+	if (ret)
+		return -1;
+
+	return 0;
+}
+
+
+static int alg_preexec(struct alg *alg, int seed)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	unsigned int nlines = alg->len / PTRCHASE_LINE;
+
+	/* alloc */
+	d->buf = alg_alloc(alg, alg->len);
+	if (d->buf == NULL)
+		goto __err_alloc_buf;
+	unsigned int *next = malloc(nlines * sizeof(unsigned int));
+	if (next == NULL)
+		goto __err_alloc_next;
+
+	/* random cyclic permutation (Sattolo) */
+	srandom(seed);
+	for (unsigned int i = 0; i < nlines; i++)
+		next[i] = i;
+	for (unsigned int i = nlines - 1; i > 0; i--) {
+		unsigned int j = random() % i;
+		unsigned int tmp = next[i];
+		next[i] = next[j];
+		next[j] = tmp;
+	}
+
+	/* link lines */
+	memset(d->buf, 0, alg->len);
+	for (unsigned int i = 0; i < nlines; i++)
+		*(void **)(d->buf + (size_t)i * PTRCHASE_LINE) = d->buf + (size_t)next[i] * PTRCHASE_LINE;
+
+	free(next);
+
+	return 0;
+
+__err_alloc_next:
+	free(d->buf);
+__err_alloc_buf:
+	return -1;
+}
+
+
+static int alg_postexec(struct alg *alg)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+
+	free(d->buf);
+
+	return 0;
+}
+
+
+/* greatest common divisor */
+static unsigned int gcd(unsigned int a, unsigned int b)
+{
+	while (b) {
+		unsigned int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+
+int alg_ptrchase_add(algset_t *algset, unsigned int len)
+{
+	/*
+	 * len is padded to whole lines (see req_c) when the algorithm is
+	 * added to the set
+	 */
+	unsigned int nlines = (len + PTRCHASE_LINE - 1) / PTRCHASE_LINE;
+	if (nlines == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* whole cycles, at least PTRCHASE_MIN_LOADS, multiple of unroll */
+	unsigned int rounds = (PTRCHASE_MIN_LOADS + nlines - 1) / nlines;
+	unsigned int rounds_multiple = PTRCHASE_UNROLL / gcd(nlines, PTRCHASE_UNROLL);
+	rounds = (rounds + rounds_multiple - 1) / rounds_multiple * rounds_multiple;
+	unsigned int loads = rounds * nlines;
+
+	/* build parameter string */
+	char parastr[256] = "\0";
+	snprintf(parastr, 256, "len=%u,loads=%u", len, loads);
+
+	/* create algorithm */
+	alg_t *alg = alg_create(
+			     "ptrchase",
+			     parastr,
+			     len,
+			     alg_preexec,
+			     alg_postexec,
+			     sizeof(struct data));
+	if (alg == NULL)
+		return -1;
+
+	/* set private data */
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	d->loads = loads;
+
+	/* add implementations */
+	if (impls_add(alg) < 0) {
+		alg_destroy(alg);
+		return -1;
+	}
+
+	/* add algorithm to set */
+	if (algset_add_alg(algset, alg) < 0) {
+		alg_destroy(alg);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static int alg_ptrchase_desc_add(algset_t *algset, unsigned int len, const unsigned int *values)
+{
+	return alg_ptrchase_add(algset, len);
+}
+
+
+const alg_desc_t alg_ptrchase_desc = {
+	.name = "ptrchase",
+	.description = "load-to-use latency (bytes of working set)",
+	.add = alg_ptrchase_desc_add,
+};
@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef ALG_PTRCHASE_H
+#define ALG_PTRCHASE_H
+
+#include <core/algset.h>
+
+/* descriptor (no parameters) */
+extern const alg_desc_t alg_ptrchase_desc;
+
+/*
+ * add a randomized pointer chase (load-to-use latency)
+ * algset .. set to add to
+ * len .. working set in bytes (padded to a multiple of the line size)
+ */
+int alg_ptrchase_add(algset_t *algset, unsigned int len);
+
+#endif /* ALG_PTRCHASE_H */
@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * follow the chain of pointers for loads steps
+ * (address of each load depends on the previous -> load-to-use latency)
+ * return: pointer reached
+ */
+void *ptrchase_c(void *start, unsigned int loads)
+{
+	void **p = start;
+
+	/* unrolled by 8 (loads is a multiple of 8; see alg.c) */
+	for (; loads > 0; loads -= 8) {
+		p = *p; p = *p; p = *p; p = *p;
+		p = *p; p = *p; p = *p; p = *p;
+	}
+
+	return p;
+}
@@ -0,0 +1,397 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <core/rvv_helpers.h>
+#include <core/c_variants.h>
+#include "alg.h"
+
+
+/*
+ * STREAM memory bandwidth kernels (copy, scale, add, triad)
+ * len is the working set in bytes over all arrays (x and dst; y for add
+ * and triad) -> one length schedule covers the cache levels for all
+ * kernels (and ptrchase). The elements per array and the bytes moved per
+ * run (STREAM counting; each element read or written once) are given in
+ * the parameter string (bandwidth; see tools/memhier.sh).
+ * Elements are initialized with small integers -> results are exact
+ * (also with fused multiply-add).
+ */
+
+/* scalar of scale and triad */
+#define STREAM_Q			3.0
+
+
+/* algorithm specific data */
+struct data {
+	enum alg_stream_kernel kernel;
+	unsigned int narrays;	// arrays of the kernel (2 or 3)
+	unsigned int len;	// elements per array
+	double *dst;		// output
+	double *x;		// input
+	double *y;		// input (add, triad; NULL otherwise)
+	double *dst_compare;	// output to compare
+};
+
+
+/* implementation specific data */
+typedef void (*stream_fp_t)(double *dst, double *x, double *y, double q, unsigned int len);
+struct impldata {
+	stream_fp_t stream;	// kernel to be called by wrapper
+};
+
+
+static void diff_fields(double *dst, double *compare, int len)
+{
+	fprintf(stderr, "\n");
+	for (int i = 0; i < len; i++)
+		if (dst[i] != compare[i])
+			fprintf(stderr, "%s: ERROR: diff on idx=%i: dst=%f != compare=%f\n",
+				__FILE__, i, dst[i], compare[i]);
+	fprintf(stderr, "\n");
+}
+
+
+static int impl_preexec(impl_t *impl, int iteration, bool verify)
+{
+	/* result-verify disabled -> nothing to do */
+	if (!verify)
+		return 0;
+
+	struct data *d = IMPL_GET_ALG_PRIV_DATA(struct data*, impl);
+	/* reset dst array before execution */
+	memset(d->dst, 0, d->len * sizeof(double));
+	return 0;
+}
+
+
+static int impl_exec_wrapper(impl_t *impl, bool verify)
+{
+	struct data *d = IMPL_GET_ALG_PRIV_DATA(struct data*, impl);
+	struct impldata *sd = IMPL_GET_PRIV_DATA(struct impldata*, impl);
+	sd->stream(d->dst, d->x, d->y, STREAM_Q, d->len);
+	return 0;
+}
+
+
+static int impl_postexec(impl_t *impl, bool verify)
+{
+	/* result-verify disabled -> nothing to do */
+	if (!verify)
+		return 0;
+
+	struct data *d = IMPL_GET_ALG_PRIV_DATA(struct data*, impl);
+
+	/* use memcmp for speed -> use diff only if error was detected */
+	int ret = memcmp(d->dst, d->dst_compare, d->len * sizeof(double));
+	if (ret) {
+		diff_fields(d->dst, d->dst_compare, d->len);
+		return 1;	/* data error */
+	}
+
+	return 0;
+}
+
+
+static int impl_add(
+	alg_t *alg,
+	const char *name,
+	const impl_req_t *req,
+	stream_fp_t stream)
+{
+	impl_t *impl;
+
+	/* kernel not built for the rvv draft of the cpu (see RVV_SELECT) */
+	if (stream == NULL)
+		return 0;
+
+	impl = alg_add_impl(alg,
+			    name,
+			    req,
+			    NULL,
+			    impl_preexec,
+			    impl_exec_wrapper,
+			    impl_postexec,
+			    NULL,
+			    sizeof(struct impldata));
+	if (impl == NULL)
+		return -1;
+
+	struct impldata *sd = IMPL_GET_PRIV_DATA(struct impldata*, impl);
+	sd->stream = stream;
+
+	return 0;
+}
+
+
+
+/*
+ * requirements of all implementations
+ * whole elements in each array -> len multiple of narrays * 8 bytes
+ */
+static impl_req_t req_get(alg_t *alg, unsigned int isa)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	impl_req_t req = {
+		.isa = isa,
+		.len_multiple = d->narrays * sizeof(double),
+		.align = sizeof(double),
+	};
+	return req;
+}
+
+
+#define STREAM_DECLARE(_kernel_) \
+	extern void stream_##_kernel_##_c_avect(double *dst, double *x, double *y, double q, unsigned int len); \
+	extern void stream_##_kernel_##_c_noavect(double *dst, double *x, double *y, double q, unsigned int len);
+#define STREAM_C_MATRIX_DECLARE(_v_) \
+	extern void stream_copy_c_##_v_(double *dst, double *x, double *y, double q, unsigned int len); \
+	extern void stream_scale_c_##_v_(double *dst, double *x, double *y, double q, unsigned int len); \
+	extern void stream_add_c_##_v_(double *dst, double *x, double *y, double q, unsigned int len); \
+	extern void stream_triad_c_##_v_(double *dst, double *x, double *y, double q, unsigned int len);
+STREAM_DECLARE(copy)
+STREAM_DECLARE(scale)
+STREAM_DECLARE(add)
+STREAM_DECLARE(triad)
+C_MATRIX_FOREACH(STREAM_C_MATRIX_DECLARE)
+#if RVVRADAR_RVV_SUPPORT
+#define STREAM_RVV_DECLARE(_kernel_) \
+	RVV_DECLARE(stream_##_kernel_##_rvv_m1, (double *dst, double *x, double *y, double q, unsigned int len)); \
+	RVV_DECLARE(stream_##_kernel_##_rvv_m8, (double *dst, double *x, double *y, double q, unsigned int len));
+STREAM_RVV_DECLARE(copy)
+STREAM_RVV_DECLARE(scale)
+STREAM_RVV_DECLARE(add)
+STREAM_RVV_DECLARE(triad)
+#endif /* RVVRADAR_RVV_SUPPORT */
+
+/* implementations of a kernel (c: scalar and autovectorized; rvv) */
+#define STREAM_IMPLS_ADD(_kernel_) \
+	ret |= impl_add(alg, "c noavect",	&req, (stream_fp_t)stream_##_kernel_##_c_noavect); \
+	ret |= impl_add(alg, "c avect",		&req, (stream_fp_t)stream_##_kernel_##_c_avect); \
+	C_MATRIX_FOREACH(STREAM_C_MATRIX_ADD_##_kernel_) \
+	STREAM_RVV_ADD(_kernel_)
+#define STREAM_C_MATRIX_ADD_copy(_v_)	ret |= impl_add(alg, "c " #_v_, &req, (stream_fp_t)stream_copy_c_##_v_);
+#define STREAM_C_MATRIX_ADD_scale(_v_)	ret |= impl_add(alg, "c " #_v_, &req, (stream_fp_t)stream_scale_c_##_v_);
+#define STREAM_C_MATRIX_ADD_add(_v_)	ret |= impl_add(alg, "c " #_v_, &req, (stream_fp_t)stream_add_c_##_v_);
+#define STREAM_C_MATRIX_ADD_triad(_v_)	ret |= impl_add(alg, "c " #_v_, &req, (stream_fp_t)stream_triad_c_##_v_);
+#if RVVRADAR_RVV_SUPPORT
+#define STREAM_RVV_ADD(_kernel_) \
+	ret |= impl_add(alg, "rvv m1",		&req_rvv, (stream_fp_t)RVV_SELECT(stream_##_kernel_##_rvv_m1)); \
+	ret |= impl_add(alg, "rvv m8",		&req_rvv, (stream_fp_t)RVV_SELECT(stream_##_kernel_##_rvv_m8));
+#else
+#define STREAM_RVV_ADD(_kernel_)
+#endif /* RVVRADAR_RVV_SUPPORT */
+
+static int impls_add(alg_t *alg)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	const impl_req_t req = req_get(alg, 0);
+#if RVVRADAR_RVV_SUPPORT
+	const impl_req_t req_rvv = req_get(alg, SYSINFO_ISA_RVV);
+#endif /* RVVRADAR_RVV_SUPPORT */
+	int ret = 0;
+
+	switch (d->kernel) {
+	case stream_copy:
+		STREAM_IMPLS_ADD(copy)
+		break;
+	case stream_scale:
+		STREAM_IMPLS_ADD(scale)
+		break;
+	case stream_add:
+		STREAM_IMPLS_ADD(add)
+		break;
+	case stream_triad:
+		STREAM_IMPLS_ADD(triad)
+		break;
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (ret)
+		return -1;
+
+	return 0;
+}
+
+
+static int alg_preexec(struct alg *alg, int seed)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+
+	/* len may be padded (see req_get) */
+	d->len = alg->len / (d->narrays * sizeof(double));
+	size_t size = d->len * sizeof(double);
+
+	/* alloc */
+	d->dst = alg_alloc(alg, size);
+	if (d->dst == NULL)
+		goto __err_alloc_dst;
+	d->x = alg_alloc(alg, size);
+	if (d->x == NULL)
+		goto __err_alloc_x;
+	d->y = NULL;
+	if (d->narrays > 2) {
+		d->y = alg_alloc(alg, size);
+		if (d->y == NULL)
+			goto __err_alloc_y;
+	}
+	d->dst_compare = alg_alloc(alg, size);
+	if (d->dst_compare == NULL)
+		goto __err_alloc_dst_compare;
+
+	/* init with random small integers (exact results) */
+	srandom(seed);
+	for (int i = 0; i < d->len; i++) {
+		d->x[i] = random() % 1024;
+		if (d->y)
+			d->y[i] = random() % 1024;
+	}
+	memset(d->dst, 0, size);
+
+	/* calculate compare */
+	switch (d->kernel) {
+	case stream_copy:
+		stream_copy_c_noavect(d->dst_compare, d->x, d->y, STREAM_Q, d->len);
+		break;
+	case stream_scale:
+		stream_scale_c_noavect(d->dst_compare, d->x, d->y, STREAM_Q, d->len);
+		break;
+	case stream_add:
+		stream_add_c_noavect(d->dst_compare, d->x, d->y, STREAM_Q, d->len);
+		break;
+	case stream_triad:
+		stream_triad_c_noavect(d->dst_compare, d->x, d->y, STREAM_Q, d->len);
+		break;
+	default:
+		errno = EINVAL;
+		goto __err_calc_dst_compare;
+	}
+
+	return 0;
+
+__err_calc_dst_compare:
+	free(d->dst_compare);
+__err_alloc_dst_compare:
+	free(d->y);
+__err_alloc_y:
+	free(d->x);
+__err_alloc_x:
+	free(d->dst);
+__err_alloc_dst:
+	return -1;
+}
+
+
+static int alg_postexec(struct alg *alg)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+
+	free(d->dst);
+	free(d->x);
+	free(d->y);
+	free(d->dst_compare);
+
+	return 0;
+}
+
+
+/* parameters */
+
+static const char * const kernel_names[] = { "copy", "scale", "add", "triad", NULL };
+static const unsigned int kernel_defaults[] = { stream_copy, stream_scale, stream_add, stream_triad };
+
+static const param_desc_t params[] = {
+	{
+		.name = "kernel",
+		.type = PARAM_TYPE_ENUM,
+		.enum_names = kernel_names,
+		.defaults = PARAM_VALUES(kernel_defaults),
+	},
+};
+
+
+int alg_stream_add(
+	algset_t *algset,
+	enum alg_stream_kernel kernel,
+	unsigned int len)
+{
+	/* check parameters */
+	if (kernel > stream_triad) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* build name string */
+	char namestr[256] = "\0";
+	snprintf(namestr, 256, "stream_%s", kernel_names[kernel]);
+
+	/* x and dst; y for add and triad */
+	unsigned int narrays = (kernel == stream_add || kernel == stream_triad) ? 3 : 2;
+
+	/* elements per array and bytes moved after padding (see req_get) */
+	unsigned int elements = (len + narrays * sizeof(double) - 1) / (narrays * sizeof(double));
+	unsigned int bytes = elements * narrays * sizeof(double);
+
+	/* build parameter string */
+	char parastr[256] = "\0";
+	unsigned int values[] = { kernel };
+	int pos = alg_desc_parastr(&alg_stream_desc, len, values, parastr, 256);
+	if (pos < 0)
+		return -1;
+	snprintf(parastr + pos, pos < 256 ? 256 - pos : 0, ",elements=%u,bytes=%u", elements, bytes);
+
+	/* create algorithm */
+	alg_t *alg = alg_create(
+			     namestr,
+			     parastr,
+			     len,
+			     alg_preexec,
+			     alg_postexec,
+			     sizeof(struct data));
+	if (alg == NULL)
+		return -1;
+
+	/* set private data */
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	d->kernel = kernel;
+	d->narrays = narrays;
+	d->len = elements;
+
+	/* add implementations */
+	if (impls_add(alg) < 0) {
+		alg_destroy(alg);
+		return -1;
+	}
+
+	/* add algorithm to set */
+	if (algset_add_alg(algset, alg) < 0) {
+		alg_destroy(alg);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static int alg_stream_desc_add(algset_t *algset, unsigned int len, const unsigned int *values)
+{
+	return alg_stream_add(algset, values[0], len);
+}
+
+
+const alg_desc_t alg_stream_desc = {
+	.name = "stream",
+	.description = "STREAM memory bandwidth (bytes of working set)",
+	.params = params,
+	.nparams = sizeof(params) / sizeof(params[0]),
+	.add = alg_stream_desc_add,
+};
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef ALG_STREAM_H
+#define ALG_STREAM_H
+
+#include <core/algset.h>
+
+/* STREAM kernels */
+enum alg_stream_kernel {
+	stream_copy,		// dst = x
+	stream_scale,		// dst = q * x
+	stream_add,		// dst = x + y
+	stream_triad		// dst = x + q * y
+};
+
+/*
+ * descriptor (parameters: kernel)
+ */
+extern const alg_desc_t alg_stream_desc;
+
+/*
+ * add a STREAM kernel
+ * algset .. set to add to
+ * kernel .. which kernel to add (see above)
+ * len .. working set in bytes (all arrays; 64bit floating point elements)
+ */
+int alg_stream_add(
+	algset_t *algset,
+	enum alg_stream_kernel kernel,
+	unsigned int len);
+
+#endif /* ALG_STREAM_H */
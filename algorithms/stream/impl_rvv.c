@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+
+#include <core/rvv_helpers.h>
+
+
+#if RVVRADAR_RVV_SUPPORT
+
+/*
+ * STREAM kernels on 64bit floating point elements (e64)
+ * different vector sizes m1 and m8
+ * (sources in v8/v16, destination in v24; q in a fp register)
+ */
+
+#define STREAM_RVV_COPY(_lmul_) \
+void RVV_SYM(stream_copy_rvv_m##_lmul_)(double *dst, double *x, double *y, double q, unsigned int len) \
+{ \
+	unsigned int vl; \
+	while (len) { \
+		asm volatile ("vsetvli		%0, %1, e64, m" #_lmul_ : "=r" (vl) : "r" (len)); \
+		asm volatile (VLE64_V"		v8, (%0)" : : "r" (x)); \
+		x += vl; \
+		asm volatile (VSE64_V"		v8, (%0)" : : "r" (dst) : "memory"); \
+		dst += vl; \
+		len -= vl; \
+	} \
+}
+
+#define STREAM_RVV_SCALE(_lmul_) \
+void RVV_SYM(stream_scale_rvv_m##_lmul_)(double *dst, double *x, double *y, double q, unsigned int len) \
+{ \
+	unsigned int vl; \
+	while (len) { \
+		asm volatile ("vsetvli		%0, %1, e64, m" #_lmul_ : "=r" (vl) : "r" (len)); \
+		asm volatile (VLE64_V"		v8, (%0)" : : "r" (x)); \
+		x += vl; \
+		asm volatile ("vfmul.vf		v24, v8, %0" : : "f" (q)); \
+		asm volatile (VSE64_V"		v24, (%0)" : : "r" (dst) : "memory"); \
+		dst += vl; \
+		len -= vl; \
+	} \
+}
+
+#define STREAM_RVV_ADD(_lmul_) \
+void RVV_SYM(stream_add_rvv_m##_lmul_)(double *dst, double *x, double *y, double q, unsigned int len) \
+{ \
+	unsigned int vl; \
+	while (len) { \
+		asm volatile ("vsetvli		%0, %1, e64, m" #_lmul_ : "=r" (vl) : "r" (len)); \
+		asm volatile (VLE64_V"		v8, (%0)" : : "r" (x)); \
+		x += vl; \
+		asm volatile (VLE64_V"		v16, (%0)" : : "r" (y)); \
+		y += vl; \
+		asm volatile ("vfadd.vv		v24, v8, v16"); \
+		asm volatile (VSE64_V"		v24, (%0)" : : "r" (dst) : "memory"); \
+		dst += vl; \
+		len -= vl; \
+	} \
+}
+
+/* dst = x + q * y: multiply-accumulate into x */
+#define STREAM_RVV_TRIAD(_lmul_) \
+void RVV_SYM(stream_triad_rvv_m##_lmul_)(double *dst, double *x, double *y, double q, unsigned int len) \
+{ \
+	unsigned int vl; \
+	while (len) { \
+		asm volatile ("vsetvli		%0, %1, e64, m" #_lmul_ : "=r" (vl) : "r" (len)); \
+		asm volatile (VLE64_V"		v8, (%0)" : : "r" (x)); \
+		x += vl; \
+		asm volatile (VLE64_V"		v16, (%0)" : : "r" (y)); \
+		y += vl; \
+		asm volatile ("vfmacc.vf		v8, %0, v16" : : "f" (q)); \
+		asm volatile (VSE64_V"		v8, (%0)" : : "r" (dst) : "memory"); \
+		dst += vl; \
+		len -= vl; \
+	} \
+}
+
+STREAM_RVV_COPY(1)
+STREAM_RVV_COPY(8)
+STREAM_RVV_SCALE(1)
+STREAM_RVV_SCALE(8)
+STREAM_RVV_ADD(1)
+STREAM_RVV_ADD(8)
+STREAM_RVV_TRIAD(1)
+STREAM_RVV_TRIAD(8)
+
+#endif /* RVVRADAR_RVV_SUPPORT */
@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <core/rvv_helpers.h>
+#include "alg.h"
+
+
+/*
+ * Microarchitectural characterization of vector instructions
+ * len is the number of measured instructions of the class (8 per loop
+ * iteration of the kernels; see impl_rvv.c). Time per instruction is
+ * converted to cycles by the scalar add chain measured with the same len
+ * (one cycle per add; no portable user mode cycle counter):
+ *   latency [cycles]      = tdmedian(rvv latency) / tdmedian(add chain)
+ *   rthroughput [cycles]  = tdmedian(rvv throughput) / tdmedian(add chain)
+ * (see tools/uarch.sh)
+ * The loads of the latency chains include vse8, lbu and add (address of
+ * the next load depends on the loaded element; see impl_rvv.c).
+ */
+
+/* zeroed buffer for loads: m8 register group with stride/fields of 3 */
+#define UARCH_BUF_SIZE(_vlen_)		(3 * (_vlen_))
+
+/* instructions per loop iteration of the kernels */
+#define UARCH_UNROLL			8
+
+
+/* algorithm specific data */
+struct data {
+	enum alg_uarch_insn insn;
+	unsigned int lmul;
+	uint8_t *buf;		// zeroed buffer (loads)
+};
+
+
+/* implementation specific data */
+typedef void (*uarch_fp_t)(unsigned int n, uint8_t *buf);
+struct impldata {
+	uarch_fp_t uarch;	// kernel to be called by wrapper
+};
+
+
+/* reference and kernels are only added with rvv (see alg_uarch_add) */
+#if RVVRADAR_RVV_SUPPORT
+static int impl_exec_wrapper(impl_t *impl, bool verify)
+{
+	alg_t *alg = IMPL_GET_ALG(impl);
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	struct impldata *sd = IMPL_GET_PRIV_DATA(struct impldata*, impl);
+	sd->uarch(alg->len / UARCH_UNROLL, d->buf);
+	return 0;
+}
+
+
+static int impl_add(
+	alg_t *alg,
+	const char *name,
+	const impl_req_t *req,
+	uarch_fp_t uarch)
+{
+	impl_t *impl;
+
+	/* kernel not built for the rvv draft of the cpu (see RVV_SELECT) or
+	 * combination of class and lmul not available (see impl_rvv.c) */
+	if (uarch == NULL)
+		return 0;
+
+	impl = alg_add_impl(alg,
+			    name,
+			    req,
+			    NULL,
+			    NULL,
+			    impl_exec_wrapper,
+			    NULL,
+			    NULL,
+			    sizeof(struct impldata));
+	if (impl == NULL)
+		return -1;
+
+	struct impldata *sd = IMPL_GET_PRIV_DATA(struct impldata*, impl);
+	sd->uarch = uarch;
+
+	return 0;
+}
+
+
+extern void uarch_rv_add_chain(unsigned int n, uint8_t *buf);
+static const impl_req_t req_rv = { .isa = SYSINFO_ISA_RV, .len_multiple = UARCH_UNROLL };
+/* kernels of all classes and lmul (see impl_rvv.c) */
+#define UARCH_FOREACH(_X_) \
+	_X_(vsetvli, 1) _X_(vsetvli, 2) _X_(vsetvli, 4) _X_(vsetvli, 8) \
+	_X_(vlmul, 1) _X_(vlmul, 2) _X_(vlmul, 4) _X_(vlmul, 8) \
+	_X_(vle, 1) _X_(vle, 2) _X_(vle, 4) _X_(vle, 8) \
+	_X_(vlse, 1) _X_(vlse, 2) _X_(vlse, 4) _X_(vlse, 8) \
+	_X_(vlseg, 1) _X_(vlseg, 2) _X_(vlseg, 4) _X_(vlseg, 8) \
+	_X_(vwmacc, 1) _X_(vwmacc, 2) _X_(vwmacc, 4) _X_(vwmacc, 8) \
+	_X_(vmerge, 1) _X_(vmerge, 2) _X_(vmerge, 4) _X_(vmerge, 8) \
+	_X_(vmsltu, 1) _X_(vmsltu, 2) _X_(vmsltu, 4) _X_(vmsltu, 8)
+#define UARCH_RVV_DECLARE(_insn_, _lmul_) \
+	RVV_DECLARE(uarch_##_insn_##_m##_lmul_##_lat, (unsigned int n, uint8_t *buf)); \
+	RVV_DECLARE(uarch_##_insn_##_m##_lmul_##_tput, (unsigned int n, uint8_t *buf));
+UARCH_FOREACH(UARCH_RVV_DECLARE)
+static const impl_req_t req_rvv = { .isa = SYSINFO_ISA_RVV, .len_multiple = UARCH_UNROLL };
+#endif /* RVVRADAR_RVV_SUPPORT */
+
+static int impls_add(alg_t *alg)
+{
+	int ret = 0;
+
+#if RVVRADAR_RVV_SUPPORT
+	ret |= impl_add(alg, "scalar add chain",	&req_rv, (uarch_fp_t)uarch_rv_add_chain);
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+#define UARCH_RVV_ADD(_insn_, _lmul_) \
+	if (d->insn == uarch_##_insn_ && d->lmul == _lmul_) { \
+		ret |= impl_add(alg, "rvv latency",	&req_rvv, (uarch_fp_t)RVV_SELECT(uarch_##_insn_##_m##_lmul_##_lat)); \
+		ret |= impl_add(alg, "rvv throughput",	&req_rvv, (uarch_fp_t)RVV_SELECT(uarch_##_insn_##_m##_lmul_##_tput)); \
+	}
+	UARCH_FOREACH(UARCH_RVV_ADD)
+#endif /* RVVRADAR_RVV_SUPPORT */
+
+	if (ret)
+		return -1;
+
+	return 0;
+}
+
+
+static int alg_preexec(struct alg *alg, int seed)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	size_t size = UARCH_BUF_SIZE(sysinfo_get_vlen());
+
+	/* alloc (zeroed -> dependent loads stay on the same address) */
+	d->buf = alg_alloc(alg, size ? size : 1);
+	if (d->buf == NULL)
+		return -1;
+	memset(d->buf, 0, size);
+
+	return 0;
+}
+
+
+static int alg_postexec(struct alg *alg)
+{
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+
+	free(d->buf);
+
+	return 0;
+}
+
+
+/* parameters */
+
+static const char * const insn_names[] = {
+	"vsetvli", "vlmul", "vle", "vlse", "vlseg", "vwmacc", "vmerge", "vmsltu", NULL
+};
+static const unsigned int insn_defaults[] = {
+	uarch_vsetvli, uarch_vlmul, uarch_vle, uarch_vlse,
+	uarch_vlseg, uarch_vwmacc, uarch_vmerge, uarch_vmsltu
+};
+
+static const unsigned int lmul_allowed[] = { 1, 2, 4, 8 };
+static const unsigned int lmul_defaults[] = { 1, 2, 4, 8 };
+
+static const param_desc_t params[] = {
+	{
+		.name = "insn",
+		.type = PARAM_TYPE_ENUM,
+		.enum_names = insn_names,
+		.defaults = PARAM_VALUES(insn_defaults),
+	},
+	{
+		.name = "lmul",
+		.type = PARAM_TYPE_UINT,
+		.allowed = PARAM_VALUES(lmul_allowed),
+		.defaults = PARAM_VALUES(lmul_defaults),
+	},
+};
+
+
+int alg_uarch_add(
+	algset_t *algset,
+	enum alg_uarch_insn insn,
+	unsigned int lmul,
+	unsigned int len)
+{
+	/* check parameters */
+	if (insn > uarch_vmsltu) {
+		errno = EINVAL;
+		return -1;
+	}
+	int i;
+	for (i = 0; i < sizeof(lmul_allowed) / sizeof(lmul_allowed[0]); i++)
+		if (lmul_allowed[i] == lmul)
+			break;
+	if (i == sizeof(lmul_allowed) / sizeof(lmul_allowed[0])) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/*
+	 * without rvv only the reference would be measured (under the names
+	 * of vector instruction classes) -> nothing to add
+	 */
+	if (!(sysinfo_get_isa() & SYSINFO_ISA_RVV))
+		return 0;
+
+	/* build name string */
+	char namestr[256] = "\0";
+	snprintf(namestr, 256, "uarch_%s_m%u", insn_names[insn], lmul);
+
+	/* build parameter string */
+	char parastr[256] = "\0";
+	unsigned int values[] = { insn, lmul };
+	if (alg_desc_parastr(&alg_uarch_desc, len, values, parastr, 256) < 0)
+		return -1;
+
+	/*
+	 * len is padded to a multiple of UARCH_UNROLL (see req_*) when the
+	 * algorithm is added to the set
+	 */
+
+	/* create algorithm */
+	alg_t *alg = alg_create(
+			     namestr,
+			     parastr,
+			     len,
+			     alg_preexec,
+			     alg_postexec,
+			     sizeof(struct data));
+	if (alg == NULL)
+		return -1;
+
+	/* set private data */
+	struct data *d = ALG_GET_PRIV_DATA(struct data*, alg);
+	d->insn = insn;
+	d->lmul = lmul;
+
+	/* add implementations */
+	if (impls_add(alg) < 0) {
+		alg_destroy(alg);
+		return -1;
+	}
+
+	/* add algorithm to set */
+	if (algset_add_alg(algset, alg) < 0) {
+		alg_destroy(alg);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static int alg_uarch_desc_add(algset_t *algset, unsigned int len, const unsigned int *values)
+{
+	return alg_uarch_add(algset, values[0], values[1], len);
+}
+
+
+const alg_desc_t alg_uarch_desc = {
+	.name = "uarch",
+	.description = "latency/throughput of vector instruction classes",
+	.params = params,
+	.nparams = sizeof(params) / sizeof(params[0]),
+	.add = alg_uarch_desc_add,
+};
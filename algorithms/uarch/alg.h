@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef ALG_UARCH_H
+#define ALG_UARCH_H
+
+#include <core/algset.h>
+
+/* instruction classes */
+enum alg_uarch_insn {
+	uarch_vsetvli,		// vsetvli (same LMUL)
+	uarch_vlmul,		// vsetvli changing LMUL (m1 <-> m<lmul>)
+	uarch_vle,		// unit-stride load
+	uarch_vlse,		// strided load
+	uarch_vlseg,		// segmented load (three fields)
+	uarch_vwmacc,		// widening multiply-accumulate
+	uarch_vmerge,		// merge under mask
+	uarch_vmsltu		// compare to mask
+};
+
+/*
+ * descriptor (parameters: insn, lmul)
+ */
+extern const alg_desc_t alg_uarch_desc;
+
+/*
+ * add a microbenchmark of a vector instruction class (name
+ * uarch_<insn>_m<lmul>; nothing is added if the cpu has no rvv)
+ * algset .. set to add to
+ * insn .. instruction class (see above)
+ * lmul .. register grouping (1, 2, 4 or 8)
+ * len .. number of measured instructions (padded to a multiple of 8)
+ */
+int alg_uarch_add(
+	algset_t *algset,
+	enum alg_uarch_insn insn,
+	unsigned int lmul,
+	unsigned int len);
+
+#endif /* ALG_UARCH_H */
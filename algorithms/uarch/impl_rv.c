@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+
+#if RVVRADAR_RV_SUPPORT
+
+/*
+ * reference: chain of 8 dependent integer adds per iteration
+ * (1 cycle each on all known cores -> time of one cycle; see alg.c)
+ */
+void uarch_rv_add_chain(unsigned int n, uint8_t *buf)
+{
+	unsigned long acc = 0;
+
+	for (; n > 0; n--)
+		asm volatile (
+			".rept 8\n"
+			"add		%0, %0, %1\n"
+			".endr\n"
+			: "+r" (acc)
+			: "r" ((unsigned long)n));
+}
+
+#endif /* RVVRADAR_RV_SUPPORT */
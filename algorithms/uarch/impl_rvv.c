@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+
+#include <core/rvv_helpers.h>
+
+
+#if RVVRADAR_RVV_SUPPORT
+
+/*
+ * Microbenchmarks of vector instruction classes
+ * Each kernel executes n iterations of 8 measured instructions:
+ *   lat  .. dependent chain (each instruction reads the result of the
+ *           previous one) -> latency
+ *   tput .. independent instructions (destinations cycle through the
+ *           register groups given by .irp) -> reciprocal throughput
+ * Operands of the asm bodies:
+ *   %[vl] .. vl (VLMAX of e8 and the LMUL of the kernel)
+ *   %[p]  .. zeroed buffer of UARCH_BUF_SIZE (see alg.c)
+ *   %[s]  .. stride of strided loads
+ * Sources are v1, v2, v4 or v8 (aligned to LMUL; not overlapping the
+ * destinations starting at v8); v0 is the mask of vmerge.
+ * The next address of the load latency chains depends on the loaded data
+ * via vse8 and lbu: moves from vector to scalar registers (vext.x.v of
+ * v0.7, vmv.x.s of v0.8) differ in their encoding, and the drafts can not
+ * be told apart (see RVV_SELECT).
+ * Combinations not fitting into the vector registers (widening m8,
+ * segments m4 and m8) are not defined -> not registered.
+ */
+
+/* stride of strided loads [bytes] */
+#define UARCH_STRIDE		3
+
+#define UARCH_KERNEL(_name_, _lmul_, _body_) \
+void RVV_SYM(_name_)(unsigned int n, uint8_t *buf) \
+{ \
+	unsigned long vl; \
+	uint8_t *p = buf; \
+	asm volatile ("vsetvli		%0, zero, e8, m" #_lmul_ : "=r" (vl)); \
+	for (; n > 0; n--) \
+		asm volatile (_body_ \
+			      : [p] "+r" (p), [vl] "+r" (vl) \
+			      : [s] "r" (UARCH_STRIDE) \
+			      : "t0", "memory"); \
+}
+
+/* destination groups of independent instructions (8 per iteration) */
+#define UARCH_D_1		"8,9,10,11,12,13,14,15"
+#define UARCH_D_2		"8,10,12,14,16,18,20,22"
+#define UARCH_D_4		"8,12,16,20,24,28,8,12"
+#define UARCH_D_8		"16,24,16,24,16,24,16,24"
+/* widening (EMUL = 2 * LMUL) */
+#define UARCH_W_1		"8,10,12,14,16,18,20,22"
+#define UARCH_W_2		"8,12,16,20,24,28,8,12"
+#define UARCH_W_4		"8,16,24,8,16,24,8,16"
+/* segments of three fields (3 * LMUL registers) */
+#define UARCH_G_1		"8,11,14,17,20,23,26,8"
+#define UARCH_G_2		"8,14,20,26,8,14,20,26"
+
+/* sources (aligned to LMUL) */
+#define UARCH_S_1		"v1"
+#define UARCH_S_2		"v2"
+#define UARCH_S_4		"v4"
+#define UARCH_S_8		"v8"
+
+
+/* kernels available for all LMUL */
+#define UARCH_KERNELS(_L_) \
+	/* vsetvli: vl of next depends on vl of previous */ \
+	UARCH_KERNEL(uarch_vsetvli_m##_L_##_lat, _L_, \
+		".rept 8\n" \
+		"vsetvli	%[vl], %[vl], e8, m" #_L_ "\n" \
+		".endr\n") \
+	UARCH_KERNEL(uarch_vsetvli_m##_L_##_tput, _L_, \
+		".rept 8\n" \
+		"vsetvli	zero, %[vl], e8, m" #_L_ "\n" \
+		".endr\n") \
+	/* change of LMUL: alternating m1 and m<L> */ \
+	UARCH_KERNEL(uarch_vlmul_m##_L_##_lat, _L_, \
+		".rept 4\n" \
+		"vsetvli	%[vl], %[vl], e8, m1\n" \
+		"vsetvli	%[vl], %[vl], e8, m" #_L_ "\n" \
+		".endr\n") \
+	UARCH_KERNEL(uarch_vlmul_m##_L_##_tput, _L_, \
+		".rept 4\n" \
+		"vsetvli	zero, %[vl], e8, m1\n" \
+		"vsetvli	zero, %[vl], e8, m" #_L_ "\n" \
+		".endr\n") \
+	/* unit-stride load */ \
+	UARCH_KERNEL(uarch_vle_m##_L_##_lat, _L_, \
+		".rept 8\n" \
+		VLE8_V "	v8, (%[p])\n" \
+		VSE8_V "	v8, (%[p])\n" \
+		"lbu		t0, 0(%[p])\n" \
+		"add		%[p], %[p], t0\n" \
+		".endr\n") \
+	UARCH_KERNEL(uarch_vle_m##_L_##_tput, _L_, \
+		".irp d, " UARCH_D_##_L_ "\n" \
+		VLE8_V "	v\\d, (%[p])\n" \
+		".endr\n") \
+	/* strided load */ \
+	UARCH_KERNEL(uarch_vlse_m##_L_##_lat, _L_, \
+		".rept 8\n" \
+		VLSE8_V "	v8, (%[p]), %[s]\n" \
+		VSE8_V "	v8, (%[p])\n" \
+		"lbu		t0, 0(%[p])\n" \
+		"add		%[p], %[p], t0\n" \
+		".endr\n") \
+	UARCH_KERNEL(uarch_vlse_m##_L_##_tput, _L_, \
+		".irp d, " UARCH_D_##_L_ "\n" \
+		VLSE8_V "	v\\d, (%[p]), %[s]\n" \
+		".endr\n") \
+	/* merge: v8 = v0 ? src : v8 */ \
+	UARCH_KERNEL(uarch_vmerge_m##_L_##_lat, _L_, \
+		".rept 8\n" \
+		"vmerge.vvm	v8, v8, " UARCH_S_##_L_ ", v0\n" \
+		".endr\n") \
+	UARCH_KERNEL(uarch_vmerge_m##_L_##_tput, _L_, \
+		".irp d, " UARCH_D_##_L_ "\n" \
+		"vmerge.vvm	v\\d, " UARCH_S_##_L_ ", " UARCH_S_##_L_ ", v0\n" \
+		".endr\n") \
+	/* compare to mask: mask of previous is source of next */ \
+	UARCH_KERNEL(uarch_vmsltu_m##_L_##_lat, _L_, \
+		".rept 8\n" \
+		"vmsltu.vv	v8, v8, " UARCH_S_##_L_ "\n" \
+		".endr\n") \
+	UARCH_KERNEL(uarch_vmsltu_m##_L_##_tput, _L_, \
+		".irp d, " UARCH_D_##_L_ "\n" \
+		"vmsltu.vv	v\\d, " UARCH_S_##_L_ ", " UARCH_S_##_L_ "\n" \
+		".endr\n")
+
+/* widening multiply-accumulate (not for m8) */
+#define UARCH_KERNELS_WIDEN(_L_) \
+	UARCH_KERNEL(uarch_vwmacc_m##_L_##_lat, _L_, \
+		".rept 8\n" \
+		"vwmaccu.vv	v8, " UARCH_S_##_L_ ", " UARCH_S_##_L_ "\n" \
+		".endr\n") \
+	UARCH_KERNEL(uarch_vwmacc_m##_L_##_tput, _L_, \
+		".irp d, " UARCH_W_##_L_ "\n" \
+		"vwmaccu.vv	v\\d, " UARCH_S_##_L_ ", " UARCH_S_##_L_ "\n" \
+		".endr\n")
+
+/* segmented load of three fields (m1 and m2 only) */
+#define UARCH_KERNELS_SEGMENT(_L_) \
+	UARCH_KERNEL(uarch_vlseg_m##_L_##_lat, _L_, \
+		".rept 8\n" \
+		VLSEG3E8_V "	v8, (%[p])\n" \
+		VSE8_V "	v8, (%[p])\n" \
+		"lbu		t0, 0(%[p])\n" \
+		"add		%[p], %[p], t0\n" \
+		".endr\n") \
+	UARCH_KERNEL(uarch_vlseg_m##_L_##_tput, _L_, \
+		".irp d, " UARCH_G_##_L_ "\n" \
+		VLSEG3E8_V "	v\\d, (%[p])\n" \
+		".endr\n")
+
+
+UARCH_KERNELS(1)
+UARCH_KERNELS(2)
+UARCH_KERNELS(4)
+UARCH_KERNELS(8)
+
+UARCH_KERNELS_WIDEN(1)
+UARCH_KERNELS_WIDEN(2)
+UARCH_KERNELS_WIDEN(4)
+
+UARCH_KERNELS_SEGMENT(1)
+UARCH_KERNELS_SEGMENT(2)
+
+#endif /* RVVRADAR_RVV_SUPPORT */
@@ -7,7 +7,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
+#include <inttypes.h>
 
+#include <core/sysinfo.h>
+#include <core/json.h>
+#include <core/isolate.h>
 #include <core/algset.h>
 
 
@@ -18,6 +23,12 @@
 #define DATAOUT	stdout
 #define INFOOUT	stderr
 
+/* minimum alignment of buffers (same as malloc on 64bit glibc) */
+#define ALG_MIN_ALIGN		16
+
+/* minimum interval of progress updates */
+#define PROGRESS_INTERVAL_NS	250000000LL
+
 /* print to stderr if verbose == true */
 #define pinfo(args...)				\
 	do {					\
@@ -59,6 +70,7 @@ static impl_t *impl_create(
 	impl->exec = exec;
 	impl->postexec = postexec;
 	impl->cleanup = cleanup;
+	impl->raw_index = -1;
 
 	/* alloc optional private data area */
 	if (priv_data_len == 0)
@@ -97,8 +109,15 @@ static void impl_reset(impl_t *impl)
 
 	impl->runs = 0;
 	impl->fails = 0;
+	impl->cached = false;
+	impl->raw_index = -1;
+	impl->signal = 0;
+	impl->timeout = false;
+	memset(&impl->icount, 0, sizeof(impl->icount));
 
-	chrono_init(&impl->chrono);
+	/* measurements are allocated on run (see impl_run_iterations) */
+	chrono_cleanup(&impl->chrono);
+	chrono_init(&impl->chrono, 0);
 }
 
 
@@ -180,12 +199,17 @@ static int impl_call_cleanup(impl_t *impl)
 
 static int impl_run(impl_t *impl, int iteration, bool verify)
 {
+	icount_counts_t counts;
+	icount_t *icount;
+	profile_t *profile;
 	int ret = 0;
 
 	if (impl == NULL) {
 		errno = EINVAL;
 		return -1;
 	}
+	icount = impl->alg->algset->icount;
+	profile = impl->alg->algset->profile;
 
 	impl->runs++;
 
@@ -193,12 +217,28 @@ static int impl_run(impl_t *impl, int iteration, bool verify)
 	if (ret < 0)
 		goto __err;
 
-	/* exec and measure */
+	/*
+	 * exec and measure (instructions counted between markers; sampled
+	 * outside of the measurement -> enabling and reading samples is not
+	 * measured)
+	 */
+	if (profile != NULL && profile_start(profile) < 0)
+		goto __err;
 	chrono_start(&impl->chrono);
+	icount_start();
 	ret = impl_call_exec(impl, verify);
+	icount_stop();
 	if (ret < 0)
 		goto __err;
 	chrono_stop(&impl->chrono);
+	if (profile != NULL && profile_stop(profile) < 0)
+		goto __err;
+
+	if (icount != NULL) {
+		if (icount_read(icount, &counts) < 0)
+			goto __err;
+		icount_add(&impl->icount, &counts);
+	}
 
 	ret = impl_call_postexec(impl, verify);
 	if (ret)
@@ -216,6 +256,33 @@ __ret:
 }
 
 
+/* instruction counts per measured run (see icount.h) */
+static void impl_icount_per_run(impl_t *impl, icount_counts_t *counts)
+{
+	unsigned int n = impl->chrono.nmeasure;
+
+	memset(counts, 0, sizeof(*counts));
+	if (n == 0)
+		return;
+
+	counts->scalar = impl->icount.scalar / n;
+	counts->vconfig = impl->icount.vconfig / n;
+	counts->vmem = impl->icount.vmem / n;
+	counts->varith = impl->icount.varith / n;
+}
+
+
+/* status of implementation run (ok, terminating signal or timeout) */
+static const char *impl_status_str(impl_t *impl)
+{
+	if (impl->timeout)
+		return "timeout";
+	if (impl->signal != 0)
+		return isolate_signal_str(impl->signal);
+	return "ok";
+}
+
+
 static int impl_print_pretty(impl_t *impl, FILE *out)
 {
 	if (impl == NULL || out == NULL) {
@@ -226,22 +293,37 @@ static int impl_print_pretty(impl_t *impl, FILE *out)
 	fprintf(out, "     + implementation: %s\n", impl->name);
 	fprintf(out, "       + runs:  %i\n", impl->runs);
 	fprintf(out, "       + fails: %i\n", impl->fails);
+	if (impl->signal != 0)
+		fprintf(out, "       + status: %s\n", impl_status_str(impl));
 	fprintf(out, "       + timing:\n");
 	chrono_print_pretty(&impl->chrono, "         + ", out);
+	if (impl->alg->algset->icount != NULL) {
+		icount_counts_t counts;
+		impl_icount_per_run(impl, &counts);
+		fprintf(out, "       + instructions per run:\n");
+		fprintf(out, "         + scalar:              %" PRIu64 "\n", counts.scalar);
+		fprintf(out, "         + vector config:       %" PRIu64 "\n", counts.vconfig);
+		fprintf(out, "         + vector load/store:   %" PRIu64 "\n", counts.vmem);
+		fprintf(out, "         + vector arithmetic:   %" PRIu64 "\n", counts.varith);
+	}
 	return 0;
 }
 
 
-static int impl_print_csv_head(FILE *out)
+/* icount .. instruction counts enabled (additional columns) */
+static int impl_print_csv_head(FILE *out, bool icount)
 {
 	if (out == NULL) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	printf("set;algorithm(parameters);implementation;runs;fails;");
-	chrono_print_csv_head(DATAOUT);
-	printf("\n");
+	fprintf(out, "set;algorithm(parameters);implementation;runs;fails;");
+	chrono_print_csv_head(out);
+	fprintf(out, ";status;len_schedule");
+	if (icount)
+		fprintf(out, ";icount_scalar;icount_vconfig;icount_vmem;icount_varith");
+	fprintf(out, "\n");
 	return 0;
 }
 
@@ -253,52 +335,469 @@ static int impl_print_csv(impl_t *impl, FILE *out)
 		return -1;
 	}
 
-	printf("%s;%s(%s);%s;%i;%i;",
-	       impl->alg->algset->name,
-	       impl->alg->name,
-	       impl->alg->parastr,
-	       impl->name,
-	       impl->runs,
-	       impl->fails);
+	fprintf(out, "%s;%s(%s);%s;%i;%i;",
+		impl->alg->algset->name,
+		impl->alg->name,
+		impl->alg->parastr,
+		impl->name,
+		impl->runs,
+		impl->fails);
 	chrono_print_csv(&impl->chrono, out);
-	printf("\n");
+	fprintf(out, ";%s;%s", impl_status_str(impl),
+		impl->alg->algset->len_schedule ? impl->alg->algset->len_schedule : "");
+	if (impl->alg->algset->icount != NULL) {
+		icount_counts_t counts;
+		impl_icount_per_run(impl, &counts);
+		fprintf(out, ";%" PRIu64 ";%" PRIu64 ";%" PRIu64 ";%" PRIu64,
+			counts.scalar, counts.vconfig, counts.vmem, counts.varith);
+	}
+	fprintf(out, "\n");
 	return 0;
 }
 
 
-static int impl_run_iterations(impl_t *impl, int iterations, bool verify, bool verbose)
+static int impl_print_jsonl(impl_t *impl, FILE *out)
 {
-	if (impl == NULL) {
+	if (impl == NULL || out == NULL) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	for (int iteration = 0; iteration < iterations; iteration++) {
-		pinfo("\r%s: %i/%i -> ", impl->name, iteration + 1, iterations);
-		int ret = impl_run(impl, iteration, verify);
-		if (ret < 0)
-			return -1;
-		else if (ret > 0) {
-			/* data error */
-			pinfo("FAIL!");
-			continue;
-		}
-		pinfo("OK!");
+	fprintf(out, "{\"type\":\"impl\",");
+	json_print_kv_str(out, "set", impl->alg->algset->name);
+	fprintf(out, ",");
+	json_print_kv_str(out, "algorithm", impl->alg->name);
+	fprintf(out, ",\"parameters\":");
+	json_print_parastr(out, impl->alg->parastr);
+	fprintf(out, ",");
+	json_print_kv_str(out, "implementation", impl->name);
+	fprintf(out, ",\"runs\":%u,\"fails\":%u,\"status\":\"%s\",\"cached\":%s,",
+		impl->runs,
+		impl->fails,
+		impl_status_str(impl),
+		impl->cached ? "true" : "false");
+	chrono_print_json(&impl->chrono, out);
+	if (impl->alg->algset->icount != NULL) {
+		icount_counts_t counts;
+		impl_icount_per_run(impl, &counts);
+		fprintf(out, ",\"icount\":{\"scalar\":%" PRIu64 ",\"vconfig\":%" PRIu64
+			",\"vmem\":%" PRIu64 ",\"varith\":%" PRIu64 "}",
+			counts.scalar, counts.vconfig, counts.vmem, counts.varith);
+	}
+	if (impl->raw_index >= 0)
+		fprintf(out, ",\"raw_index\":%li", impl->raw_index);
+	fprintf(out, "}\n");
+	return 0;
+}
+
+
+/* write single measurements to raw samples file */
+static int impl_write_raw(impl_t *impl)
+{
+	algset_t *algset = impl->alg->algset;
+	char *key = NULL;
+
+	if (algset->rawfile == NULL || impl->cached)
+		return 0;
+
+	if (asprintf(&key, "%s;%s(%s);%s",
+		     algset->name,
+		     impl->alg->name,
+		     impl->alg->parastr,
+		     impl->name) < 0)
+		return -1;
+
+	impl->raw_index = rawfile_add(algset->rawfile, key,
+				      impl->chrono.tdlist, impl->chrono.tslist,
+				      impl->chrono.nmeasure);
+	free(key);
+
+	return impl->raw_index < 0 ? -1 : 0;
+}
+
+
+/* write hot spots of implementation to profile report */
+static int impl_write_profile(impl_t *impl)
+{
+	algset_t *algset = impl->alg->algset;
+	char *key = NULL;
+
+	if (algset->profile == NULL)
+		return 0;
+
+	if (asprintf(&key, "%s;%s(%s);%s",
+		     algset->name,
+		     impl->alg->name,
+		     impl->alg->parastr,
+		     impl->name) < 0)
+		return -1;
+
+	int ret = profile_report(algset->profile, key);
+	free(key);
+
+	return ret;
+}
+
+
+/* report skipped implementation (human readable and jsonl) */
+static int impl_report_skipped(impl_t *impl, bool verbose)
+{
+	algset_t *algset = impl->alg->algset;
+
+	if (verbose)
+		fprintf(algset->infobuf,
+			"     + implementation: %s\n"
+			"       + skipped: %s\n",
+			impl->name, impl->skip);
+
+	/* csv has no row for skipped implementations */
+	if (algset->format != ALGSET_FORMAT_JSONL)
+		return 0;
+
+	FILE *out = algset->databuf;
+	fprintf(out, "{\"type\":\"skip\",");
+	json_print_kv_str(out, "set", algset->name);
+	fprintf(out, ",");
+	json_print_kv_str(out, "algorithm", impl->alg->name);
+	fprintf(out, ",\"parameters\":");
+	json_print_parastr(out, impl->alg->parastr);
+	fprintf(out, ",");
+	json_print_kv_str(out, "implementation", impl->name);
+	fprintf(out, ",");
+	json_print_kv_str(out, "reason", impl->skip);
+	fprintf(out, "}\n");
+	return 0;
+}
+
+
+/*
+ * report results of implementation
+ * (raw samples, human readable and data output, cost model)
+ */
+static int impl_report(impl_t *impl, bool verbose)
+{
+	algset_t *algset = impl->alg->algset;
+	costmodel_t *costmodel = algset->costmodel;
+
+	if (impl_write_raw(impl) < 0)
+		return -1;
+	if (impl_write_profile(impl) < 0)
+		return -1;
+
+	/* buffered until end of algorithm (see alg_run) */
+	if (verbose)
+		impl_print_pretty(impl, algset->infobuf);
+
+	/* data output */
+	switch (algset->format) {
+	case ALGSET_FORMAT_JSONL:
+		impl_print_jsonl(impl, algset->databuf);
+		break;
+	case ALGSET_FORMAT_CSV:
+	default:
+		impl_print_csv(impl, algset->databuf);
+		break;
 	}
+
+	/* failed results are failures of the regression gate (see compare.h) */
+	if (algset->compare != NULL)
+		if (compare_add(algset->compare,
+				algset->name,
+				impl->alg->name,
+				impl->alg->parastr,
+				impl->name,
+				impl->fails,
+				impl->chrono.nmeasure,
+				impl->chrono.tdmedian,
+				impl->chrono.tdstdev) < 0)
+			return -1;
+
+	/* only error free results are useful for modeling */
+	if (impl->fails > 0)
+		return 0;
+
+	if (costmodel != NULL)
+		if (costmodel_add(costmodel,
+				  algset->name,
+				  impl->alg->name,
+				  impl->name,
+				  impl->alg->len,
+				  impl->chrono.tdmedian) < 0)
+			return -1;
+
+	return 0;
+}
+
+
+/*
+ * restore results of implementation from the results cache
+ * return: 1 .. restored; 0 .. not cached; <0 .. error
+ */
+static int impl_restore_cached(impl_t *impl)
+{
+	algset_t *algset = impl->alg->algset;
+	char *rowkey = NULL;
+
+	if (algset->rescache == NULL)
+		return 0;
+
+	if (asprintf(&rowkey, "%s;%s(%s);%s",
+		     algset->name,
+		     impl->alg->name,
+		     impl->alg->parastr,
+		     impl->name) < 0)
+		return -1;
+
+	const char *fields = rescache_lookup(algset->rescache, algset->runcfg, rowkey);
+	free(rowkey);
+	if (fields == NULL)
+		return 0;
+
+	int pos = 0;
+	if (sscanf(fields, "%u;%u;%n", &impl->runs, &impl->fails, &pos) != 2 || pos == 0)
+		return 0;
+	if (chrono_restore_csv(&impl->chrono, fields + pos) < 0)
+		/* broken entry -> measure again */
+		return 0;
+
+	impl->cached = true;
+	return 1;
+}
+
+
+/* store results of implementation to the results cache */
+static int impl_store_cached(impl_t *impl)
+{
+	algset_t *algset = impl->alg->algset;
+	char *row = NULL;
+	size_t row_len = 0;
+
+	/* crashes and timeouts are not reproducible results */
+	if (algset->rescache == NULL || impl->signal != 0)
+		return 0;
+
+	FILE *out = open_memstream(&row, &row_len);
+	if (out == NULL)
+		return -1;
+	impl_print_csv(impl, out);
+	fclose(out);
+
+	row[strcspn(row, "\n")] = '\0';
+	int ret = rescache_store(algset->rescache, algset->runcfg, row);
+	free(row);
+
+	return ret;
+}
+
+
+/* nanoseconds since given time */
+static long long progress_elapsed(const struct timespec *since)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - since->tv_sec) * 1000000000LL + (now.tv_nsec - since->tv_nsec);
+}
+
+
+/*
+ * print progress (rate limited by PROGRESS_INTERVAL_NS)
+ * force .. print independent of interval
+ */
+static void impl_progress(impl_t *impl, int iteration, int iterations,
+			  struct timespec *last, bool force, bool verbose)
+{
+	if (!verbose)
+		return;
+	if (!force && progress_elapsed(last) < PROGRESS_INTERVAL_NS)
+		return;
+
+	fprintf(INFOOUT, "\r%s: %i/%i", impl->name, iteration, iterations);
+	if (impl->fails > 0)
+		fprintf(INFOOUT, " -> %u FAILED!", impl->fails);
+	fflush(INFOOUT);
+	clock_gettime(CLOCK_MONOTONIC, last);
+}
+
+
+/* clear progress line */
+static void impl_progress_clear(bool verbose)
+{
 	pinfo("\r");
 	for (int i = 0; i < 10; i++)
 		pinfo("          ");
 	pinfo("\r");
-	if (verbose)
-		impl_print_pretty(impl, INFOOUT);
+}
 
-	/* data output */
-	impl_print_csv(impl, DATAOUT);
 
+/*
+ * shared memory of isolated implementation run (see impl_run_isolated)
+ * counters are updated by the child after each iteration -> valid up to
+ * a crash
+ */
+typedef struct impl_isolate_shm {
+	unsigned int runs;
+	unsigned int fails;
+	unsigned int nmeasure;
+	int err;				// errno of child on error
+	icount_counts_t icount;			// instruction counts (see icount.h)
+	long long samples[];			// durations [iterations], timestamps [iterations]
+} impl_isolate_shm_t;
+
+
+typedef struct impl_isolate_arg {
+	impl_t *impl;
+	int iterations;
+	bool verify;
+	bool verbose;
+} impl_isolate_arg_t;
+
+
+/*
+ * init, run all iterations and cleanup implementation
+ * shm .. shared memory to update (isolated run; NULL .. none)
+ */
+static int impl_run_all(impl_t *impl, int iterations, bool verify, bool verbose,
+			impl_isolate_shm_t *shm)
+{
+	struct timespec last;
+
+	if (impl_call_init(impl) < 0)
+		return -1;
+
+	/*
+	 * progress is only updated on interval -> as little interference
+	 * (syscalls, caches) as possible between measurements
+	 */
+	impl_progress(impl, 0, iterations, &last, true, verbose);
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		/* a crash during this run is counted as failed run */
+		if (shm != NULL) {
+			shm->runs = impl->runs + 1;
+			shm->fails = impl->fails + 1;
+		}
+
+		/* data errors are counted in fails */
+		if (impl_run(impl, iteration, verify) < 0)
+			return -1;
+
+		if (shm != NULL) {
+			unsigned int n = impl->chrono.nmeasure;
+			if (n > shm->nmeasure) {
+				shm->samples[n - 1] = impl->chrono.tdlist[n - 1];
+				shm->samples[iterations + n - 1] = impl->chrono.tslist[n - 1];
+				shm->nmeasure = n;
+			}
+			shm->runs = impl->runs;
+			shm->fails = impl->fails;
+			shm->icount = impl->icount;
+		}
+
+		impl_progress(impl, iteration + 1, iterations, &last, false, verbose);
+	}
+	impl_progress_clear(verbose);
+
+	return impl_call_cleanup(impl);
+}
+
+
+/* entry of child process of isolated run */
+static int impl_isolate_child(void *shm, void *arg)
+{
+	impl_isolate_shm_t *ishm = shm;
+	impl_isolate_arg_t *iarg = arg;
+
+	if (impl_run_all(iarg->impl, iarg->iterations, iarg->verify, iarg->verbose, ishm) < 0) {
+		ishm->err = errno;
+		return 1;
+	}
 	return 0;
 }
 
 
+/*
+ * run implementation isolated in a child process
+ * (see isolate.h; crashes and timeouts are reported as fails with signal)
+ */
+static int impl_run_isolated(impl_t *impl, int iterations, bool verify, bool verbose)
+{
+	algset_t *algset = impl->alg->algset;
+	impl_isolate_arg_t arg = {
+		.impl = impl,
+		.iterations = iterations,
+		.verify = verify,
+		.verbose = verbose,
+	};
+	isolate_status_t status;
+	int ret = -1;
+
+	size_t shm_len = sizeof(impl_isolate_shm_t) + 2 * iterations * sizeof(long long);
+	impl_isolate_shm_t *shm = isolate_shm_alloc(shm_len);
+	if (shm == NULL)
+		return -1;
+
+	if (isolate_run(impl_isolate_child, shm, &arg, algset->timeout, &status) < 0)
+		goto __ret;
+
+	if (status.signal == 0 && status.exit_code != 0) {
+		/* error in child (not a crash) */
+		errno = shm->err ? shm->err : EIO;
+		goto __ret;
+	}
+
+	/* transfer results */
+	impl->runs = shm->runs;
+	impl->fails = shm->fails;
+	impl->icount = shm->icount;
+	for (unsigned int i = 0; i < shm->nmeasure; i++)
+		if (chrono_add(&impl->chrono, shm->samples[i], shm->samples[iterations + i]) < 0)
+			goto __ret;
+
+	if (status.signal != 0) {
+		impl->signal = status.signal;
+		impl->timeout = status.timeout;
+		/* crash outside of runs (init, cleanup) */
+		if (impl->fails == 0)
+			impl->fails = 1;
+		impl_progress_clear(verbose);
+	}
+
+	ret = 0;
+
+__ret:
+	isolate_shm_free(shm, shm_len);
+	return ret;
+}
+
+
+/* measure implementation and report results */
+static int impl_run_iterations(impl_t *impl, int iterations, bool verify, bool verbose)
+{
+	int ret;
+
+	if (impl == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* space for measurements of all iterations */
+	chrono_cleanup(&impl->chrono);
+	if (chrono_init(&impl->chrono, iterations) < 0)
+		return -1;
+
+	if (impl->alg->algset->isolate)
+		ret = impl_run_isolated(impl, iterations, verify, verbose);
+	else
+		ret = impl_run_all(impl, iterations, verify, verbose, NULL);
+	if (ret < 0)
+		return -1;
+
+	if (impl_store_cached(impl) < 0)
+		return -1;
+
+	return impl_report(impl, verbose);
+}
+
+
 /*
  * ALGORITHM
  */
@@ -306,6 +805,7 @@ static int impl_run_iterations(impl_t *impl, int iterations, bool verify, bool v
 alg_t *alg_create(
 	const char *name,
 	const char *parastr,
+	unsigned int len,
 	alg_preexec_fp_t preexec,
 	alg_postexec_fp_t postexec,
 	unsigned int priv_data_len)
@@ -332,6 +832,8 @@ alg_t *alg_create(
 		free(alg);
 		return NULL;
 	}
+	alg->len = len;
+	alg->align = ALG_MIN_ALIGN;
 	alg->preexec = preexec;
 	alg->postexec = postexec;
 
@@ -350,6 +852,31 @@ alg_t *alg_create(
 }
 
 
+int alg_desc_parastr(
+	const alg_desc_t *desc,
+	unsigned int len,
+	const unsigned int *values,
+	char *buf,
+	size_t size)
+{
+	if (desc == NULL || buf == NULL || (desc->nparams > 0 && values == NULL)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	int pos = snprintf(buf, size, "len=%u", len);
+	for (int i = 0; i < desc->nparams; i++) {
+		char valstr[32];
+		if (param_format_value(&desc->params[i], values[i], valstr, sizeof(valstr)) < 0)
+			return -1;
+		pos += snprintf(buf + pos, pos < size ? size - pos : 0,
+				",%s=%s", desc->params[i].name, valstr);
+	}
+
+	return pos;
+}
+
+
 void alg_destroy(alg_t *alg)
 {
 	if (alg == NULL)
@@ -371,9 +898,25 @@ void alg_destroy(alg_t *alg)
 }
 
 
+void *alg_alloc(alg_t *alg, size_t size)
+{
+	if (alg == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	size = (size + alg->align - 1) / alg->align * alg->align;
+	if (size == 0)
+		size = alg->align;
+
+	return aligned_alloc(alg->align, size);
+}
+
+
 impl_t *alg_add_impl(
 	alg_t *alg,
 	const char *name,
+	const impl_req_t *req,
 	impl_init_fp_t init,
 	impl_preexec_fp_t preexec,
 	impl_exec_fp_t exec,
@@ -387,6 +930,8 @@ impl_t *alg_add_impl(
 			       priv_data_len);
 	if (impl == NULL)
 		return NULL;
+	if (req != NULL)
+		impl->req = *req;
 
 	/* add to link list */
 	impl->index = alg->impls_len;
@@ -405,6 +950,76 @@ impl_t *alg_add_impl(
 }
 
 
+static unsigned int gcd(unsigned int a, unsigned int b)
+{
+	while (b != 0) {
+		unsigned int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+
+/* check requirements of implementation on running cpu and algorithm */
+static void impl_check_req(impl_t *impl, unsigned int isa, unsigned int vlen)
+{
+	impl_req_t *req = &impl->req;
+	char buf[32];
+
+	impl->skip[0] = '\0';
+	if ((req->isa & isa) != req->isa) {
+		sysinfo_get_isa_str(req->isa & ~isa, buf, sizeof(buf));
+		snprintf(impl->skip, sizeof(impl->skip), "cpu does not support %s", buf);
+	} else if (req->min_vlen > vlen)
+		snprintf(impl->skip, sizeof(impl->skip), "requires VLEN >= %u (VLEN: %u)",
+			 req->min_vlen, vlen);
+	else if (req->inplace_unsafe && impl->alg->inplace)
+		snprintf(impl->skip, sizeof(impl->skip), "not in-place safe");
+}
+
+
+/*
+ * evaluate requirements of implementations
+ * (skip implementations, pad len and set alignment)
+ */
+static int alg_apply_reqs(alg_t *alg)
+{
+	unsigned int isa = sysinfo_get_isa();
+	unsigned int vlen = sysinfo_get_vlen();
+	unsigned int multiple = 1;
+
+	for (impl_t *s = alg->impls_head; s != NULL; s = s->next) {
+		impl_check_req(s, isa, vlen);
+		if (s->skip[0] != '\0')
+			continue;
+
+		/* least common multiple of all runnable implementations */
+		if (s->req.len_multiple > 1)
+			multiple = multiple / gcd(multiple, s->req.len_multiple) * s->req.len_multiple;
+		if (s->req.align > alg->align)
+			alg->align = s->req.align;
+	}
+
+	unsigned int len = (alg->len + multiple - 1) / multiple * multiple;
+	if (len == alg->len)
+		return 0;
+
+	/* update len in parameter string ("len=<len>,...") */
+	if (strncmp(alg->parastr, "len=", 4) == 0) {
+		char *parastr = NULL;
+		const char *rest = alg->parastr + 4 + strspn(alg->parastr + 4, "0123456789");
+		if (asprintf(&parastr, "len=%u%s", len, rest) < 0)
+			return -1;
+		free(alg->parastr);
+		alg->parastr = parastr;
+	}
+	alg->len = len;
+
+	return 0;
+}
+
+
 static void alg_reset(alg_t *alg)
 {
 	if (alg == NULL)
@@ -470,16 +1085,44 @@ static int alg_call_postexec(alg_t *alg)
 }
 
 
-static int alg_run(alg_t *alg, int seed, int iterations, bool verify, bool verbose)
+static int alg_run_impls(alg_t *alg, int seed, int iterations, bool verify, bool verbose)
 {
 	int ret;
 
-	if (alg == NULL) {
-		errno = EINVAL;
-		return -1;
+	/* restore results from cache */
+	unsigned int uncached = 0;
+	for (
+		impl_t *s = alg->impls_head;
+		s != NULL;
+		s = s->next
+	) {
+		if (s->skip[0] != '\0')
+			continue;
+		ret = impl_restore_cached(s);
+		if (ret < 0)
+			return -1;
+		else if (ret == 0)
+			uncached++;
 	}
 
-	pinfo("   + algorithm: %s(%s)\n", alg->name, alg->parastr);
+	/* all implementations cached -> no need to prepare data */
+	if (uncached == 0) {
+		for (
+			impl_t *s = alg->impls_head;
+			s != NULL;
+			s = s->next
+		) {
+			if (s->skip[0] != '\0') {
+				impl_report_skipped(s, verbose);
+				continue;
+			}
+			if (verbose)
+				fprintf(alg->algset->infobuf, "     (cached)\n");
+			if (impl_report(s, verbose) < 0)
+				return -1;
+		}
+		return 0;
+	}
 
 	/* call preexec */
 	ret = alg_call_preexec(alg, seed);
@@ -492,15 +1135,21 @@ static int alg_run(alg_t *alg, int seed, int iterations, bool verify, bool verbo
 		s != NULL;
 		s = s->next
 	) {
-		ret = impl_call_init(s);
-		if (ret < 0)
-			return -1;
+		if (s->skip[0] != '\0') {
+			impl_report_skipped(s, verbose);
+			continue;
+		}
 
-		ret = impl_run_iterations(s, iterations, verify, verbose);
-		if (ret < 0)
-			return -1;
+		if (s->cached) {
+			if (verbose)
+				fprintf(alg->algset->infobuf, "     (cached)\n");
+			if (impl_report(s, verbose) < 0)
+				return -1;
+			continue;
+		}
 
-		ret = impl_call_cleanup(s);
+		/* including init and cleanup (isolated in a child if enabled) */
+		ret = impl_run_iterations(s, iterations, verify, verbose);
 		if (ret < 0)
 			return -1;
 	}
@@ -514,6 +1163,50 @@ static int alg_run(alg_t *alg, int seed, int iterations, bool verify, bool verbo
 }
 
 
+/*
+ * run algorithm
+ * All reports of implementations are buffered and written after the
+ * last implementation was run -> no output between measurements.
+ */
+static int alg_run(alg_t *alg, int seed, int iterations, bool verify, bool verbose)
+{
+	algset_t *algset;
+	char *data = NULL, *info = NULL;
+	size_t data_len = 0, info_len = 0;
+	int ret = -1;
+
+	if (alg == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	algset = alg->algset;
+
+	pinfo("   + algorithm: %s(%s)\n", alg->name, alg->parastr);
+
+	algset->databuf = open_memstream(&data, &data_len);
+	if (algset->databuf == NULL)
+		goto __ret;
+	algset->infobuf = open_memstream(&info, &info_len);
+	if (algset->infobuf == NULL)
+		goto __ret_close_databuf;
+
+	ret = alg_run_impls(alg, seed, iterations, verify, verbose);
+
+	fclose(algset->infobuf);
+	fwrite(info, 1, info_len, INFOOUT);
+	free(info);
+__ret_close_databuf:
+	fclose(algset->databuf);
+	fwrite(data, 1, data_len, DATAOUT);
+	fflush(DATAOUT);
+	free(data);
+__ret:
+	algset->databuf = NULL;
+	algset->infobuf = NULL;
+	return ret;
+}
+
+
 /*
  * ALGORITHM SET
  */
@@ -563,8 +1256,11 @@ int algset_add_alg(algset_t *algset, alg_t *alg)
 		return -1;
 	}
 
+	if (alg_apply_reqs(alg) < 0)
+		return -1;
+
 	/* add to link list */
-	alg->index = algset->algs_len;
+	alg->index = algset->algs_count++;
 	if (algset->algs_tail == NULL)
 		/* first element */
 		algset->algs_head = alg;
@@ -580,6 +1276,88 @@ int algset_add_alg(algset_t *algset, alg_t *alg)
 }
 
 
+void algset_set_format(algset_t *algset, enum algset_format format)
+{
+	if (algset == NULL)
+		return;
+	algset->format = format;
+}
+
+
+void algset_set_rawfile(algset_t *algset, rawfile_t *rawfile)
+{
+	if (algset == NULL)
+		return;
+	algset->rawfile = rawfile;
+}
+
+
+void algset_set_len_schedule(algset_t *algset, const char *len_schedule)
+{
+	if (algset == NULL)
+		return;
+	algset->len_schedule = len_schedule;
+}
+
+
+void algset_set_isolate(algset_t *algset, bool isolate, unsigned int timeout)
+{
+	if (algset == NULL)
+		return;
+	algset->isolate = isolate;
+	algset->timeout = timeout;
+}
+
+
+void algset_set_rescache(algset_t *algset, rescache_t *rescache)
+{
+	if (algset == NULL)
+		return;
+	algset->rescache = rescache;
+}
+
+
+void algset_set_source(algset_t *algset, algset_source_fp_t source, void *arg)
+{
+	if (algset == NULL)
+		return;
+	algset->source = source;
+	algset->source_arg = arg;
+}
+
+
+void algset_set_costmodel(algset_t *algset, costmodel_t *costmodel)
+{
+	if (algset == NULL)
+		return;
+	algset->costmodel = costmodel;
+}
+
+
+void algset_set_compare(algset_t *algset, compare_t *compare)
+{
+	if (algset == NULL)
+		return;
+	algset->compare = compare;
+}
+
+
+void algset_set_icount(algset_t *algset, icount_t *icount)
+{
+	if (algset == NULL)
+		return;
+	algset->icount = icount;
+}
+
+
+void algset_set_profile(algset_t *algset, profile_t *profile)
+{
+	if (algset == NULL)
+		return;
+	algset->profile = profile;
+}
+
+
 void algset_reset(algset_t *algset)
 {
 	if (algset == NULL)
@@ -593,27 +1371,120 @@ void algset_reset(algset_t *algset)
 }
 
 
+/* print metadata record of run (JSON Lines) */
+static int algset_print_jsonl_meta(algset_t *algset, int seed, int iterations, bool verify, FILE *out)
+{
+	char buf[SYSINFO_STR_LEN];
+
+	fprintf(out, "{\"type\":\"meta\",");
+	json_print_kv_str(out, "set", algset->name);
+	fprintf(out, ",");
+	json_print_kv_str(out, "version", RVVRADAR_VERSION_STR);
+	fprintf(out, ",");
+	if (sysinfo_get_build_id(buf, sizeof(buf)) == 0) {
+		json_print_kv_str(out, "build_id", buf);
+		fprintf(out, ",");
+	}
+	json_print_kv_str(out, "build_flags", sysinfo_get_build_flags_str());
+	fprintf(out, ",");
+	json_print_kv_str(out, "rvv", sysinfo_get_rvv_draft_str());
+	fprintf(out, ",");
+	sysinfo_get_isa_str(sysinfo_get_isa(), buf, sizeof(buf));
+	json_print_kv_str(out, "isa", buf);
+	fprintf(out, ",\"vlen\":%u,", sysinfo_get_vlen());
+	if (sysinfo_get_cpu_id(buf, sizeof(buf)) == 0) {
+		json_print_kv_str(out, "cpu", buf);
+		fprintf(out, ",");
+	}
+	if (sysinfo_get_clock_str(buf, sizeof(buf)) == 0) {
+		json_print_kv_str(out, "clock", buf);
+		fprintf(out, ",");
+	}
+	if (algset->len_schedule != NULL) {
+		json_print_kv_str(out, "len_schedule", algset->len_schedule);
+		fprintf(out, ",");
+	}
+	fprintf(out, "\"iterations\":%i,\"randseed\":%i,\"verify\":%s,\"time_unit\":\"ns\"}\n",
+		iterations, seed, verify ? "true" : "false");
+
+	return 0;
+}
+
+
+/*
+ * run, report and destroy all algorithms in the set
+ * -> set is empty afterwards (also on error)
+ */
+static int algset_run_algs(algset_t *algset, int seed, int iterations, bool verify, bool verbose)
+{
+	int ret = 0;
+
+	while (algset->algs_head != NULL) {
+		alg_t *alg = algset->algs_head;
+
+		/* unlink */
+		algset->algs_head = alg->next;
+		if (algset->algs_head == NULL)
+			algset->algs_tail = NULL;
+		algset->algs_len--;
+
+		if (ret >= 0) {
+			alg_reset(alg);
+			ret = alg_run(alg, seed, iterations, verify, verbose);
+		}
+		alg_destroy(alg);
+	}
+
+	return ret;
+}
+
+
 int algset_run(algset_t *algset, int seed, int iterations, bool verify, bool verbose)
 {
-	int ret;
+	int ret = 0;
 
 	if (algset == NULL) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	impl_print_csv_head(DATAOUT);
+	switch (algset->format) {
+	case ALGSET_FORMAT_JSONL:
+		algset_print_jsonl_meta(algset, seed, iterations, verify, DATAOUT);
+		break;
+	case ALGSET_FORMAT_CSV:
+	default:
+		impl_print_csv_head(DATAOUT, algset->icount != NULL);
+		break;
+	}
+
+	/*
+	 * run configuration for results cache
+	 * (verified runs are not cached -> results would be influenced;
+	 * cached results have no instruction counts and samples; isolated
+	 * runs are measured in a child process -> separate key; timeouts
+	 * are not cached -> the timeout is not part of the key)
+	 */
+	rescache_t *rescache = algset->rescache;
+	if (verify || algset->icount != NULL || algset->profile != NULL)
+		algset->rescache = NULL;
+	snprintf(algset->runcfg, sizeof(algset->runcfg),
+		 "iterations=%i,randseed=%i,isolate=%d", iterations, seed, algset->isolate);
 
 	pinfo(" + set: %s\n", algset->name);
-	for (
-		alg_t *b = algset->algs_head;
-		b != NULL;
-		b = b->next
-	) {
-		ret = alg_run(b, seed, iterations, verify, verbose);
-		if (ret < 0)
-			return -1;
+
+	/* run algorithms added before */
+	ret = algset_run_algs(algset, seed, iterations, verify, verbose);
+
+	/* create, run and destroy units of source one after the other */
+	while (ret >= 0 && algset->source != NULL) {
+		ret = algset->source(algset, algset->source_arg);
+		if (ret <= 0)
+			break;
+		ret = algset_run_algs(algset, seed, iterations, verify, verbose);
 	}
 
-	return 0;
+	algset->rescache = rescache;
+
+	return ret < 0 ? -1 : 0;
 }
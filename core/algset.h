@@ -7,9 +7,18 @@
 #ifndef ALGSET_H
 #define ALGSET_H
 
+#include <stdio.h>
 #include <stdbool.h>
 
+#include <core/sysinfo.h>
 #include <core/chrono.h>
+#include <core/param.h>
+#include <core/rescache.h>
+#include <core/costmodel.h>
+#include <core/rawfile.h>
+#include <core/compare.h>
+#include <core/icount.h>
+#include <core/profile.h>
 
 
 /*
@@ -28,6 +37,19 @@ typedef int (*impl_exec_fp_t)(struct impl *impl, bool verify);
 typedef int (*impl_postexec_fp_t)(struct impl *impl, bool verify);
 typedef int (*impl_cleanup_fp_t)(struct impl *impl);
 
+/*
+ * requirements of an algorithm implementation (see alg_add_impl)
+ * zero initialized -> no requirements
+ */
+typedef struct impl_req {
+	unsigned int isa;			// required ISA extensions (SYSINFO_ISA_*)
+	unsigned int min_vlen;			// minimum VLEN in bits (0 .. none)
+	unsigned int len_multiple;		// len has to be a multiple of (0 .. none)
+	unsigned int align;			// alignment of buffers in bytes (0 .. none)
+	bool inplace_unsafe;			// output must not overlap input
+} impl_req_t;
+
+
 /* algorithm implementation */
 typedef struct impl {
 	char *name;				// name of the implementation
@@ -39,12 +61,20 @@ typedef struct impl {
 	impl_postexec_fp_t postexec;		// called after each implementation execution
 	impl_cleanup_fp_t cleanup;		// called after iterations over implementations
 
+	impl_req_t req;				// requirements
+	char skip[64];				// reason why skipped ("" .. runnable)
+
 	struct alg *alg;			// parent algorithm the implementation belongs to
 	struct impl *next;			// next in the implementation list
 
 	unsigned int runs;			// number of runs
 	unsigned int fails;			// number of failed runs
 	chrono_t chrono;			// chrono (including result statistics)
+	bool cached;				// results restored from results cache
+	long raw_index;				// index in raw samples file (<0 .. none)
+	int signal;				// terminating signal of isolated run (0 .. none)
+	bool timeout;				// isolated run killed by watchdog
+	icount_counts_t icount;			// instruction counts of all measured runs (see icount.h)
 
 	void *priv_data;			// optional private data for the implementation
 } impl_t;
@@ -57,7 +87,10 @@ typedef int (*alg_postexec_fp_t)(struct alg *alg);
 typedef struct alg {
 	char *name;				// name of the algorithm
 	char *parastr;				// string containing parameters as string
+	unsigned int len;			// number of elements processed (problem size)
 	unsigned int index;			// index in algorithm list
+	bool inplace;				// output overlaps input (set by algorithm)
+	unsigned int align;			// alignment of buffers (see alg_alloc)
 
 	// linked list of algorithm implementations
 	impl_t *impls_head;
@@ -74,6 +107,20 @@ typedef struct alg {
 } alg_t;
 
 
+/* format of data output */
+enum algset_format {
+	ALGSET_FORMAT_CSV,			// csv with column headers
+	ALGSET_FORMAT_JSONL,			// JSON Lines (metadata record + record per impl)
+};
+
+
+/*
+ * source of algorithms (lazy instantiation)
+ * adds the algorithms of the next unit to algset
+ * return: >0 .. unit added; 0 .. no more units; <0 .. error (errno)
+ */
+typedef int (*algset_source_fp_t)(struct algset *algset, void *arg);
+
 typedef struct algset {
 	char *name;
 
@@ -81,8 +128,45 @@ typedef struct algset {
 	struct alg *algs_head;
 	struct alg *algs_tail;
 	unsigned int algs_len;
+	unsigned int algs_count;		// number of algorithms added in total
+
+	algset_source_fp_t source;		// optional source of algorithms
+	void *source_arg;			// argument for source
+
+	enum algset_format format;		// format of data output
+	rawfile_t *rawfile;			// optional raw samples file
+	rescache_t *rescache;			// optional results cache
+	costmodel_t *costmodel;			// optional cost model (collects results)
+	compare_t *compare;			// optional comparison against baseline
+	icount_t *icount;			// optional instruction counts (qemu plugin)
+	profile_t *profile;			// optional sampling profiler (hot spots)
+	bool isolate;				// run implementations in child processes
+	unsigned int timeout;			// watchdog timeout per implementation [s] (0 .. none)
+	const char *len_schedule;		// optional length schedule (recorded in output)
+	char runcfg[64];			// run configuration (key for results cache)
+
+	FILE *databuf;				// buffered data output of running algorithm
+	FILE *infobuf;				// buffered human readable output of running algorithm
 } algset_t;
 
+struct algset;
+
+/*
+ * algorithm descriptor
+ * An algorithm declares its typed parameters (see param.h) here. The
+ * matrix (see matrix.h) expands the given parameter values and lengths
+ * and calls add for each combination. values are given in the order of
+ * params.
+ */
+typedef struct alg_desc {
+	const char *name;			// name of the algorithm (family)
+	const char *description;		// one line description
+	const param_desc_t *params;		// parameters
+	unsigned int nparams;			// number of parameters (<= PARAM_MAX)
+	int (*add)(struct algset *algset, unsigned int len, const unsigned int *values);
+} alg_desc_t;
+
+
 /* internal helper to get private data from given object
  * and cast to given type
  */
@@ -107,15 +191,34 @@ typedef struct algset {
  * handling of optional given data (free) is handled by alg!
  * name and parastr will be duplicated and handled by alg (e.g. heap
  * allocated parameters are valid)
+ * len is the number of elements processed by the algorithm (used for
+ * analysis of results over different lengths)
+ * len may be padded when the algorithm is added to the set (see
+ * impl_req_t) -> sizes of data have to be derived from alg->len in
+ * preexec
  */
 alg_t *alg_create(
 	const char *name,
 	const char *parastr,
+	unsigned int len,
 	alg_preexec_fp_t preexec,
 	alg_postexec_fp_t postexec,
 	unsigned int priv_data_len);
 
 
+/*
+ * build parameter string of an algorithm from its descriptor
+ * ("len=<len>,<param>=<value>,...")
+ * return: same as snprintf
+ */
+int alg_desc_parastr(
+	const alg_desc_t *desc,
+	unsigned int len,
+	const unsigned int *values,
+	char *buf,
+	size_t size);
+
+
 /*
  * destroy the algorithm
  * (data and linked implementations will be also destroyed here)
@@ -123,15 +226,31 @@ alg_t *alg_create(
 void alg_destroy(alg_t *alg);
 
 
+/*
+ * allocate a buffer of the algorithm
+ * aligned to the largest alignment required by its implementations and
+ * padded to a multiple of it (release with free)
+ * return: NULL on error (errno)
+ */
+void *alg_alloc(alg_t *alg, size_t size);
+
+
 /*
  * create and add a new algorithm implementation
  * name will be duplicated and handled by alg (e.g. heap allocated
  * parameters are valid)
+ * req .. requirements (copied; NULL .. none); evaluated when the algorithm
+ *        is added to the set:
+ *          * isa, min_vlen, inplace_unsafe not met -> skipped (reported
+ *            with reason)
+ *          * len_multiple -> len of the algorithm is padded
+ *          * align -> alignment of alg_alloc
  * returns NULL on error
  */
 impl_t *alg_add_impl(
 	alg_t *alg,
 	const char *name,
+	const impl_req_t *req,
 	impl_init_fp_t init,
 	impl_preexec_fp_t preexec,
 	impl_exec_fp_t exec,
@@ -161,10 +280,100 @@ void algset_destroy(algset_t *algset);
 
 /*
  * add a new algorithm to the set
+ * (requirements of implementations are evaluated; see alg_add_impl)
  */
 int algset_add_alg(algset_t *algset, alg_t *alg);
 
 
+/*
+ * set format of data output (default: ALGSET_FORMAT_CSV)
+ */
+void algset_set_format(algset_t *algset, enum algset_format format);
+
+
+/*
+ * set raw samples file to write all single measurements to (NULL ..
+ * disable)
+ * Implementations restored from cache have no samples and are not
+ * written.
+ * (file is not closed by algset)
+ */
+void algset_set_rawfile(algset_t *algset, rawfile_t *rawfile);
+
+
+/*
+ * set length schedule specification (see lensched.h) to record in the
+ * data output (JSONL meta record; CSV column len_schedule)
+ * (string is referenced, not copied)
+ */
+void algset_set_len_schedule(algset_t *algset, const char *len_schedule);
+
+
+/*
+ * run each implementation (init, iterations, cleanup) isolated in a
+ * forked child process (see isolate.h)
+ * Crashes (e.g. SIGILL of unsupported instructions) and timeouts are
+ * reported as fails with the terminating signal; the run continues.
+ *   * timeout .. watchdog timeout per implementation in seconds (0 .. none)
+ */
+void algset_set_isolate(algset_t *algset, bool isolate, unsigned int timeout);
+
+
+/*
+ * set results cache to use on run (NULL .. disable)
+ * Results of implementations found in the cache are restored instead of
+ * measured. Measured results are stored to the cache.
+ * Cache is not used if results are verified.
+ * (cache is not destroyed/saved by algset)
+ */
+void algset_set_rescache(algset_t *algset, rescache_t *rescache);
+
+
+/*
+ * set source of algorithms for lazy instantiation (NULL .. disable)
+ * On run, the source is called to add the algorithms of one unit after
+ * the other. Each unit is run, reported and destroyed before the next is
+ * requested -> memory is bounded by a single unit.
+ */
+void algset_set_source(algset_t *algset, algset_source_fp_t source, void *arg);
+
+
+/*
+ * set cost model to feed with results on run (NULL .. disable)
+ * (cost model is not fitted/destroyed by algset)
+ */
+void algset_set_costmodel(algset_t *algset, costmodel_t *costmodel);
+
+
+/*
+ * set comparison against baseline to feed with results on run (NULL ..
+ * disable)
+ * (comparison is not reported/destroyed by algset)
+ */
+void algset_set_compare(algset_t *algset, compare_t *compare);
+
+
+/*
+ * set instruction counts file to read the counts of each measured
+ * execution from (NULL .. disable; see icount.h)
+ * Counts per run are reported as additional columns/fields. The results
+ * cache is not used if counts are enabled.
+ * (file is not closed by algset)
+ */
+void algset_set_icount(algset_t *algset, icount_t *icount);
+
+
+/*
+ * set sampling profiler to sample each measured execution with (NULL ..
+ * disable; see profile.h)
+ * Hot spots of each implementation are written to the report of the
+ * profiler. The results cache is not used and isolated runs are not
+ * supported if the profiler is enabled.
+ * (profiler is not destroyed by algset)
+ */
+void algset_set_profile(algset_t *algset, profile_t *profile);
+
+
 /*
  * reset the state of the whole set
  * (collected data, measurements, ...)
@@ -174,6 +383,9 @@ void algset_reset(algset_t *algset);
 
 /*
  * run the algorithm set
+ * Algorithms added before are run first, followed by all units of the
+ * source (if set). Algorithms are destroyed after they were run and
+ * reported -> the set is empty afterwards.
  */
 int algset_run(algset_t *alg, int seed, int iterations, bool verify, bool verbose);
 
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef C_VARIANTS_H
+#define C_VARIANTS_H
+
+/*
+ * Variant matrix of the C implementations (*_c.c.in)
+ * Besides avect/noavect, the buildsystem builds *_c.c.in once per
+ * combination of compiler, optimization level and flag set configured in
+ * config.mk (@OPTIMIZATION@ is replaced by the variant name, e.g.
+ * gcc_O3_unroll) and passes the list of variant names as
+ * RVVRADAR_C_MATRIX(_X_) -> _X_(<variant>) for each variant.
+ * Algorithms declare and register the variants with C_MATRIX_FOREACH.
+ *
+ * Example:
+ *   #define DECLARE_C(_v_) extern void memcpy_c_byte_##_v_(...);
+ *   C_MATRIX_FOREACH(DECLARE_C)
+ */
+#ifndef RVVRADAR_C_MATRIX
+#define RVVRADAR_C_MATRIX(_X_)
+#endif
+
+#define C_MATRIX_FOREACH(_X_)	RVVRADAR_C_MATRIX(_X_)
+
+#endif /* C_VARIANTS_H */
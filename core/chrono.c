@@ -31,8 +31,11 @@ static long long timespec_diff(const struct timespec start, const struct timespe
 }
 
 
-static inline void chrono__start(struct timespec *start)
+static inline void chrono__start(struct timespec *start, long long *wallclock)
 {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	*wallclock = ts.tv_sec * 1000000000LL + ts.tv_nsec;
 	clock_gettime(CLOCK_MONOTONIC, start);
 }
 
@@ -90,9 +93,12 @@ static inline long long chrono_hist_get_bucket_end_by_idx(chrono_t *chrono, unsi
 /*
  * comparator function for qsort
  */
-static int chrono_qsort_td_compare(const void * a, const void * b)
+static int chrono_qsort_sample_compare(const void *a, const void *b)
 {
-	return ( *(long long*)a - * (long long*)b );
+	const chrono_sample_t *sa = a, *sb = b;
+	if (sa->td != sb->td)
+		return sa->td < sb->td ? -1 : 1;
+	return sa->idx < sb->idx ? -1 : (sa->idx > sb->idx);
 }
 
 
@@ -131,6 +137,89 @@ static void chrono_update_statistics_hist_buckets(chrono_t *chrono)
 }
 
 
+/*
+ * median of the measurements before (before = 1) or from (before = 0)
+ * index idx in order of measurement
+ * (sorted needed; same rounding as tdmedian)
+ */
+static long long chrono_segment_median(chrono_t *chrono, unsigned int idx, int before)
+{
+	unsigned int n = before ? idx : chrono->nmeasure - idx;
+	unsigned int k = 0;
+	long long lower = 0;
+
+	for (int i = 0; i < chrono->nmeasure; i++) {
+		if ((chrono->sorted[i].idx < idx) != before)
+			continue;
+		if ((n & 1) == 0 && k == n / 2 - 1)
+			lower = chrono->sorted[i].td;
+		if (k == n / 2)
+			return (n & 1) ? chrono->sorted[i].td : (lower + chrono->sorted[i].td) / 2;
+		k++;
+	}
+	return 0;
+}
+
+
+/*
+ * update statistics - drift (Pettitt changepoint test)
+ *
+ *   U_t = 2 * sum(rank_1 .. rank_t) - t * (n + 1)
+ *   K   = max |U_t|; changepoint at argmax
+ *   p   ~ 2 * exp(-6 * K^2 / (n^3 + n^2))
+ *
+ * (sorted needed)
+ */
+static void chrono_update_statistics_drift(chrono_t *chrono)
+{
+	unsigned int n = chrono->nmeasure;
+
+	chrono->drift = 0;
+	chrono->drift_p = 1.0;
+	chrono->drift_idx = 0;
+	chrono->drift_shift = 0.0;
+
+	if (n < CHRONO_DRIFT_MIN_NMEASURE)
+		return;
+
+	/* doubled ranks in order of measurement (ties -> mean rank) */
+	for (unsigned int first = 0; first < n;) {
+		unsigned int last = first;
+		while (last + 1 < n && chrono->sorted[last + 1].td == chrono->sorted[first].td)
+			last++;
+		for (unsigned int i = first; i <= last; i++)
+			chrono->ranks[chrono->sorted[i].idx] = (long long)first + last + 2;
+		first = last + 1;
+	}
+
+	long long sum = 0;
+	double kmax = 0.0;
+	for (unsigned int t = 1; t < n; t++) {
+		sum += chrono->ranks[t - 1];
+		double u = fabs((double)sum - (double)t * (n + 1));
+		if (u > kmax) {
+			kmax = u;
+			chrono->drift_idx = t;
+		}
+	}
+
+	double dn = n;
+	chrono->drift_p = 2.0 * exp(-6.0 * kmax * kmax / (dn * dn * dn + dn * dn));
+	if (chrono->drift_p > 1.0)
+		chrono->drift_p = 1.0;
+	if (chrono->drift_idx == 0)
+		return;
+
+	long long median_before = chrono_segment_median(chrono, chrono->drift_idx, 1);
+	long long median_after = chrono_segment_median(chrono, chrono->drift_idx, 0);
+	if (median_before > 0)
+		chrono->drift_shift = (double)(median_after - median_before) / median_before;
+
+	chrono->drift = chrono->drift_p < CHRONO_DRIFT_P &&
+			fabs(chrono->drift_shift) >= CHRONO_DRIFT_SHIFT;
+}
+
+
 /* update statistics */
 static void chrono_update_statistics(chrono_t *chrono)
 {
@@ -153,16 +242,23 @@ static void chrono_update_statistics(chrono_t *chrono)
 	chrono->tdvar = varsum / chrono->nmeasure;
 	chrono->tdstdev = sqrt(chrono->tdvar);
 
-	/* update median */
-	qsort(chrono->tdlist, chrono->nmeasure, sizeof(long long), chrono_qsort_td_compare);
-	chrono->tdmedian = chrono->tdlist[chrono->nmeasure / 2];
+	/* update median (sorted copy -> tdlist stays in order of measurement) */
+	for (int i = 0; i < chrono->nmeasure; i++) {
+		chrono->sorted[i].td = chrono->tdlist[i];
+		chrono->sorted[i].idx = i;
+	}
+	qsort(chrono->sorted, chrono->nmeasure, sizeof(chrono_sample_t), chrono_qsort_sample_compare);
+	chrono->tdmedian = chrono->sorted[chrono->nmeasure / 2].td;
 	if ((chrono->nmeasure & 1) == 0) {
 		/* even number of elements -> mean of middle two elements */
-		chrono->tdmedian = (chrono->tdmedian + chrono->tdlist[chrono->nmeasure / 2 - 1]) / 2;
+		chrono->tdmedian = (chrono->tdmedian + chrono->sorted[chrono->nmeasure / 2 - 1].td) / 2;
 	}
 
 	/* update histogram buckets */
 	chrono_update_statistics_hist_buckets(chrono);
+
+	/* update drift (needs sorted) */
+	chrono_update_statistics_drift(chrono);
 }
 
 
@@ -171,7 +267,7 @@ static void chrono_update_statistics(chrono_t *chrono)
  * API
  */
 
-int chrono_init(chrono_t *chrono)
+int chrono_init(chrono_t *chrono, unsigned int max_nmeasure)
 {
 	if (chrono == NULL) {
 		errno = EINVAL;
@@ -180,11 +276,21 @@ int chrono_init(chrono_t *chrono)
 
 	memset(chrono, 0, sizeof(chrono_t));
 	chrono->tdmin = LLONG_MAX;
-
-	chrono->max_nmeasure = CHRONO_MAX_MEASUREMENTS;
-	chrono->tdlist = calloc(chrono->max_nmeasure, sizeof(long long));
-	if (chrono->tdlist == NULL)
+	chrono->drift_p = 1.0;
+
+	if (max_nmeasure == 0)
+		return 0;
+
+	chrono->tdlist = calloc(max_nmeasure, sizeof(long long));
+	chrono->tslist = calloc(max_nmeasure, sizeof(long long));
+	chrono->sorted = calloc(max_nmeasure, sizeof(chrono_sample_t));
+	chrono->ranks = calloc(max_nmeasure, sizeof(long long));
+	if (chrono->tdlist == NULL || chrono->tslist == NULL ||
+	    chrono->sorted == NULL || chrono->ranks == NULL) {
+		chrono_cleanup(chrono);
 		return -1;
+	}
+	chrono->max_nmeasure = max_nmeasure;
 
 	return 0;
 }
@@ -195,6 +301,14 @@ void chrono_cleanup(chrono_t *chrono)
 	if (chrono == NULL)
 		return;
 	free(chrono->tdlist);
+	free(chrono->tslist);
+	free(chrono->sorted);
+	free(chrono->ranks);
+	chrono->tdlist = NULL;
+	chrono->tslist = NULL;
+	chrono->sorted = NULL;
+	chrono->ranks = NULL;
+	chrono->max_nmeasure = 0;
 }
 
 
@@ -206,7 +320,7 @@ int chrono_start(chrono_t *chrono)
 	}
 
 	/* start chronometer */
-	chrono__start(&chrono->tstart);
+	chrono__start(&chrono->tstart, &chrono->tsstart);
 
 	return 0;
 }
@@ -224,13 +338,25 @@ int chrono_stop(chrono_t *chrono)
 	/* stop chronometer */
 	td = chrono__stop(chrono->tstart);
 
+	return chrono_add(chrono, td, chrono->tsstart);
+}
+
+
+int chrono_add(chrono_t *chrono, long long td, long long ts)
+{
+	if (chrono == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
 	/* abort, if no space */
-	if (chrono->nmeasure > chrono->max_nmeasure) {
+	if (chrono->nmeasure >= chrono->max_nmeasure) {
 		errno = ENOMEM;
 		return -1;
 	}
 
 	chrono->tdlist[chrono->nmeasure] = td;
+	chrono->tslist[chrono->nmeasure] = ts;
 
 	/* update live statistics */
 	chrono->nmeasure++;
@@ -264,6 +390,10 @@ int chrono_print_csv_head(FILE *out)
 			return ret;
 	}
 
+	ret = fprintf(out, ";drift;drift_p;drift_idx;drift_shift [%%]");
+	if (ret < 0)
+		return ret;
+
 	return 0;
 }
 
@@ -297,7 +427,116 @@ int chrono_print_csv(chrono_t *chrono, FILE *out)
 			return ret;
 	}
 
+	ret = fprintf(out, ";%i;%.3g;%u;%.1f",
+		      chrono->drift,
+		      chrono->drift_p,
+		      chrono->drift_idx,
+		      chrono->drift_shift * 100.0);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+
+int chrono_print_json(chrono_t *chrono, FILE *out)
+{
+	int ret = 0;
+	if (chrono == NULL || out == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	chrono_update_statistics(chrono);
+
+	ret = fprintf(out,
+		      "\"nmeasure\":%u,\"tdmin\":%lli,\"tdmax\":%lli,\"tdmean\":%lli,"
+		      "\"tdvar\":%lli,\"tdstdev\":%lli,\"tdmedian\":%lli,"
+		      "\"hist_start\":%lli,\"hist_bucketsize\":%lli,\"hist_buckets\":[",
+		      chrono->nmeasure,
+		      chrono->tdmin,
+		      chrono->tdmax,
+		      chrono->tdmean,
+		      chrono->tdvar,
+		      chrono->tdstdev,
+		      chrono->tdmedian,
+		      chrono_hist_get_bucket_start_by_idx(chrono, 0),
+		      chrono->hist_bucketsize);
+	if (ret < 0)
+		return ret;
+
+	for (int i = 0; i < CHRONO_HIST_BUCKETS; i++) {
+		ret = fprintf(out, "%s%u", i ? "," : "", chrono->hist_buckets[i]);
+		if (ret < 0)
+			return ret;
+	}
+
+	ret = fprintf(out, "],\"drift\":%s,\"drift_p\":%.3g,\"drift_idx\":%u,\"drift_shift\":%.4f",
+		      chrono->drift ? "true" : "false",
+		      chrono->drift_p,
+		      chrono->drift_idx,
+		      chrono->drift_shift);
+	if (ret < 0)
+		return ret;
+
+	return 0;
+}
+
+
+int chrono_restore_csv(chrono_t *chrono, const char *str)
+{
+	unsigned int nbuckets;
+	int pos = 0;
+
+	if (chrono == NULL || str == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (sscanf(str, "%u;%lli;%lli;%lli;%lli;%lli;%lli;%u%n",
+		   &chrono->nmeasure,
+		   &chrono->tdmin,
+		   &chrono->tdmax,
+		   &chrono->tdmean,
+		   &chrono->tdvar,
+		   &chrono->tdstdev,
+		   &chrono->tdmedian,
+		   &nbuckets,
+		   &pos) != 8 || nbuckets != CHRONO_HIST_BUCKETS)
+		goto __err_format;
+
+	str += pos;
+	for (int i = 0; i < CHRONO_HIST_BUCKETS; i++) {
+		if (sscanf(str, ";%u%n", &chrono->hist_buckets[i], &pos) != 1)
+			goto __err_format;
+		str += pos;
+	}
+
+	/* drift (optional) */
+	double shift;
+	if (sscanf(str, ";%i;%lf;%u;%lf",
+		   &chrono->drift,
+		   &chrono->drift_p,
+		   &chrono->drift_idx,
+		   &shift) == 4)
+		chrono->drift_shift = shift / 100.0;
+	else {
+		chrono->drift = 0;
+		chrono->drift_p = 1.0;
+		chrono->drift_idx = 0;
+		chrono->drift_shift = 0.0;
+	}
+
+	/* restore derived values and mark statistics as up to date */
+	chrono->tdsum = chrono->tdmean * chrono->nmeasure;
+	chrono->nmeasure_on_last_update = chrono->nmeasure;
+	chrono_hist_update_bucketsize(chrono);
+
 	return 0;
+
+__err_format:
+	errno = EBADMSG;
+	return -1;
 }
 
 
@@ -330,6 +569,13 @@ int chrono_print_pretty(chrono_t *chrono, const char *indent, FILE *out)
 	if (ret < 0)
 		return ret;
 
+	ret = fprintf(out,
+		      "%sdrift:       %s (p=%.3g, changepoint at %u, shift %+.1f%%)\n",
+		      indent, chrono->drift ? "UNSTABLE" : "no",
+		      chrono->drift_p, chrono->drift_idx, chrono->drift_shift * 100.0);
+	if (ret < 0)
+		return ret;
+
 	for (int i = 0; i < CHRONO_HIST_BUCKETS; i++) {
 		ret = fprintf(out,
 			      "%shist[%.3i]:   %5.1u [%lli, %lli]\n",
@@ -13,7 +13,7 @@
  * Usage example
  *
  * chrono_t chrono;
- * chrono_init(&chrono);
+ * chrono_init(&chrono, <max number of measurements>);
  * loop {
  * 	chrono_start(&chrono);
  * 	<function to measure>
@@ -31,24 +31,49 @@
 
 
 /*
- * maximum number of measurements
+ * number of buckets for histogram
  */
-#define CHRONO_MAX_MEASUREMENTS	10000
+#define CHRONO_HIST_BUCKETS	20
+
 
 /*
- * number of buckets for histogram
+ * drift detection
+ *
+ * The measurements (in order of measurement) are tested for a changepoint
+ * using the Pettitt test (rank based -> robust against outliers). A run is
+ * flagged as drifting (e.g. thermal throttling, frequency scaling,
+ * interference), if the changepoint is significant (p < CHRONO_DRIFT_P)
+ * AND the medians before and after the changepoint differ by at least
+ * CHRONO_DRIFT_SHIFT (relative).
+ * Runs with less than CHRONO_DRIFT_MIN_NMEASURE measurements are not
+ * tested.
  */
-#define CHRONO_HIST_BUCKETS	20
+#define CHRONO_DRIFT_P			0.01
+#define CHRONO_DRIFT_SHIFT		0.05
+#define CHRONO_DRIFT_MIN_NMEASURE	20
+
+
+/* single measurement for sorting */
+typedef struct chrono_sample {
+	long long td;
+	unsigned int idx;			// index in order of measurement
+} chrono_sample_t;
 
 
 typedef struct chrono {
 	/* last start and end times */
 	struct timespec tstart;
 	struct timespec tend;
+	long long tsstart;			// wall-clock time of last start [ns since epoch]
 
 	unsigned int max_nmeasure;
 	unsigned int nmeasure;
-	long long *tdlist;
+	long long *tdlist;			// durations in order of measurement
+	long long *tslist;			// wall-clock start times [ns since epoch]
+
+	/* work buffers for statistics */
+	chrono_sample_t *sorted;
+	long long *ranks;
 
 	/* live statistics (calculated on each chrono_stop) */
 	long long tdlast;
@@ -64,19 +89,26 @@ typedef struct chrono {
 	long long tdmedian;
 	unsigned int hist_buckets[CHRONO_HIST_BUCKETS];
 	long long hist_bucketsize;
+	int drift;				// 1 .. drift detected
+	double drift_p;				// p-value of changepoint
+	unsigned int drift_idx;			// measurements before changepoint
+	double drift_shift;			// relative change of median at changepoint
 } chrono_t;
 
 
 /*
  * init and reset chronometer and statistics
- *   * max_size .. maximum number of expected measurements
+ *   * max_nmeasure .. maximum number of expected measurements
+ *     (0 .. no measurements; e.g. for restored statistics)
+ * chrono has to be cleaned up before re-init
  * return: 0 .. ok; <0 .. error
  */
-int chrono_init(chrono_t *chrono);
+int chrono_init(chrono_t *chrono, unsigned int max_nmeasure);
 
 
 /*
  * cleanup chrono and free ressources
+ * (safe to call on zero initialized and already cleaned up chrono)
  */
 void chrono_cleanup(chrono_t *chrono);
 
@@ -95,9 +127,18 @@ int chrono_start(chrono_t *chrono);
 int chrono_stop(chrono_t *chrono);
 
 
+/*
+ * add measurement taken elsewhere (e.g. in another process)
+ *   * td .. duration [ns]
+ *   * ts .. wall-clock start time [ns since epoch]
+ * return: 0 .. ok; <0 .. error
+ */
+int chrono_add(chrono_t *chrono, long long td, long long ts);
+
+
 /*
  * print csv head for chrono statistics
- * (nmeasure;td...)
+ * (nmeasure;td...;hist...;drift...)
  * return: same as for fprintf
  */
 int chrono_print_csv_head(FILE *out);
@@ -105,12 +146,31 @@ int chrono_print_csv_head(FILE *out);
 
 /*
  * print chrono statistics as csv
- * (nmeasure;td...)
+ * (nmeasure;td...;hist...;drift...)
  * return: <0 .. error (errno)
  */
 int chrono_print_csv(chrono_t *chrono, FILE *out);
 
 
+/*
+ * print chrono statistics as members of a JSON object
+ * ("nmeasure":...,"tdmin":...; without braces)
+ * return: <0 .. error (errno)
+ */
+int chrono_print_json(chrono_t *chrono, FILE *out);
+
+
+/*
+ * restore chrono statistics from csv
+ * (same format as printed by chrono_print_csv)
+ * Only statistics are restored. Single measurements are not available
+ * afterwards. Missing drift fields (results of older versions) are
+ * restored as not tested.
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int chrono_restore_csv(chrono_t *chrono, const char *str);
+
+
 /*
  * print chrono statistics human readable
  * return: <0 .. error (errno)
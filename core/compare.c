@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <errno.h>
+
+#include <core/json.h>
+#include <core/compare.h>
+
+
+/* maximum length of a line in results files */
+#define LINE_LEN	4096
+
+/* factor of standard error of median to standard error of mean (normal distribution) */
+#define MEDIAN_SE_FACTOR	1.2533
+
+
+/* FNV-1a */
+static unsigned int compare_hash(const char *key)
+{
+	uint32_t h = 2166136261u;
+	for (; *key != '\0'; key++) {
+		h ^= (unsigned char)*key;
+		h *= 16777619u;
+	}
+	return h % COMPARE_HASH_BUCKETS;
+}
+
+
+static compare_base_t *compare_lookup(compare_t *compare, const char *key)
+{
+	for (compare_base_t *b = compare->buckets[compare_hash(key)]; b != NULL; b = b->next)
+		if (strcmp(b->key, key) == 0)
+			return b;
+	return NULL;
+}
+
+
+/* add baseline entry (later entries with same key replace earlier) */
+static int compare_add_base(compare_t *compare, const char *key, bool failed,
+			    unsigned int nmeasure, double median, double stdev)
+{
+	compare_base_t *b = compare_lookup(compare, key);
+	if (b == NULL) {
+		b = calloc(1, sizeof(compare_base_t));
+		if (b == NULL)
+			return -1;
+		b->key = strdup(key);
+		if (b->key == NULL) {
+			free(b);
+			return -1;
+		}
+		unsigned int h = compare_hash(key);
+		b->next = compare->buckets[h];
+		compare->buckets[h] = b;
+		compare->nbase++;
+	}
+
+	b->failed = failed;
+	b->nmeasure = nmeasure;
+	b->median = median;
+	b->stdev = stdev;
+	return 0;
+}
+
+
+/*
+ * parse csv row
+ * (set;algorithm(parameters);implementation;runs;fails;nmeasure;tdmin;tdmax;tdmean;tdvar;tdstdev;tdmedian;...)
+ * return: 1 .. parsed; 0 .. skipped (header); <0 .. error
+ */
+static int compare_parse_csv(compare_t *compare, char *line)
+{
+	unsigned int runs, fails, nmeasure;
+	long long tdmin, tdmax, tdmean, tdvar, tdstdev, tdmedian;
+
+	/* header */
+	if (strncmp(line, "set;", 4) == 0)
+		return 0;
+
+	/* key: first three fields */
+	char *p = line;
+	for (int i = 0; i < 3; i++) {
+		p = strchr(p, ';');
+		if (p == NULL)
+			goto __err_format;
+		p++;
+	}
+	p[-1] = '\0';
+
+	if (sscanf(p, "%u;%u;%u;%lli;%lli;%lli;%lli;%lli;%lli",
+		   &runs, &fails, &nmeasure,
+		   &tdmin, &tdmax, &tdmean, &tdvar, &tdstdev, &tdmedian) != 9)
+		goto __err_format;
+
+	/* failed results are kept (see compare.h) */
+	if (compare_add_base(compare, line, fails > 0 || nmeasure == 0,
+			     nmeasure, tdmedian, tdstdev) < 0)
+		return -1;
+	return 1;
+
+__err_format:
+	errno = EBADMSG;
+	return -1;
+}
+
+
+/*
+ * parse jsonl record
+ * return: 1 .. parsed; 0 .. skipped (other types); <0 .. error
+ */
+static int compare_parse_jsonl(compare_t *compare, const char *line)
+{
+	char type[32], set[256], alg[256], parastr[1024], impl[256];
+	double fails, nmeasure, tdmedian, tdstdev;
+
+	if (json_get_str(line, "type", type, sizeof(type)) < 0)
+		return -1;
+	if (strcmp(type, "impl") != 0)
+		return 0;
+
+	if (
+		json_get_str(line, "set", set, sizeof(set)) < 0 ||
+		json_get_str(line, "algorithm", alg, sizeof(alg)) < 0 ||
+		json_get_parastr(line, "parameters", parastr, sizeof(parastr)) < 0 ||
+		json_get_str(line, "implementation", impl, sizeof(impl)) < 0 ||
+		json_get_num(line, "fails", &fails) < 0 ||
+		json_get_num(line, "nmeasure", &nmeasure) < 0 ||
+		json_get_num(line, "tdmedian", &tdmedian) < 0 ||
+		json_get_num(line, "tdstdev", &tdstdev) < 0
+	)
+		return -1;
+
+	/* failed results are kept (see compare.h) */
+	char *key = NULL;
+	if (asprintf(&key, "%s;%s(%s);%s", set, alg, parastr, impl) < 0)
+		return -1;
+	int ret = compare_add_base(compare, key, fails > 0 || nmeasure == 0,
+				   nmeasure, tdmedian, tdstdev);
+	free(key);
+
+	return ret < 0 ? -1 : 1;
+}
+
+
+static const char *compare_verdict_str(enum compare_verdict verdict)
+{
+	switch (verdict) {
+	case COMPARE_REGRESSION:
+		return "REGRESSION";
+	case COMPARE_IMPROVEMENT:
+		return "improvement";
+	case COMPARE_NEW:
+		return "new";
+	case COMPARE_FAILED:
+		return "FAILED";
+	case COMPARE_UNCHANGED:
+	default:
+		return "unchanged";
+	}
+}
+
+
+static void compare_print_result(compare_result_t *r, FILE *out)
+{
+	if (r->verdict == COMPARE_FAILED)
+		fprintf(out, "   %-11s %s: %u fails\n",
+			compare_verdict_str(r->verdict), r->key, r->fails);
+	else if (r->verdict == COMPARE_NEW)
+		fprintf(out, "   %-11s %s: %.0f ns\n",
+			compare_verdict_str(r->verdict), r->key, r->median);
+	else
+		fprintf(out, "   %-11s %s: %.0f -> %.0f ns (%+.1f%%, z=%.1f)\n",
+			compare_verdict_str(r->verdict), r->key,
+			r->median_base, r->median, r->change * 100.0, r->z);
+}
+
+
+
+/*
+ * API
+ */
+
+compare_t *compare_load(const char *path, double threshold)
+{
+	char line[LINE_LEN];
+
+	if (path == NULL || threshold < 0.0) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	compare_t *compare = calloc(1, sizeof(compare_t));
+	if (compare == NULL)
+		return NULL;
+	compare->threshold = threshold;
+
+	compare->path = strdup(path);
+	if (compare->path == NULL)
+		goto __err;
+
+	FILE *f = fopen(path, "r");
+	if (f == NULL)
+		goto __err;
+
+	unsigned int lineno = 0;
+	while (fgets(line, sizeof(line), f) != NULL) {
+		lineno++;
+		line[strcspn(line, "\r\n")] = '\0';
+		if (line[0] == '\0')
+			continue;
+
+		/* format by content (jsonl records start with brace) */
+		int ret;
+		if (line[0] == '{')
+			ret = compare_parse_jsonl(compare, line);
+		else
+			ret = compare_parse_csv(compare, line);
+		if (ret < 0) {
+			fprintf(stderr, "%s:%u: invalid result\n", path, lineno);
+			fclose(f);
+			errno = EBADMSG;
+			goto __err;
+		}
+	}
+	fclose(f);
+
+	return compare;
+
+__err:
+	compare_destroy(compare);
+	return NULL;
+}
+
+
+void compare_destroy(compare_t *compare)
+{
+	if (compare == NULL)
+		return;
+
+	for (int i = 0; i < COMPARE_HASH_BUCKETS; i++) {
+		compare_base_t *b = compare->buckets[i];
+		while (b != NULL) {
+			compare_base_t *n = b->next;
+			free(b->key);
+			free(b);
+			b = n;
+		}
+	}
+
+	compare_result_t *r = compare->results_head;
+	while (r != NULL) {
+		compare_result_t *n = r->next;
+		free(r->key);
+		free(r);
+		r = n;
+	}
+
+	free(compare->path);
+	free(compare);
+}
+
+
+int compare_add(
+	compare_t *compare,
+	const char *set,
+	const char *alg,
+	const char *parastr,
+	const char *impl,
+	unsigned int fails,
+	unsigned int nmeasure,
+	double median,
+	double stdev)
+{
+	if (compare == NULL || set == NULL || alg == NULL || parastr == NULL || impl == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	compare_result_t *r = calloc(1, sizeof(compare_result_t));
+	if (r == NULL)
+		return -1;
+	if (asprintf(&r->key, "%s;%s(%s);%s", set, alg, parastr, impl) < 0) {
+		free(r);
+		return -1;
+	}
+	r->median = median;
+	r->fails = fails;
+
+	compare_base_t *b = compare_lookup(compare, r->key);
+	if (b != NULL)
+		b->matched = true;
+	if (b != NULL && !b->failed && (fails > 0 || nmeasure == 0)) {
+		r->verdict = COMPARE_FAILED;
+		compare->nfailed++;
+	} else if (b == NULL || b->failed || fails > 0 || nmeasure == 0) {
+		/* nothing to compare with (new, or failed in baseline or both) */
+		r->verdict = COMPARE_NEW;
+		compare->nnew++;
+	} else {
+		r->median_base = b->median;
+		r->change = b->median > 0 ? (median - b->median) / b->median : 0.0;
+
+		double se = MEDIAN_SE_FACTOR * stdev / sqrt(nmeasure);
+		double se_base = MEDIAN_SE_FACTOR * b->stdev / sqrt(b->nmeasure);
+		double se_diff = sqrt(se * se + se_base * se_base);
+		if (se_diff > 0)
+			r->z = (median - b->median) / se_diff;
+		else
+			/* no spread at all -> every difference is significant */
+			r->z = median > b->median ? INFINITY : (median < b->median ? -INFINITY : 0.0);
+
+		if (r->change > compare->threshold && r->z >= COMPARE_Z_CRIT) {
+			r->verdict = COMPARE_REGRESSION;
+			compare->nregressions++;
+		} else if (r->change < -compare->threshold && r->z <= -COMPARE_Z_CRIT) {
+			r->verdict = COMPARE_IMPROVEMENT;
+			compare->nimprovements++;
+		} else {
+			r->verdict = COMPARE_UNCHANGED;
+			compare->nunchanged++;
+		}
+	}
+
+	/* append to list */
+	if (compare->results_head == NULL)
+		compare->results_head = r;
+	else
+		compare->results_tail->next = r;
+	compare->results_tail = r;
+
+	return 0;
+}
+
+
+void compare_print_report(compare_t *compare, bool all, FILE *out)
+{
+	if (compare == NULL || out == NULL)
+		return;
+
+	fprintf(out, " + compare: %s (threshold: %.1f%%, z >= %.3f)\n",
+		compare->path, compare->threshold * 100.0, COMPARE_Z_CRIT);
+
+	for (compare_result_t *r = compare->results_head; r != NULL; r = r->next)
+		if (all || r->verdict == COMPARE_REGRESSION || r->verdict == COMPARE_FAILED)
+			compare_print_result(r, out);
+
+	/* baseline entries not run (e.g. removed implementations) */
+	unsigned int nmissing = 0;
+	for (int i = 0; i < COMPARE_HASH_BUCKETS; i++)
+		for (compare_base_t *b = compare->buckets[i]; b != NULL; b = b->next)
+			if (!b->matched) {
+				if (all)
+					fprintf(out, "   %-11s %s\n", "missing", b->key);
+				nmissing++;
+			}
+
+	fprintf(out, "   + %u regressions, %u failed, %u improvements, %u unchanged, %u new, %u missing\n",
+		compare->nregressions, compare->nfailed, compare->nimprovements,
+		compare->nunchanged, compare->nnew, nmissing);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef COMPARE_H
+#define COMPARE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+
+/*
+ * Comparison against baseline results (regression gate)
+ *
+ * Results of a previous run (csv or jsonl output of RVVRadar) are loaded
+ * as baseline. Results of the current run are matched by
+ * set;algorithm(parameters);implementation and the medians are compared:
+ *
+ *   change = (median - median_base) / median_base
+ *   z      = (median - median_base) / sqrt(se^2 + se_base^2)
+ *   se     = 1.2533 * stdev / sqrt(nmeasure)	(standard error of median)
+ *
+ * A result is a regression (improvement), if it is slower (faster) by more
+ * than the relative threshold AND the change is significant (|z| >=
+ * COMPARE_Z_CRIT). Small but significant changes and large but noisy
+ * changes are reported as unchanged.
+ * A result with fails (verification, crash or timeout) is a failure, if
+ * the baseline entry was error free. Failed baseline entries are kept to
+ * tell failures from implementations failing in both runs.
+ */
+
+
+/*
+ * critical value of z (two-sided; ~99% confidence)
+ */
+#define COMPARE_Z_CRIT		2.576
+
+
+/*
+ * number of buckets of the baseline hash table
+ */
+#define COMPARE_HASH_BUCKETS	4096
+
+
+enum compare_verdict {
+	COMPARE_UNCHANGED,
+	COMPARE_REGRESSION,
+	COMPARE_IMPROVEMENT,
+	COMPARE_NEW,				// not in baseline (or failed there)
+	COMPARE_FAILED,				// failed, but error free in baseline
+};
+
+
+typedef struct compare_base {
+	char *key;				// set;algorithm(parameters);implementation
+	unsigned int nmeasure;
+	double median;				// [ns]
+	double stdev;				// [ns]
+	bool failed;				// result with fails
+	bool matched;				// matched by a result of the current run
+
+	struct compare_base *next;		// next in hash bucket
+} compare_base_t;
+
+
+typedef struct compare_result {
+	char *key;
+	unsigned int fails;
+	double median;				// [ns]
+	double median_base;			// [ns] (COMPARE_NEW: 0)
+	double change;				// relative change
+	double z;				// significance
+	enum compare_verdict verdict;
+
+	struct compare_result *next;
+} compare_result_t;
+
+
+typedef struct compare {
+	char *path;				// baseline file
+	double threshold;			// relative threshold (e.g. 0.05)
+
+	compare_base_t *buckets[COMPARE_HASH_BUCKETS];
+	unsigned int nbase;
+
+	// linked list of results (in order of run)
+	compare_result_t *results_head;
+	compare_result_t *results_tail;
+
+	unsigned int nregressions;
+	unsigned int nfailed;
+	unsigned int nimprovements;
+	unsigned int nunchanged;
+	unsigned int nnew;
+} compare_t;
+
+
+/*
+ * load baseline from results file (csv or jsonl; detected by content)
+ * threshold .. relative threshold of median change (e.g. 0.05 .. 5%)
+ * return: NULL on error (errno)
+ */
+compare_t *compare_load(const char *path, double threshold);
+
+
+/*
+ * destroy comparison
+ */
+void compare_destroy(compare_t *compare);
+
+
+/*
+ * compare result of current run against baseline
+ * fails .. number of failed runs of the implementation (see above)
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int compare_add(
+	compare_t *compare,
+	const char *set,
+	const char *alg,
+	const char *parastr,
+	const char *impl,
+	unsigned int fails,
+	unsigned int nmeasure,
+	double median,
+	double stdev);
+
+
+/*
+ * print regression report
+ * all .. print all results (otherwise only regressions and failures)
+ */
+void compare_print_report(compare_t *compare, bool all, FILE *out);
+
+
+#endif /* COMPARE_H */
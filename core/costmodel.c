@@ -0,0 +1,551 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <errno.h>
+
+#include <core/costmodel.h>
+
+
+/*
+ * minimum number of points per segment
+ */
+#define COSTMODEL_MIN_SEGMENT_POINTS	2
+
+/*
+ * relative root mean square error of a segment, up to which no split
+ * is tried (the linear model fits well enough)
+ */
+#define COSTMODEL_MAX_RMS		0.05
+
+/*
+ * a split is accepted, if the error of the two segments is below this
+ * fraction of the error of the unsplit segment
+ */
+#define COSTMODEL_SPLIT_GAIN		0.5
+
+/*
+ * relative difference of run-times, up to which implementations are
+ * considered to be equally fast (no crossover on noise)
+ */
+#define COSTMODEL_TIE			0.05
+
+
+/*
+ * HELPERS
+ */
+
+/* linear fit */
+struct line {
+	double setup;
+	double per_elem;
+	double sse;		// sum of squared relative errors
+};
+
+
+/*
+ * weighted least squares fit of points [first, last]
+ * weights are 1/td^2 -> relative errors are minimized, which keeps short
+ * lengths relevant in sweeps over multiple orders of magnitude
+ */
+static struct line fit_line(const costmodel_point_t *p, unsigned int first, unsigned int last)
+{
+	double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+	struct line l = { 0 };
+
+	for (unsigned int i = first; i <= last; i++) {
+		double w = 1.0 / (p[i].td * p[i].td);
+		sw += w;
+		sx += w * p[i].len;
+		sy += w * p[i].td;
+		sxx += w * p[i].len * p[i].len;
+		sxy += w * p[i].len * p[i].td;
+	}
+
+	double det = sw * sxx - sx * sx;
+	if (det == 0 || first == last) {
+		/* single length -> constant */
+		l.per_elem = 0;
+		l.setup = sy / sw;
+	} else {
+		l.per_elem = (sw * sxy - sx * sy) / det;
+		l.setup = (sy - l.per_elem * sx) / sw;
+	}
+
+	for (unsigned int i = first; i <= last; i++) {
+		double rel = (p[i].td - l.setup - l.per_elem * p[i].len) / p[i].td;
+		l.sse += rel * rel;
+	}
+
+	return l;
+}
+
+
+static int point_compare(const void *a, const void *b)
+{
+	const costmodel_point_t *pa = a;
+	const costmodel_point_t *pb = b;
+	return (pa->len > pb->len) - (pa->len < pb->len);
+}
+
+
+static void series_append_segment(costmodel_series_t *s, unsigned int first, unsigned int last, struct line l)
+{
+	/* no space left -> extend last segment */
+	if (s->nsegments == COSTMODEL_MAX_SEGMENTS) {
+		s->segments[s->nsegments - 1].len_to = s->points[last].len;
+		return;
+	}
+
+	costmodel_segment_t *seg = &s->segments[s->nsegments++];
+	seg->len_from = s->points[first].len;
+	seg->len_to = s->points[last].len;
+	seg->setup = l.setup;
+	seg->per_elem = l.per_elem;
+	seg->knee = 0;
+}
+
+
+/* fit points [first, last] and split recursively on knees */
+static void series_fit_range(costmodel_series_t *s, unsigned int first, unsigned int last)
+{
+	unsigned int n = last - first + 1;
+	struct line whole = fit_line(s->points, first, last);
+
+	if (
+		n >= 2 * COSTMODEL_MIN_SEGMENT_POINTS &&
+		s->nsegments + 2 <= COSTMODEL_MAX_SEGMENTS &&
+		sqrt(whole.sse / n) > COSTMODEL_MAX_RMS
+	) {
+		/* find best split */
+		unsigned int best_split = 0;
+		double best_sse = whole.sse;
+		for (
+			unsigned int k = first + COSTMODEL_MIN_SEGMENT_POINTS - 1;
+			k + COSTMODEL_MIN_SEGMENT_POINTS <= last;
+			k++
+		) {
+			double sse = fit_line(s->points, first, k).sse +
+				     fit_line(s->points, k + 1, last).sse;
+			if (sse < best_sse) {
+				best_sse = sse;
+				best_split = k;
+			}
+		}
+
+		if (best_split != 0 && best_sse < whole.sse * COSTMODEL_SPLIT_GAIN) {
+			series_fit_range(s, first, best_split);
+			series_fit_range(s, best_split + 1, last);
+			return;
+		}
+	}
+
+	series_append_segment(s, first, last, whole);
+}
+
+
+/* estimate knees as intersection of neighboring segments */
+static void series_update_knees(costmodel_series_t *s)
+{
+	for (unsigned int i = 1; i < s->nsegments; i++) {
+		costmodel_segment_t *prev = &s->segments[i - 1];
+		costmodel_segment_t *seg = &s->segments[i];
+
+		double knee = (prev->len_to + seg->len_from) / 2.0;
+		if (prev->per_elem != seg->per_elem) {
+			double x = (seg->setup - prev->setup) / (prev->per_elem - seg->per_elem);
+			if (x >= prev->len_to && x <= seg->len_from)
+				knee = x;
+		}
+		seg->knee = knee;
+	}
+}
+
+
+static void series_fit(costmodel_series_t *s)
+{
+	s->nsegments = 0;
+	if (s->npoints == 0)
+		return;
+
+	qsort(s->points, s->npoints, sizeof(costmodel_point_t), point_compare);
+	series_fit_range(s, 0, s->npoints - 1);
+	series_update_knees(s);
+}
+
+
+/* evaluate model of series at len */
+static double series_eval(const costmodel_series_t *s, double len)
+{
+	unsigned int i;
+	for (i = 0; i + 1 < s->nsegments; i++)
+		if (len < s->segments[i + 1].knee)
+			break;
+	return s->segments[i].setup + s->segments[i].per_elem * len;
+}
+
+
+/* get measured value of series at len; <0 if not measured */
+static double series_get_td(const costmodel_series_t *s, unsigned int len)
+{
+	for (unsigned int i = 0; i < s->npoints; i++)
+		if (s->points[i].len == len)
+			return s->points[i].td;
+	return -1;
+}
+
+
+static costmodel_series_t *series_find(costmodel_t *model, const char *set, const char *alg, const char *impl)
+{
+	for (
+		costmodel_series_t *s = model->series_head;
+		s != NULL;
+		s = s->next
+	)
+		if (
+			strcmp(s->set, set) == 0 &&
+			strcmp(s->alg, alg) == 0 &&
+			strcmp(s->impl, impl) == 0
+		)
+			return s;
+
+	return NULL;
+}
+
+
+static void series_destroy(costmodel_series_t *s)
+{
+	if (s == NULL)
+		return;
+	free(s->set);
+	free(s->alg);
+	free(s->impl);
+	free(s->points);
+	free(s);
+}
+
+
+static costmodel_series_t *series_create(costmodel_t *model, const char *set, const char *alg, const char *impl)
+{
+	costmodel_series_t *s = calloc(1, sizeof(costmodel_series_t));
+	if (s == NULL)
+		return NULL;
+
+	s->set = strdup(set);
+	s->alg = strdup(alg);
+	s->impl = strdup(impl);
+	if (s->set == NULL || s->alg == NULL || s->impl == NULL) {
+		series_destroy(s);
+		return NULL;
+	}
+
+	/* add to link list */
+	if (model->series_tail == NULL)
+		/* first element */
+		model->series_head = s;
+	else
+		model->series_tail->next = s;
+	model->series_tail = s;
+
+	return s;
+}
+
+
+/* same algorithm (and set)? */
+static bool series_same_alg(const costmodel_series_t *a, const costmodel_series_t *b)
+{
+	return strcmp(a->set, b->set) == 0 && strcmp(a->alg, b->alg) == 0;
+}
+
+
+/*
+ * crossover of two implementations
+ * faster .. implementation which is faster from len on
+ */
+struct crossover {
+	double len;
+	const costmodel_series_t *faster;
+	const costmodel_series_t *slower;
+};
+
+
+/*
+ * find next crossover of a and b starting at point index idx of a
+ * crossovers are detected on measured lengths (change of sign of the
+ * difference) and located between them using the fitted models
+ * return: true .. found; false .. no more crossovers
+ */
+static bool series_next_crossover(
+	const costmodel_series_t *a,
+	const costmodel_series_t *b,
+	unsigned int *idx,
+	struct crossover *c)
+{
+	double prev_len = -1;
+	double prev_diff = 0;
+
+	for (; *idx < a->npoints; (*idx)++) {
+		unsigned int len = a->points[*idx].len;
+		double td_b = series_get_td(b, len);
+		if (td_b < 0)
+			continue;
+
+		double td_a = a->points[*idx].td;
+		double diff = td_a - td_b;
+		if (fabs(diff) < COSTMODEL_TIE * fmin(td_a, td_b))
+			diff = 0;
+		if (prev_len >= 0 && diff != 0 && prev_diff != 0 && (diff < 0) != (prev_diff < 0)) {
+			/* sign change -> bisect on model difference */
+			double lo = prev_len;
+			double hi = len;
+			double dlo = series_eval(a, lo) - series_eval(b, lo);
+			double dhi = series_eval(a, hi) - series_eval(b, hi);
+			if ((dlo < 0) != (dhi < 0)) {
+				for (int i = 0; i < 64; i++) {
+					double mid = (lo + hi) / 2;
+					double dmid = series_eval(a, mid) - series_eval(b, mid);
+					if ((dmid < 0) == (dlo < 0))
+						lo = mid;
+					else
+						hi = mid;
+				}
+				c->len = (lo + hi) / 2;
+			} else
+				/* model does not reflect sign change -> interpolate measurements */
+				c->len = prev_len + (len - prev_len) * prev_diff / (prev_diff - diff);
+
+			c->faster = diff < 0 ? a : b;
+			c->slower = diff < 0 ? b : a;
+			return true;
+		}
+
+		if (diff != 0) {
+			prev_len = len;
+			prev_diff = diff;
+		}
+	}
+
+	return false;
+}
+
+
+
+/*
+ * API
+ */
+
+costmodel_t *costmodel_create(void)
+{
+	return calloc(1, sizeof(costmodel_t));
+}
+
+
+void costmodel_destroy(costmodel_t *model)
+{
+	if (model == NULL)
+		return;
+
+	costmodel_series_t *s = model->series_head;
+	while (s != NULL) {
+		costmodel_series_t *n = s->next;
+		series_destroy(s);
+		s = n;
+	}
+
+	free(model);
+}
+
+
+int costmodel_add(
+	costmodel_t *model,
+	const char *set,
+	const char *alg,
+	const char *impl,
+	unsigned int len,
+	long long td_median)
+{
+	if (model == NULL || set == NULL || alg == NULL || impl == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* no useful measurement -> ignore */
+	if (td_median <= 0)
+		return 0;
+
+	costmodel_series_t *s = series_find(model, set, alg, impl);
+	if (s == NULL) {
+		s = series_create(model, set, alg, impl);
+		if (s == NULL)
+			return -1;
+	}
+
+	/* grow points */
+	if (s->npoints == s->max_npoints) {
+		unsigned int max_npoints = s->max_npoints ? s->max_npoints * 2 : 16;
+		costmodel_point_t *points = realloc(s->points, max_npoints * sizeof(costmodel_point_t));
+		if (points == NULL)
+			return -1;
+		s->points = points;
+		s->max_npoints = max_npoints;
+	}
+
+	s->points[s->npoints].len = len;
+	s->points[s->npoints].td = td_median;
+	s->npoints++;
+
+	return 0;
+}
+
+
+int costmodel_fit(costmodel_t *model)
+{
+	if (model == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (
+		costmodel_series_t *s = model->series_head;
+		s != NULL;
+		s = s->next
+	)
+		series_fit(s);
+
+	return 0;
+}
+
+
+int costmodel_print_csv(costmodel_t *model, FILE *out)
+{
+	int ret;
+
+	if (model == NULL || out == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ret = fprintf(out, "record;set;algorithm;implementation;len_from;len_to;knee;setup [ns];per_elem [ns];other_implementation\n");
+	if (ret < 0)
+		return ret;
+
+	/* segments */
+	for (
+		costmodel_series_t *s = model->series_head;
+		s != NULL;
+		s = s->next
+	) {
+		for (unsigned int i = 0; i < s->nsegments; i++) {
+			costmodel_segment_t *seg = &s->segments[i];
+			ret = fprintf(out, "segment;%s;%s;%s;%u;%u;%.0f;%.3f;%.6f;\n",
+				      s->set, s->alg, s->impl,
+				      seg->len_from, seg->len_to, seg->knee,
+				      seg->setup, seg->per_elem);
+			if (ret < 0)
+				return ret;
+		}
+	}
+
+	/* crossovers */
+	for (
+		costmodel_series_t *a = model->series_head;
+		a != NULL;
+		a = a->next
+	) {
+		for (
+			costmodel_series_t *b = a->next;
+			b != NULL;
+			b = b->next
+		) {
+			if (!series_same_alg(a, b))
+				continue;
+
+			unsigned int idx = 0;
+			struct crossover c;
+			while (series_next_crossover(a, b, &idx, &c)) {
+				ret = fprintf(out, "crossover;%s;%s;%s;%.0f;;;;;%s\n",
+					      a->set, a->alg, c.faster->impl,
+					      c.len, c.slower->impl);
+				if (ret < 0)
+					return ret;
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+int costmodel_print_pretty(costmodel_t *model, const char *indent, FILE *out)
+{
+	if (model == NULL || indent == NULL || out == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fprintf(out, "%s+ cost model:\n", indent);
+
+	for (
+		costmodel_series_t *s = model->series_head;
+		s != NULL;
+		s = s->next
+	) {
+		/* first series of algorithm -> print algorithm and crossovers */
+		costmodel_series_t *first = model->series_head;
+		while (!series_same_alg(first, s))
+			first = first->next;
+		if (first != s)
+			continue;
+
+		fprintf(out, "%s  + algorithm: %s\n", indent, s->alg);
+
+		for (
+			costmodel_series_t *a = s;
+			a != NULL;
+			a = a->next
+		) {
+			if (!series_same_alg(a, s))
+				continue;
+
+			fprintf(out, "%s    + implementation: %s\n", indent, a->impl);
+			for (unsigned int i = 0; i < a->nsegments; i++) {
+				costmodel_segment_t *seg = &a->segments[i];
+				fprintf(out, "%s      + len [%u, %u]: setup %.1f ns, %.4f ns/element",
+					indent, seg->len_from, seg->len_to, seg->setup, seg->per_elem);
+				if (i > 0)
+					fprintf(out, " (knee at ~%.0f)", seg->knee);
+				fprintf(out, "\n");
+			}
+		}
+
+		fprintf(out, "%s    + crossovers:\n", indent);
+		for (
+			costmodel_series_t *a = s;
+			a != NULL;
+			a = a->next
+		) {
+			for (
+				costmodel_series_t *b = a->next;
+				b != NULL;
+				b = b->next
+			) {
+				if (!series_same_alg(a, s) || !series_same_alg(b, s))
+					continue;
+
+				unsigned int idx = 0;
+				struct crossover c;
+				while (series_next_crossover(a, b, &idx, &c))
+					fprintf(out, "%s      + %s beats %s from len ~%.0f\n",
+						indent, c.faster->impl, c.slower->impl, c.len);
+			}
+		}
+	}
+
+	return 0;
+}
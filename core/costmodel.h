@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef COSTMODEL_H
+#define COSTMODEL_H
+
+#include <stdio.h>
+
+
+/*
+ * Cost model fitting over lengths
+ *
+ * Collects the median run-times of each implementation over all lengths
+ * and fits a piecewise-linear model
+ *   t(len) = setup + per_elem * len
+ * with one line per segment. Segments are split at knees, where the
+ * linear model does not fit anymore (e.g. when the working set exceeds
+ * a cache level).
+ *
+ * Crossover lengths between implementations of the same algorithm are
+ * determined from the fitted models.
+ *
+ * Usage example
+ *
+ * costmodel_t *model = costmodel_create();
+ * loop {
+ *	costmodel_add(model, set, alg, impl, len, median);
+ * }
+ * costmodel_fit(model);
+ * costmodel_print_pretty(model, "  ", stderr);
+ * costmodel_destroy(model);
+ */
+
+
+/*
+ * maximum number of segments per implementation
+ */
+#define COSTMODEL_MAX_SEGMENTS	8
+
+
+typedef struct costmodel_point {
+	unsigned int len;
+	double td;				// median run-time [ns]
+} costmodel_point_t;
+
+
+typedef struct costmodel_segment {
+	unsigned int len_from;			// first length in segment
+	unsigned int len_to;			// last length in segment
+	double setup;				// fixed overhead [ns]
+	double per_elem;			// cost per element [ns]
+	double knee;				// estimated knee (start of segment); 0 on first segment
+} costmodel_segment_t;
+
+
+typedef struct costmodel_series {
+	char *set;
+	char *alg;
+	char *impl;
+
+	costmodel_point_t *points;		// measurements (sorted by len after fit)
+	unsigned int npoints;
+	unsigned int max_npoints;
+
+	costmodel_segment_t segments[COSTMODEL_MAX_SEGMENTS];
+	unsigned int nsegments;
+
+	struct costmodel_series *next;
+} costmodel_series_t;
+
+
+typedef struct costmodel {
+	// linked list of series (one per implementation)
+	costmodel_series_t *series_head;
+	costmodel_series_t *series_tail;
+} costmodel_t;
+
+
+/*
+ * create an empty cost model
+ * return: NULL on error (errno)
+ */
+costmodel_t *costmodel_create(void);
+
+
+/*
+ * destroy cost model
+ */
+void costmodel_destroy(costmodel_t *model);
+
+
+/*
+ * add measurement of an implementation
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int costmodel_add(
+	costmodel_t *model,
+	const char *set,
+	const char *alg,
+	const char *impl,
+	unsigned int len,
+	long long td_median);
+
+
+/*
+ * fit the models of all implementations
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int costmodel_fit(costmodel_t *model);
+
+
+/*
+ * print fitted models and crossovers as csv
+ * return: <0 .. error (errno)
+ */
+int costmodel_print_csv(costmodel_t *model, FILE *out);
+
+
+/*
+ * print fitted models and crossovers human readable
+ * return: <0 .. error (errno)
+ */
+int costmodel_print_pretty(costmodel_t *model, const char *indent, FILE *out);
+
+
+#endif /* COSTMODEL_H */
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include <core/icount.h>
+
+
+icount_t *icount_open(const char *path)
+{
+	icount_counts_t probe;
+
+	if (path == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+#if !defined(__riscv)
+	/* markers are RISC-V instructions */
+	errno = ENOTSUP;
+	return NULL;
+#endif /* __riscv */
+
+	icount_t *icount = calloc(1, sizeof(icount_t));
+	if (icount == NULL)
+		return NULL;
+
+	icount->f = fopen(path, "r");
+	if (icount->f == NULL)
+		goto __err;
+
+	/* counts of the probe are discarded */
+	icount_start();
+	icount_stop();
+	if (icount_read(icount, &probe) < 0)
+		goto __err;
+
+	return icount;
+
+__err:
+	icount_close(icount);
+	return NULL;
+}
+
+
+int icount_read(icount_t *icount, icount_counts_t *counts)
+{
+	char line[128];
+
+	if (icount == NULL || counts == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* file is appended by the plugin -> continue after eof */
+	clearerr(icount->f);
+	if (fgets(line, sizeof(line), icount->f) == NULL) {
+		errno = ENODATA;
+		return -1;
+	}
+
+	if (sscanf(line, "%" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64,
+		   &counts->scalar, &counts->vconfig, &counts->vmem, &counts->varith) != 4) {
+		errno = EBADMSG;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+void icount_add(icount_counts_t *sum, const icount_counts_t *counts)
+{
+	sum->scalar += counts->scalar;
+	sum->vconfig += counts->vconfig;
+	sum->vmem += counts->vmem;
+	sum->varith += counts->varith;
+}
+
+
+void icount_close(icount_t *icount)
+{
+	if (icount == NULL)
+		return;
+	if (icount->f != NULL)
+		fclose(icount->f);
+	free(icount);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef ICOUNT_H
+#define ICOUNT_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*
+ * Instruction counts (qemu profiling mode)
+ *
+ * RVVRadar is run under qemu-riscv64 with the TCG plugin
+ * tools/qemu_icount.c, which counts the dynamically executed instructions
+ * between a start and a stop marker and appends them as line
+ * "<scalar> <vconfig> <vmem> <varith>\n" to a counts file.
+ * The markers are HINT instructions (slti zero, zero, <imm>; no
+ * architectural effect) placed around the measured execution of an
+ * implementation. The plugin writes the line when the stop marker is
+ * executed -> the counts of the last execution are read from the file
+ * directly after the stop marker (icount_read).
+ *
+ * The counts are independent of the host (deterministic) and can be used
+ * as cost metric of the RVV implementations without RVV hardware.
+ */
+
+
+/* immediates of the markers (slti zero, zero, <imm>) */
+#define ICOUNT_MARKER_START_IMM		0x5a0
+#define ICOUNT_MARKER_STOP_IMM		0x5a1
+
+/* encodings of the markers (matched by the plugin) */
+#define ICOUNT_MARKER_INSN(_imm_)	(((uint32_t)(_imm_) << 20) | (0x2 << 12) | 0x13)
+#define ICOUNT_MARKER_START		ICOUNT_MARKER_INSN(ICOUNT_MARKER_START_IMM)
+#define ICOUNT_MARKER_STOP		ICOUNT_MARKER_INSN(ICOUNT_MARKER_STOP_IMM)
+
+/* stringify helpers for inline assembly */
+#define ICOUNT_STR(_x_)			#_x_
+#define ICOUNT_XSTR(_x_)		ICOUNT_STR(_x_)
+
+
+/* classes of counted instructions */
+typedef struct icount_counts {
+	uint64_t scalar;			// scalar instructions (integer, fp, branches, ...)
+	uint64_t vconfig;			// vector configuration (vsetvli, vsetivli, vsetvl)
+	uint64_t vmem;				// vector loads and stores
+	uint64_t varith;			// all other vector instructions
+} icount_counts_t;
+
+
+typedef struct icount {
+	FILE *f;				// counts file written by the plugin
+} icount_t;
+
+
+/* start marker */
+static inline void icount_start(void)
+{
+#if defined(__riscv)
+	__asm__ __volatile__("slti zero, zero, " ICOUNT_XSTR(ICOUNT_MARKER_START_IMM) ::: "memory");
+#endif /* __riscv */
+}
+
+
+/* stop marker (counts are available for icount_read afterwards) */
+static inline void icount_stop(void)
+{
+#if defined(__riscv)
+	__asm__ __volatile__("slti zero, zero, " ICOUNT_XSTR(ICOUNT_MARKER_STOP_IMM) ::: "memory");
+#endif /* __riscv */
+}
+
+
+/*
+ * open counts file written by the plugin
+ * A probe (empty region) is counted to check that RVVRadar is running
+ * under qemu with the plugin writing to the given file.
+ * return: NULL on error (errno; ENOTSUP .. no RISC-V build,
+ *         ENODATA .. no counts written for the probe)
+ */
+icount_t *icount_open(const char *path);
+
+
+/*
+ * read counts of the last region (after icount_stop)
+ * return: 0 on success; <0 on error (errno; ENODATA .. no counts)
+ */
+int icount_read(icount_t *icount, icount_counts_t *counts);
+
+
+/* add counts */
+void icount_add(icount_counts_t *sum, const icount_counts_t *counts);
+
+
+/* close counts file */
+void icount_close(icount_t *icount);
+
+#endif /* ICOUNT_H */
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include <core/isolate.h>
+
+
+/*
+ * wait for termination of child (SIGCHLD blocked by caller)
+ * return: 0 .. terminated; 1 .. timeout; <0 .. error
+ */
+static int isolate_wait(pid_t pid, unsigned int timeout, int *wstatus)
+{
+	struct timespec deadline, now, remaining;
+	sigset_t set;
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGCHLD);
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += timeout;
+
+	while (1) {
+		/* SIGCHLD could also be caused by other children -> check */
+		pid_t r = waitpid(pid, wstatus, WNOHANG);
+		if (r < 0)
+			return -1;
+		if (r == pid)
+			return 0;
+
+		if (timeout == 0) {
+			if (sigwaitinfo(&set, NULL) < 0 && errno != EINTR)
+				return -1;
+			continue;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		remaining.tv_sec = deadline.tv_sec - now.tv_sec;
+		remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+		if (remaining.tv_nsec < 0) {
+			remaining.tv_sec--;
+			remaining.tv_nsec += 1000000000;
+		}
+		if (remaining.tv_sec < 0)
+			return 1;
+
+		if (sigtimedwait(&set, NULL, &remaining) < 0 &&
+		    errno != EAGAIN && errno != EINTR)
+			return -1;
+	}
+}
+
+
+
+/*
+ * API
+ */
+
+void *isolate_shm_alloc(size_t len)
+{
+	void *shm = mmap(NULL, len, PROT_READ | PROT_WRITE,
+			 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shm == MAP_FAILED)
+		return NULL;
+	return shm;
+}
+
+
+void isolate_shm_free(void *shm, size_t len)
+{
+	if (shm == NULL)
+		return;
+	munmap(shm, len);
+}
+
+
+int isolate_run(isolate_fp_t fn, void *shm, void *arg, unsigned int timeout,
+		isolate_status_t *status)
+{
+	sigset_t set, oldset;
+	int wstatus = 0;
+	int ret = -1;
+
+	if (fn == NULL || status == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	memset(status, 0, sizeof(*status));
+
+	/* SIGCHLD is received synchronously (see isolate_wait) */
+	sigemptyset(&set);
+	sigaddset(&set, SIGCHLD);
+	if (sigprocmask(SIG_BLOCK, &set, &oldset) < 0)
+		return -1;
+
+	/* nothing pending in stdio buffers of the child */
+	fflush(stdout);
+	fflush(stderr);
+
+	pid_t pid = fork();
+	if (pid < 0)
+		goto __ret;
+	if (pid == 0) {
+		sigprocmask(SIG_SETMASK, &oldset, NULL);
+		_exit(fn(shm, arg));
+	}
+
+	int r = isolate_wait(pid, timeout, &wstatus);
+	if (r < 0) {
+		kill(pid, SIGKILL);
+		waitpid(pid, NULL, 0);
+		goto __ret;
+	}
+	if (r == 1) {
+		/* watchdog */
+		kill(pid, SIGKILL);
+		waitpid(pid, NULL, 0);
+		status->timeout = true;
+		status->signal = SIGKILL;
+	} else if (WIFSIGNALED(wstatus))
+		status->signal = WTERMSIG(wstatus);
+	else
+		status->exit_code = WEXITSTATUS(wstatus);
+
+	ret = 0;
+
+__ret:
+	sigprocmask(SIG_SETMASK, &oldset, NULL);
+	return ret;
+}
+
+
+const char *isolate_signal_str(int signal)
+{
+	static char buf[16];
+
+	switch (signal) {
+	case SIGILL:
+		return "SIGILL";
+	case SIGSEGV:
+		return "SIGSEGV";
+	case SIGBUS:
+		return "SIGBUS";
+	case SIGFPE:
+		return "SIGFPE";
+	case SIGABRT:
+		return "SIGABRT";
+	case SIGTRAP:
+		return "SIGTRAP";
+	case SIGKILL:
+		return "SIGKILL";
+	default:
+		snprintf(buf, sizeof(buf), "SIG%i", signal);
+		return buf;
+	}
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef ISOLATE_H
+#define ISOLATE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+
+/*
+ * Isolated execution in a forked child process
+ *
+ * The function is executed in a child process (fresh copy of the address
+ * space of the parent). Results are transferred via a shared memory area
+ * (allocated with isolate_shm_alloc before; visible to parent and child).
+ * Crashes (e.g. SIGILL, SIGSEGV) of the child do not affect the parent. A
+ * watchdog kills the child (SIGKILL) if it does not finish in time.
+ *
+ * The child terminates with _exit -> stdio buffers of the parent are not
+ * flushed twice.
+ */
+
+
+/* status of isolated execution */
+typedef struct isolate_status {
+	int exit_code;				// exit code of function (if not signaled)
+	int signal;				// terminating signal (0 .. none)
+	bool timeout;				// killed by watchdog
+} isolate_status_t;
+
+
+/*
+ * function to execute isolated
+ * return: exit code of child
+ */
+typedef int (*isolate_fp_t)(void *shm, void *arg);
+
+
+/*
+ * allocate shared memory area (zero initialized)
+ * return: NULL on error (errno)
+ */
+void *isolate_shm_alloc(size_t len);
+
+
+/*
+ * free shared memory area
+ */
+void isolate_shm_free(void *shm, size_t len);
+
+
+/*
+ * run fn(shm, arg) in a child process and wait for it
+ *   * timeout .. watchdog timeout in seconds (0 .. none)
+ * return: 0 .. child terminated (see status); <0 .. error (errno)
+ */
+int isolate_run(isolate_fp_t fn, void *shm, void *arg, unsigned int timeout,
+		isolate_status_t *status);
+
+
+/*
+ * name of signal (e.g. "SIGILL")
+ */
+const char *isolate_signal_str(int signal);
+
+
+#endif /* ISOLATE_H */
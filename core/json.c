@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <core/json.h>
+
+
+/* print len characters of str escaped (without quotes) */
+static int json_print_escaped(FILE *out, const char *str, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = str[i];
+		int ret;
+
+		if (c == '"' || c == '\\')
+			ret = fprintf(out, "\\%c", c);
+		else if (c < 0x20)
+			ret = fprintf(out, "\\u%04x", c);
+		else
+			ret = fputc(c, out);
+		if (ret < 0)
+			return -1;
+	}
+	return 0;
+}
+
+
+int json_print_str(FILE *out, const char *str)
+{
+	if (out == NULL || str == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (fputc('"', out) < 0)
+		return -1;
+	if (json_print_escaped(out, str, strlen(str)) < 0)
+		return -1;
+	if (fputc('"', out) < 0)
+		return -1;
+	return 0;
+}
+
+
+int json_print_kv_str(FILE *out, const char *key, const char *value)
+{
+	if (json_print_str(out, key) < 0)
+		return -1;
+	if (fputc(':', out) < 0)
+		return -1;
+	return json_print_str(out, value);
+}
+
+
+int json_print_parastr(FILE *out, const char *parastr)
+{
+	if (out == NULL || parastr == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fputc('{', out);
+	for (const char *p = parastr; *p != '\0'; ) {
+		size_t len = strcspn(p, ",");
+		const char *eq = memchr(p, '=', len);
+
+		if (p != parastr)
+			fputc(',', out);
+
+		/* key */
+		size_t keylen = eq ? eq - p : len;
+		fputc('"', out);
+		json_print_escaped(out, p, keylen);
+		fputs("\":", out);
+
+		/* value (number or string) */
+		const char *val = eq ? eq + 1 : p + len;
+		size_t vallen = eq ? len - keylen - 1 : 0;
+		if (
+			vallen > 0 && strspn(val, "0123456789") >= vallen &&
+			(val[0] != '0' || vallen == 1)
+		) {
+			fwrite(val, 1, vallen, out);
+		} else {
+			fputc('"', out);
+			json_print_escaped(out, val, vallen);
+			fputc('"', out);
+		}
+
+		p += len;
+		if (*p == ',')
+			p++;
+	}
+	if (fputc('}', out) < 0)
+		return -1;
+
+	return 0;
+}
+
+
+/* find value of key in line (pointer to first character of value) */
+static const char *json_find_value(const char *line, const char *key)
+{
+	size_t keylen = strlen(key);
+
+	for (const char *p = strchr(line, '"'); p != NULL; p = strchr(p + 1, '"'))
+		if (strncmp(p + 1, key, keylen) == 0 && p[keylen + 1] == '"' && p[keylen + 2] == ':')
+			return p + keylen + 3;
+
+	return NULL;
+}
+
+
+/*
+ * parse string at str (starting with quote) to buf
+ * return: pointer behind closing quote; NULL on error
+ */
+static const char *json_parse_str(const char *str, char *buf, size_t len)
+{
+	size_t n = 0;
+
+	if (*str++ != '"')
+		return NULL;
+
+	while (*str != '"') {
+		char c = *str++;
+		if (c == '\0')
+			return NULL;
+		if (c == '\\') {
+			c = *str++;
+			if (c == 'u') {
+				unsigned int u;
+				if (sscanf(str, "%4x", &u) != 1)
+					return NULL;
+				c = u;
+				str += 4;
+			} else if (c == 'n') {
+				c = '\n';
+			} else if (c == 't') {
+				c = '\t';
+			} else if (c == '\0') {
+				return NULL;
+			}
+		}
+		if (n + 1 < len)
+			buf[n++] = c;
+	}
+	if (len > 0)
+		buf[n] = '\0';
+
+	return str + 1;
+}
+
+
+int json_get_str(const char *line, const char *key, char *buf, size_t len)
+{
+	if (line == NULL || key == NULL || buf == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	const char *val = json_find_value(line, key);
+	if (val == NULL || json_parse_str(val, buf, len) == NULL) {
+		errno = EBADMSG;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int json_get_num(const char *line, const char *key, double *value)
+{
+	if (line == NULL || key == NULL || value == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	const char *val = json_find_value(line, key);
+	char *end = NULL;
+	if (val != NULL)
+		*value = strtod(val, &end);
+	if (val == NULL || end == val) {
+		errno = EBADMSG;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+int json_get_parastr(const char *line, const char *key, char *buf, size_t len)
+{
+	if (line == NULL || key == NULL || buf == NULL || len == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	const char *p = json_find_value(line, key);
+	if (p == NULL || *p++ != '{')
+		goto __err_format;
+
+	size_t pos = 0;
+	buf[0] = '\0';
+	while (*p != '}') {
+		char name[256], value[256];
+
+		if (pos > 0 && *p++ != ',')
+			goto __err_format;
+
+		p = json_parse_str(p, name, sizeof(name));
+		if (p == NULL || *p++ != ':')
+			goto __err_format;
+
+		if (*p == '"') {
+			p = json_parse_str(p, value, sizeof(value));
+			if (p == NULL)
+				goto __err_format;
+		} else {
+			size_t n = strcspn(p, ",}");
+			if (n == 0 || n >= sizeof(value))
+				goto __err_format;
+			memcpy(value, p, n);
+			value[n] = '\0';
+			p += n;
+		}
+
+		pos += snprintf(buf + pos, pos < len ? len - pos : 0, "%s%s=%s",
+				pos ? "," : "", name, value);
+	}
+
+	return 0;
+
+__err_format:
+	errno = EBADMSG;
+	return -1;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef JSON_H
+#define JSON_H
+
+#include <stdio.h>
+
+
+/*
+ * Minimal helpers to write and read JSON (JSON Lines output)
+ *
+ * Reading is limited to flat records as written by RVVRadar: values are
+ * looked up by key in a single line (first occurrence of "key":).
+ */
+
+
+/*
+ * print string as quoted and escaped JSON string
+ * return: <0 .. error
+ */
+int json_print_str(FILE *out, const char *str);
+
+
+/*
+ * print key and string value ("key":"value")
+ * return: <0 .. error
+ */
+int json_print_kv_str(FILE *out, const char *key, const char *value);
+
+
+/*
+ * print parameter string ("<name>=<value>,...") as JSON object
+ * values consisting only of digits are printed as numbers, all others as
+ * strings
+ * return: <0 .. error
+ */
+int json_print_parastr(FILE *out, const char *parastr);
+
+
+/*
+ * get string value of key from record (unescaped)
+ * return: 0 .. ok; <0 .. not found or invalid (errno)
+ */
+int json_get_str(const char *line, const char *key, char *buf, size_t len);
+
+
+/*
+ * get numeric value of key from record
+ * return: 0 .. ok; <0 .. not found or invalid (errno)
+ */
+int json_get_num(const char *line, const char *key, double *value);
+
+
+/*
+ * get flat object value of key from record as parameter string
+ * ("<name>=<value>,..."; reverse of json_print_parastr)
+ * return: 0 .. ok; <0 .. not found or invalid (errno)
+ */
+int json_get_parastr(const char *line, const char *key, char *buf, size_t len);
+
+
+#endif /* JSON_H */
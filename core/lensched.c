@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <core/sysinfo.h>
+#include <core/lensched.h>
+
+
+/* append len to schedule */
+static int lensched_append(lensched_t *lensched, unsigned long long len)
+{
+	if (len == 0 || len > UINT32_MAX) {
+		errno = ERANGE;
+		return -1;
+	}
+
+	if (lensched->nlens == LENSCHED_MAX_LENS) {
+		errno = E2BIG;
+		return -1;
+	}
+
+	lensched->lens[lensched->nlens++] = len;
+	return 0;
+}
+
+
+static int lensched_expand_geo(lensched_t *lensched, const char *args)
+{
+	unsigned int start, end;
+	double factor;
+	int pos = 0;
+
+	if (
+		sscanf(args, "%u:%u:%lf%n", &start, &end, &factor, &pos) != 3 ||
+		args[pos] != '\0' || start == 0 || end < start || factor <= 1.0
+	) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (unsigned long long len = start; len <= end; ) {
+		if (lensched_append(lensched, len) < 0)
+			return -1;
+
+		/* ensure progress on small factors */
+		unsigned long long next = len * factor;
+		len = next > len ? next : len + 1;
+	}
+
+	return 0;
+}
+
+
+static int lensched_expand_lin(lensched_t *lensched, const char *args)
+{
+	unsigned int start, end, step;
+	int pos = 0;
+
+	if (
+		sscanf(args, "%u:%u:%u%n", &start, &end, &step, &pos) != 3 ||
+		args[pos] != '\0' || start == 0 || end < start || step == 0
+	) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (unsigned long long len = start; len <= end; len += step)
+		if (lensched_append(lensched, len) < 0)
+			return -1;
+
+	return 0;
+}
+
+
+static int lensched_expand_list(lensched_t *lensched, const char *args)
+{
+	while (*args != '\0') {
+		unsigned int len;
+		int pos = 0;
+
+		if (sscanf(args, "%u%n", &len, &pos) != 1) {
+			errno = EINVAL;
+			return -1;
+		}
+		args += pos;
+
+		if (lensched_append(lensched, len) < 0)
+			return -1;
+
+		if (*args == ',')
+			args++;
+		else if (*args != '\0') {
+			errno = EINVAL;
+			return -1;
+		}
+	}
+
+	if (lensched->nlens == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static int lensched_expand_vlen(lensched_t *lensched, const char *args)
+{
+	unsigned int kstart, kend, delta = 1;
+	int pos = 0;
+
+	if (sscanf(args, "%u:%u%n", &kstart, &kend, &pos) != 2) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (args[pos] == ':') {
+		args += pos + 1;
+		pos = 0;
+		if (sscanf(args, "%u%n", &delta, &pos) != 1) {
+			errno = EINVAL;
+			return -1;
+		}
+	}
+	if (args[pos] != '\0' || kend < kstart) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* VLMAX of e8/m1 */
+	unsigned int vlmax = sysinfo_get_vlen() / 8;
+	if (vlmax == 0) {
+		/* no rvv */
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	for (unsigned long long k = kstart; k <= kend; k++) {
+		unsigned long long len = k * vlmax;
+		if (len > delta && delta > 0)
+			if (lensched_append(lensched, len - delta) < 0)
+				return -1;
+		if (len > 0)
+			if (lensched_append(lensched, len) < 0)
+				return -1;
+		if (delta > 0)
+			if (lensched_append(lensched, len + delta) < 0)
+				return -1;
+	}
+
+	return 0;
+}
+
+
+static int lensched_expand_rand(lensched_t *lensched, const char *args)
+{
+	unsigned int min, max, count, seed = 0;
+	int pos = 0;
+
+	if (sscanf(args, "%u:%u:%u%n", &min, &max, &count, &pos) != 3) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (args[pos] == ':') {
+		args += pos + 1;
+		pos = 0;
+		if (sscanf(args, "%u%n", &seed, &pos) != 1) {
+			errno = EINVAL;
+			return -1;
+		}
+	}
+	if (args[pos] != '\0' || min == 0 || max < min || count == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* make default seed explicit -> recorded spec reproduces the lengths */
+	char *spec;
+	if (asprintf(&spec, "rand:%u:%u:%u:%u", min, max, count, seed) < 0)
+		return -1;
+	free(lensched->spec);
+	lensched->spec = spec;
+
+	/*
+	 * own generator (xorshift64) -> schedule is independent of the
+	 * random number generation of the algorithms
+	 */
+	uint64_t state = 0x9e3779b97f4a7c15ULL ^ seed;
+	for (unsigned int i = 0; i < count; i++) {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		if (lensched_append(lensched, min + state % ((uint64_t)max - min + 1)) < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+
+
+/*
+ * API
+ */
+
+lensched_t *lensched_create(const char *spec)
+{
+	static const struct {
+		const char *name;
+		int (*expand)(lensched_t *lensched, const char *args);
+	} types[] = {
+		{ "geo",	lensched_expand_geo	},
+		{ "lin",	lensched_expand_lin	},
+		{ "list",	lensched_expand_list	},
+		{ "vlen",	lensched_expand_vlen	},
+		{ "rand",	lensched_expand_rand	},
+	};
+
+	if (spec == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	lensched_t *lensched = calloc(1, sizeof(lensched_t));
+	if (lensched == NULL)
+		return NULL;
+
+	lensched->spec = strdup(spec);
+	lensched->lens = calloc(LENSCHED_MAX_LENS, sizeof(unsigned int));
+	if (lensched->spec == NULL || lensched->lens == NULL)
+		goto __err;
+
+	const char *args = strchr(spec, ':');
+	if (args == NULL) {
+		errno = EINVAL;
+		goto __err;
+	}
+
+	int ret = -1;
+	errno = EINVAL;
+	for (int i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+		if (
+			strlen(types[i].name) == args - spec &&
+			strncmp(spec, types[i].name, args - spec) == 0
+		) {
+			ret = types[i].expand(lensched, args + 1);
+			break;
+		}
+	if (ret < 0)
+		goto __err;
+
+	/* shrink to fit */
+	unsigned int *lens = realloc(lensched->lens, lensched->nlens * sizeof(unsigned int));
+	if (lens != NULL)
+		lensched->lens = lens;
+
+	return lensched;
+
+__err:
+	lensched_destroy(lensched);
+	return NULL;
+}
+
+
+void lensched_destroy(lensched_t *lensched)
+{
+	if (lensched == NULL)
+		return;
+	free(lensched->spec);
+	free(lensched->lens);
+	free(lensched);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef LENSCHED_H
+#define LENSCHED_H
+
+
+/*
+ * Length schedules
+ *
+ * A schedule defines the lengths (number of elements) the algorithms are
+ * run with. Schedules are given as string in one of the following forms:
+ *
+ *   geo:<start>:<end>:<factor>
+ *	geometric from start to end; multiplied by factor (>1.0) per step
+ *	(e.g. geo:64:65536:2 .. 64, 128, 256, ..., 65536)
+ *   lin:<start>:<end>:<step>
+ *	linear from start to end; incremented by step
+ *	(e.g. lin:1000:5000:1000 .. 1000, 2000, ..., 5000)
+ *   list:<len>[,<len>...]
+ *	explicit list of lengths
+ *	(e.g. list:5760,15360 .. e.g. 1920*3 and 3840*4 bytes)
+ *   vlen:<kstart>:<kend>[:<delta>]
+ *	multiples of VLMAX (elements of e8/m1) and neighbors
+ *	k*VLMAX-delta, k*VLMAX, k*VLMAX+delta for k in [kstart, kend]
+ *	(delta defaults to 1; requires rvv)
+ *   rand:<min>:<max>:<count>[:<seed>]
+ *	count uniformly distributed random lengths in [min, max]
+ *	(seed defaults to 0)
+ */
+
+
+/*
+ * maximum number of lengths in a schedule
+ */
+#define LENSCHED_MAX_LENS	65536
+
+
+typedef struct lensched {
+	char *spec;				// schedule specification string (seed of rand explicit)
+	unsigned int *lens;			// expanded lengths
+	unsigned int nlens;			// number of lengths
+} lensched_t;
+
+
+/*
+ * create a schedule from specification string (see above)
+ * return: NULL on error (errno)
+ */
+lensched_t *lensched_create(const char *spec);
+
+
+/*
+ * destroy schedule
+ */
+void lensched_destroy(lensched_t *lensched);
+
+
+#endif /* LENSCHED_H */
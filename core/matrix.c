@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <core/matrix.h>
+
+
+static void matrix_entry_destroy(matrix_entry_t *entry)
+{
+	if (entry == NULL)
+		return;
+	for (int i = 0; i < PARAM_MAX; i++)
+		free(entry->values[i]);
+	free(entry->lens);
+	free(entry);
+}
+
+
+static const alg_desc_t *matrix_find_desc(matrix_t *matrix, const char *name, size_t namelen)
+{
+	for (int i = 0; i < matrix->ndescs; i++)
+		if (
+			strlen(matrix->descs[i]->name) == namelen &&
+			strncmp(matrix->descs[i]->name, name, namelen) == 0
+		)
+			return matrix->descs[i];
+	return NULL;
+}
+
+
+/*
+ * parse comma separated value list
+ * desc == NULL .. parse lengths (uint > 0)
+ */
+static int matrix_parse_values(
+	const param_desc_t *desc,
+	char *str,
+	unsigned int **values,
+	unsigned int *nvalues)
+{
+	/* upper bound for number of values */
+	unsigned int max = 1;
+	for (char *c = str; *c != '\0'; c++)
+		if (*c == ',')
+			max++;
+
+	unsigned int *v = calloc(max, sizeof(unsigned int));
+	if (v == NULL)
+		return -1;
+
+	unsigned int n = 0;
+	char *saveptr = NULL;
+	for (char *tok = strtok_r(str, ",", &saveptr); tok != NULL; tok = strtok_r(NULL, ",", &saveptr)) {
+		if (desc != NULL) {
+			if (param_parse_value(desc, tok, &v[n]) < 0)
+				goto __err;
+		} else {
+			int pos = 0;
+			if (sscanf(tok, "%u%n", &v[n], &pos) != 1 || tok[pos] != '\0' || v[n] == 0) {
+				errno = EINVAL;
+				goto __err;
+			}
+		}
+		n++;
+	}
+	if (n == 0) {
+		errno = EINVAL;
+		goto __err;
+	}
+
+	*values = v;
+	*nvalues = n;
+	return 0;
+
+__err:
+	free(v);
+	return -1;
+}
+
+
+/* lengths of entry */
+static const unsigned int *matrix_entry_lens(const matrix_t *matrix, const matrix_entry_t *entry, unsigned int *nlens)
+{
+	if (entry->lens != NULL) {
+		*nlens = entry->nlens;
+		return entry->lens;
+	}
+	*nlens = matrix->lensched->nlens;
+	return matrix->lensched->lens;
+}
+
+
+/* number of length steps over all entries */
+static unsigned int matrix_nsteps(const matrix_t *matrix)
+{
+	unsigned int nsteps = 0;
+	for (matrix_entry_t *e = matrix->entries_head; e != NULL; e = e->next) {
+		unsigned int nlens;
+		matrix_entry_lens(matrix, e, &nlens);
+		if (nlens > nsteps)
+			nsteps = nlens;
+	}
+	return nsteps;
+}
+
+
+/*
+ * advance to next combination of values of current entry
+ * return: true .. ok; false .. all combinations done (indices are reset)
+ */
+static bool matrix_next_values(matrix_t *matrix)
+{
+	const alg_desc_t *desc = matrix->entry->desc;
+
+	for (int i = desc->nparams - 1; i >= 0; i--) {
+		if (++matrix->idx[i] < matrix->entry->nvalues[i])
+			return true;
+		matrix->idx[i] = 0;
+	}
+	return false;
+}
+
+
+/*
+ * advance to the next entry which has a length at the current step
+ * (continues with next step at end of entries)
+ * return: true .. ok; false .. end of matrix
+ */
+static bool matrix_next_entry(matrix_t *matrix, unsigned int nsteps)
+{
+	while (matrix->step < nsteps) {
+		if (matrix->entry == NULL)
+			matrix->entry = matrix->entries_head;
+		else
+			matrix->entry = matrix->entry->next;
+
+		if (matrix->entry == NULL) {
+			/* next step */
+			matrix->step++;
+			continue;
+		}
+
+		unsigned int nlens;
+		matrix_entry_lens(matrix, matrix->entry, &nlens);
+		if (matrix->step < nlens)
+			return true;
+	}
+	return false;
+}
+
+
+/*
+ * API
+ */
+
+matrix_t *matrix_create(
+	const alg_desc_t * const *descs,
+	unsigned int ndescs,
+	const lensched_t *lensched)
+{
+	if (descs == NULL || lensched == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	for (int i = 0; i < ndescs; i++)
+		if (descs[i]->nparams > PARAM_MAX || descs[i]->add == NULL) {
+			errno = EINVAL;
+			return NULL;
+		}
+
+	matrix_t *matrix = calloc(1, sizeof(matrix_t));
+	if (matrix == NULL)
+		return NULL;
+
+	matrix->descs = descs;
+	matrix->ndescs = ndescs;
+	matrix->lensched = lensched;
+
+	return matrix;
+}
+
+
+void matrix_destroy(matrix_t *matrix)
+{
+	if (matrix == NULL)
+		return;
+
+	matrix_entry_t *e = matrix->entries_head;
+	while (e != NULL) {
+		matrix_entry_t *next = e->next;
+		matrix_entry_destroy(e);
+		e = next;
+	}
+	free(matrix);
+}
+
+
+int matrix_add(matrix_t *matrix, const char *spec)
+{
+	if (matrix == NULL || spec == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	char *buf = strdup(spec);
+	if (buf == NULL)
+		return -1;
+
+	matrix_entry_t *entry = calloc(1, sizeof(matrix_entry_t));
+	if (entry == NULL)
+		goto __err;
+
+	/* algorithm */
+	char *saveptr = NULL;
+	char *tok = strtok_r(buf, ":", &saveptr);
+	if (tok == NULL) {
+		errno = EINVAL;
+		goto __err;
+	}
+	entry->desc = matrix_find_desc(matrix, tok, strlen(tok));
+	if (entry->desc == NULL) {
+		errno = EINVAL;
+		goto __err;
+	}
+	const alg_desc_t *desc = entry->desc;
+
+	/* parameters */
+	while ((tok = strtok_r(NULL, ":", &saveptr)) != NULL) {
+		char *valstr = strchr(tok, '=');
+		if (valstr == NULL) {
+			errno = EINVAL;
+			goto __err;
+		}
+		*valstr++ = '\0';
+
+		if (strcmp(tok, "len") == 0) {
+			if (entry->lens != NULL) {
+				errno = EINVAL;
+				goto __err;
+			}
+			if (matrix_parse_values(NULL, valstr, &entry->lens, &entry->nlens) < 0)
+				goto __err;
+			continue;
+		}
+
+		int i;
+		for (i = 0; i < desc->nparams; i++)
+			if (strcmp(desc->params[i].name, tok) == 0)
+				break;
+		if (i == desc->nparams || entry->values[i] != NULL) {
+			/* unknown or given twice */
+			errno = EINVAL;
+			goto __err;
+		}
+		if (matrix_parse_values(&desc->params[i], valstr, &entry->values[i], &entry->nvalues[i]) < 0)
+			goto __err;
+	}
+
+	/* defaults for parameters not given */
+	for (int i = 0; i < desc->nparams; i++) {
+		if (entry->values[i] != NULL)
+			continue;
+		entry->values[i] = calloc(desc->params[i].ndefaults, sizeof(unsigned int));
+		if (entry->values[i] == NULL)
+			goto __err;
+		memcpy(entry->values[i], desc->params[i].defaults,
+		       desc->params[i].ndefaults * sizeof(unsigned int));
+		entry->nvalues[i] = desc->params[i].ndefaults;
+	}
+
+	/* append to list */
+	if (matrix->entries_head == NULL)
+		matrix->entries_head = entry;
+	else
+		matrix->entries_tail->next = entry;
+	matrix->entries_tail = entry;
+	matrix->entries_len++;
+
+	free(buf);
+	return 0;
+
+__err:
+	matrix_entry_destroy(entry);
+	free(buf);
+	return -1;
+}
+
+
+int matrix_add_next(algset_t *algset, void *arg)
+{
+	matrix_t *matrix = arg;
+
+	if (matrix == NULL || algset == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* next combination of values or next entry */
+	if (matrix->entry == NULL || !matrix_next_values(matrix))
+		if (!matrix_next_entry(matrix, matrix_nsteps(matrix)))
+			return 0;
+
+	const alg_desc_t *desc = matrix->entry->desc;
+	unsigned int values[PARAM_MAX];
+	for (int i = 0; i < desc->nparams; i++)
+		values[i] = matrix->entry->values[i][matrix->idx[i]];
+
+	unsigned int nlens;
+	const unsigned int *lens = matrix_entry_lens(matrix, matrix->entry, &nlens);
+
+	if (desc->add(algset, lens[matrix->step], values) < 0)
+		return -1;
+
+	return 1;
+}
+
+
+unsigned long matrix_count(const matrix_t *matrix)
+{
+	unsigned long count = 0;
+
+	if (matrix == NULL)
+		return 0;
+
+	for (matrix_entry_t *e = matrix->entries_head; e != NULL; e = e->next) {
+		unsigned int nlens;
+		matrix_entry_lens(matrix, e, &nlens);
+		unsigned long n = nlens;
+		for (int i = 0; i < e->desc->nparams; i++)
+			n *= e->nvalues[i];
+		count += n;
+	}
+
+	return count;
+}
+
+
+void matrix_print_descs(const alg_desc_t * const *descs, unsigned int ndescs,
+			const char *indent, FILE *out)
+{
+	for (int i = 0; i < ndescs; i++) {
+		const alg_desc_t *desc = descs[i];
+		fprintf(out, "%s%-16s%s\n", indent, desc->name, desc->description);
+
+		for (int j = 0; j < desc->nparams; j++) {
+			const param_desc_t *p = &desc->params[j];
+			char valstr[32];
+
+			fprintf(out, "%s  %-14s", indent, p->name);
+			if (p->type == PARAM_TYPE_ENUM) {
+				for (int k = 0; p->enum_names[k] != NULL; k++)
+					fprintf(out, "%s%s", k ? "," : "", p->enum_names[k]);
+			} else if (p->allowed != NULL) {
+				for (int k = 0; k < p->nallowed; k++) {
+					param_format_value(p, p->allowed[k], valstr, sizeof(valstr));
+					fprintf(out, "%s%s", k ? "," : "", valstr);
+				}
+			} else {
+				fprintf(out, "<uint>");
+			}
+
+			fprintf(out, " (default: ");
+			for (int k = 0; k < p->ndefaults; k++) {
+				param_format_value(p, p->defaults[k], valstr, sizeof(valstr));
+				fprintf(out, "%s%s", k ? "," : "", valstr);
+			}
+			fprintf(out, ")\n");
+		}
+	}
+}
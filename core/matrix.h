@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stdio.h>
+
+#include <core/lensched.h>
+#include <core/algset.h>
+
+
+/*
+ * Parameter matrix
+ *
+ * Expands algorithm descriptors (see alg_desc_t) with parameter values
+ * and lengths to algorithm instances in an algset.
+ * Entries are added as specification string:
+ *
+ *   <alg>[:<param>=<value>[,<value>...]]...
+ *
+ * The cartesian product over the given values is expanded. Parameters not
+ * given are expanded with their default values. The special parameter len
+ * overrides the length schedule for the entry (e.g. typical png row
+ * widths). A subset of the full product can be selected by adding
+ * multiple entries.
+ *
+ * Examples:
+ *   memcpy
+ *   png_filters:filter=up,sub:bpp=1,2,3,4,6,8
+ *   png_filters:filter=paeth:bpp=3:len=640,1920,3840
+ */
+
+
+typedef struct matrix_entry {
+	const alg_desc_t *desc;
+	unsigned int *values[PARAM_MAX];	// values per parameter
+	unsigned int nvalues[PARAM_MAX];
+	unsigned int *lens;			// lengths (NULL .. use schedule)
+	unsigned int nlens;
+
+	struct matrix_entry *next;
+} matrix_entry_t;
+
+
+typedef struct matrix {
+	const alg_desc_t * const *descs;	// known algorithm descriptors
+	unsigned int ndescs;
+	const lensched_t *lensched;		// default lengths
+
+	// linked list of entries
+	matrix_entry_t *entries_head;
+	matrix_entry_t *entries_tail;
+	unsigned int entries_len;
+
+	// position of expansion (see matrix_add_next)
+	unsigned int step;			// index in lengths
+	matrix_entry_t *entry;			// current entry (NULL .. start)
+	unsigned int idx[PARAM_MAX];		// indices of current values
+} matrix_t;
+
+
+/*
+ * create an empty matrix for the given algorithm descriptors and length
+ * schedule
+ * (descs and lensched are referenced, not copied)
+ * return: NULL on error (errno)
+ */
+matrix_t *matrix_create(
+	const alg_desc_t * const *descs,
+	unsigned int ndescs,
+	const lensched_t *lensched);
+
+
+/*
+ * destroy the matrix
+ */
+void matrix_destroy(matrix_t *matrix);
+
+
+/*
+ * parse and add an entry from specification string (see above)
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int matrix_add(matrix_t *matrix, const char *spec);
+
+
+/*
+ * add the algorithm of the next combination (unit) to algset
+ * Combinations are expanded ordered by the index in the length schedule
+ * first (as with running each length after the other), in order of the
+ * entries second and by values (last parameter changes fastest) third.
+ * Can be used as source of algset (see algset_set_source) with arg
+ * pointing to the matrix.
+ * return: 1 .. unit added; 0 .. all units added; <0 .. error (errno)
+ */
+int matrix_add_next(algset_t *algset, void *matrix);
+
+
+/*
+ * number of units (combinations) of the whole matrix
+ */
+unsigned long matrix_count(const matrix_t *matrix);
+
+
+/*
+ * print known algorithms and their parameters (usage)
+ */
+void matrix_print_descs(const alg_desc_t * const *descs, unsigned int ndescs,
+			const char *indent, FILE *out);
+
+
+#endif /* MATRIX_H */
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <core/param.h>
+
+
+int param_parse_value(const param_desc_t *desc, const char *str, unsigned int *value)
+{
+	if (desc == NULL || str == NULL || value == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	switch (desc->type) {
+	case PARAM_TYPE_ENUM:
+		for (unsigned int i = 0; desc->enum_names[i] != NULL; i++)
+			if (strcmp(desc->enum_names[i], str) == 0) {
+				*value = i;
+				return 0;
+			}
+		break;
+
+	case PARAM_TYPE_UINT: {
+		int pos = 0;
+		if (sscanf(str, "%u%n", value, &pos) != 1 || str[pos] != '\0')
+			break;
+
+		/* no restriction? */
+		if (desc->allowed == NULL)
+			return 0;
+
+		for (unsigned int i = 0; i < desc->nallowed; i++)
+			if (desc->allowed[i] == *value)
+				return 0;
+		break;
+	}
+
+	default:
+		break;
+	}
+
+	errno = EINVAL;
+	return -1;
+}
+
+
+int param_format_value(const param_desc_t *desc, unsigned int value, char *buf, size_t len)
+{
+	if (desc == NULL || buf == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	switch (desc->type) {
+	case PARAM_TYPE_ENUM:
+		return snprintf(buf, len, "%s", desc->enum_names[value]);
+	case PARAM_TYPE_UINT:
+		return snprintf(buf, len, "%u", value);
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef PARAM_H
+#define PARAM_H
+
+#include <stddef.h>
+
+
+/*
+ * Typed algorithm parameters
+ *
+ * Algorithms declare their parameters (besides len, which is given by the
+ * length schedule) with a name, a type and the values to use by default.
+ * Values of all types are represented as unsigned int:
+ *   * uint .. the value itself
+ *   * enum .. index in the list of value names
+ */
+
+
+/*
+ * maximum number of parameters per algorithm
+ */
+#define PARAM_MAX		8
+
+
+enum param_type {
+	PARAM_TYPE_UINT,
+	PARAM_TYPE_ENUM,
+};
+
+
+typedef struct param_desc {
+	const char *name;			// name of the parameter
+	enum param_type type;			// type of the parameter
+	const char * const *enum_names;		// enum: names of the values (NULL terminated)
+	const unsigned int *allowed;		// uint: allowed values (NULL .. all)
+	unsigned int nallowed;
+	const unsigned int *defaults;		// values used, if not given by the user
+	unsigned int ndefaults;
+} param_desc_t;
+
+
+/* helper to initialize value lists (allowed, defaults) of param_desc_t */
+#define PARAM_VALUES(_array_)	(_array_), (sizeof(_array_) / sizeof((_array_)[0]))
+
+
+/*
+ * parse a single value of a parameter from string
+ * return: 0 .. ok; <0 .. error (invalid or not allowed value; errno)
+ */
+int param_parse_value(const param_desc_t *desc, const char *str, unsigned int *value);
+
+
+/*
+ * format a single value of a parameter as string
+ * return: same as snprintf
+ */
+int param_format_value(const param_desc_t *desc, unsigned int value, char *buf, size_t len);
+
+
+#endif /* PARAM_H */
@@ -0,0 +1,427 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <elf.h>
+#include <link.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include <core/profile.h>
+
+
+/*
+ * EVENT
+ */
+
+static int profile_event_open(uint32_t type, uint64_t config, uint64_t period)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.sample_period = period;
+	attr.sample_type = PERF_SAMPLE_IP;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	/* calling thread on any cpu */
+	return syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+
+/* open cycles event or cpu-clock (e.g. no pmu in virtual machines) */
+static int profile_open_event(profile_t *profile)
+{
+	profile->fd = profile_event_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,
+					 PROFILE_PERIOD_CYCLES);
+	if (profile->fd >= 0) {
+		profile->event = "cycles";
+		profile->period = PROFILE_PERIOD_CYCLES;
+		return 0;
+	}
+	if (errno != ENOENT && errno != EOPNOTSUPP && errno != ENODEV)
+		return -1;
+
+	profile->fd = profile_event_open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK,
+					 PROFILE_PERIOD_CLOCK);
+	if (profile->fd < 0)
+		return -1;
+	profile->event = "cpu-clock";
+	profile->period = PROFILE_PERIOD_CLOCK;
+	return 0;
+}
+
+
+
+/*
+ * SYMBOLS
+ */
+
+static int profile_sym_cmp(const void *a, const void *b)
+{
+	const profile_sym_t *sa = a, *sb = b;
+	return sa->addr < sb->addr ? -1 : sa->addr > sb->addr;
+}
+
+
+/* load address of the binary (first object) */
+static int profile_bias_cb(struct dl_phdr_info *info, size_t size, void *data)
+{
+	*(uintptr_t *)data = info->dlpi_addr;
+	return 1;
+}
+
+
+/*
+ * add function symbols of symbol table (section)
+ * (ELF32_ST_TYPE and ELF64_ST_TYPE are the same)
+ */
+static int profile_add_syms(profile_t *profile, const uint8_t *elf, size_t elf_len,
+			    const ElfW(Shdr) *symtab, const ElfW(Shdr) *strtab)
+{
+	if (symtab->sh_offset + symtab->sh_size > elf_len ||
+	    strtab->sh_offset + strtab->sh_size > elf_len || symtab->sh_entsize == 0) {
+		errno = ENOEXEC;
+		return -1;
+	}
+
+	const char *strs = (const char *)(elf + strtab->sh_offset);
+	unsigned int n = symtab->sh_size / symtab->sh_entsize;
+
+	profile->syms = calloc(n, sizeof(profile_sym_t));
+	if (profile->syms == NULL)
+		return -1;
+
+	for (unsigned int i = 0; i < n; i++) {
+		const ElfW(Sym) *sym = (const ElfW(Sym) *)(elf + symtab->sh_offset +
+							   i * symtab->sh_entsize);
+		if (ELF64_ST_TYPE(sym->st_info) != STT_FUNC ||
+		    sym->st_shndx == SHN_UNDEF || sym->st_value == 0 ||
+		    sym->st_name >= strtab->sh_size)
+			continue;
+
+		profile_sym_t *s = &profile->syms[profile->nsyms];
+		s->name = strdup(strs + sym->st_name);
+		if (s->name == NULL)
+			return -1;
+		s->addr = sym->st_value;
+		s->size = sym->st_size;
+		profile->nsyms++;
+	}
+
+	qsort(profile->syms, profile->nsyms, sizeof(profile_sym_t), profile_sym_cmp);
+	return 0;
+}
+
+
+/*
+ * load function symbols of the running binary
+ * (symtab; dynsym if stripped -> exported functions only)
+ */
+static int profile_load_syms(profile_t *profile)
+{
+	struct stat st;
+	int ret = -1;
+
+	dl_iterate_phdr(profile_bias_cb, &profile->bias);
+
+	int fd = open("/proc/self/exe", O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return -1;
+	if (fstat(fd, &st) < 0)
+		goto __close;
+
+	const uint8_t *elf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (elf == MAP_FAILED)
+		goto __close;
+
+	const ElfW(Ehdr) *eh = (const ElfW(Ehdr) *)elf;
+	if (st.st_size < sizeof(*eh) || memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0 ||
+	    eh->e_shoff + eh->e_shnum * sizeof(ElfW(Shdr)) > st.st_size) {
+		errno = ENOEXEC;
+		goto __unmap;
+	}
+
+	const ElfW(Shdr) *sh = (const ElfW(Shdr) *)(elf + eh->e_shoff);
+	const ElfW(Shdr) *symtab = NULL;
+	for (unsigned int i = 0; i < eh->e_shnum; i++) {
+		if (sh[i].sh_type == SHT_SYMTAB)
+			symtab = &sh[i];
+		else if (sh[i].sh_type == SHT_DYNSYM && symtab == NULL)
+			symtab = &sh[i];
+	}
+
+	/* no symbols -> all samples unresolved */
+	ret = 0;
+	if (symtab != NULL && symtab->sh_link < eh->e_shnum)
+		ret = profile_add_syms(profile, elf, st.st_size, symtab, &sh[symtab->sh_link]);
+
+__unmap:
+	munmap((void *)elf, st.st_size);
+__close:
+	close(fd);
+	return ret;
+}
+
+
+/* symbol containing link-time address (NULL .. none) */
+static const profile_sym_t *profile_lookup(profile_t *profile, uintptr_t addr)
+{
+	unsigned int lo = 0, hi = profile->nsyms;
+
+	/* last symbol with address <= addr */
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (profile->syms[mid].addr <= addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == 0)
+		return NULL;
+
+	const profile_sym_t *sym = &profile->syms[lo - 1];
+	if (addr >= sym->addr + sym->size)
+		return NULL;
+	return sym;
+}
+
+
+
+/*
+ * SAMPLES
+ */
+
+static unsigned int profile_hash(uintptr_t ip, unsigned int maxhits)
+{
+	return (uint64_t)ip * 0x9e3779b97f4a7c15ULL >> 32 & (maxhits - 1);
+}
+
+
+/* add sample (table is grown on half load) */
+static int profile_add_hit(profile_t *profile, uintptr_t ip)
+{
+	if (ip == 0)
+		return 0;
+
+	if (2 * (profile->nhits + 1) > profile->maxhits) {
+		unsigned int maxhits = profile->maxhits ? 2 * profile->maxhits : 1024;
+		profile_hit_t *hits = calloc(maxhits, sizeof(profile_hit_t));
+		if (hits == NULL)
+			return -1;
+		for (unsigned int i = 0; i < profile->maxhits; i++) {
+			if (profile->hits[i].ip == 0)
+				continue;
+			unsigned int h = profile_hash(profile->hits[i].ip, maxhits);
+			while (hits[h].ip != 0)
+				h = (h + 1) & (maxhits - 1);
+			hits[h] = profile->hits[i];
+		}
+		free(profile->hits);
+		profile->hits = hits;
+		profile->maxhits = maxhits;
+	}
+
+	unsigned int h = profile_hash(ip, profile->maxhits);
+	while (profile->hits[h].ip != 0 && profile->hits[h].ip != ip)
+		h = (h + 1) & (profile->maxhits - 1);
+	if (profile->hits[h].ip == 0) {
+		profile->hits[h].ip = ip;
+		profile->nhits++;
+	}
+	profile->hits[h].count++;
+	profile->nsamples++;
+
+	return 0;
+}
+
+
+/* copy from data area of ring buffer (records may wrap around) */
+static void profile_ring_copy(profile_t *profile, uint64_t pos, void *dst, size_t len)
+{
+	const uint8_t *data = (const uint8_t *)profile->ring + profile->page_size;
+	size_t data_len = profile->ring_len - profile->page_size;
+	size_t off = pos & (data_len - 1);
+	size_t first = len < data_len - off ? len : data_len - off;
+
+	memcpy(dst, data + off, first);
+	memcpy((uint8_t *)dst + first, data, len - first);
+}
+
+
+/* accumulate all records of the ring buffer */
+static int profile_drain(profile_t *profile)
+{
+	struct perf_event_mmap_page *meta = profile->ring;
+	uint64_t head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+	uint64_t tail = meta->data_tail;
+	int ret = 0;
+
+	while (tail < head) {
+		struct perf_event_header hdr;
+		profile_ring_copy(profile, tail, &hdr, sizeof(hdr));
+		if (hdr.size == 0)
+			break;
+
+		if (hdr.type == PERF_RECORD_SAMPLE && ret == 0) {
+			uint64_t ip;
+			profile_ring_copy(profile, tail + sizeof(hdr), &ip, sizeof(ip));
+			ret = profile_add_hit(profile, ip);
+		}
+		tail += hdr.size;
+	}
+
+	/* records consumed (also on error -> no stale records) */
+	__atomic_store_n(&meta->data_tail, head, __ATOMIC_RELEASE);
+	return ret;
+}
+
+
+static int profile_hit_cmp(const void *a, const void *b)
+{
+	const profile_hit_t *ha = a, *hb = b;
+	if (ha->count != hb->count)
+		return ha->count < hb->count ? 1 : -1;
+	return ha->ip < hb->ip ? -1 : ha->ip > hb->ip;
+}
+
+
+
+/*
+ * API
+ */
+
+profile_t *profile_create(const char *path)
+{
+	if (path == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	profile_t *profile = calloc(1, sizeof(profile_t));
+	if (profile == NULL)
+		return NULL;
+	profile->fd = -1;
+	profile->ring = MAP_FAILED;
+	profile->page_size = sysconf(_SC_PAGESIZE);
+
+	if (profile_open_event(profile) < 0)
+		goto __err;
+
+	profile->ring_len = (1 + PROFILE_RING_PAGES) * profile->page_size;
+	profile->ring = mmap(NULL, profile->ring_len, PROT_READ | PROT_WRITE, MAP_SHARED,
+			     profile->fd, 0);
+	if (profile->ring == MAP_FAILED)
+		goto __err;
+
+	if (profile_load_syms(profile) < 0)
+		goto __err;
+
+	profile->f = fopen(path, "w");
+	if (profile->f == NULL)
+		goto __err;
+	fprintf(profile->f, "set;algorithm(parameters);implementation;symbol;offset;address;samples;share [%%]\n");
+
+	return profile;
+
+__err:
+	profile_destroy(profile);
+	return NULL;
+}
+
+
+int profile_start(profile_t *profile)
+{
+	if (profile == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return ioctl(profile->fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+
+int profile_stop(profile_t *profile)
+{
+	if (profile == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (ioctl(profile->fd, PERF_EVENT_IOC_DISABLE, 0) < 0)
+		return -1;
+
+	return profile_drain(profile);
+}
+
+
+int profile_report(profile_t *profile, const char *key)
+{
+	if (profile == NULL || key == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* compact table and sort by samples */
+	unsigned int n = 0;
+	for (unsigned int i = 0; i < profile->maxhits; i++)
+		if (profile->hits[i].ip != 0)
+			profile->hits[n++] = profile->hits[i];
+	qsort(profile->hits, n, sizeof(profile_hit_t), profile_hit_cmp);
+
+	for (unsigned int i = 0; i < n && i < PROFILE_REPORT_MAX; i++) {
+		profile_hit_t *hit = &profile->hits[i];
+		uintptr_t addr = hit->ip - profile->bias;
+		const profile_sym_t *sym = profile_lookup(profile, addr);
+
+		if (sym != NULL)
+			fprintf(profile->f, "%s;%s;0x%" PRIxPTR ";0x%" PRIxPTR ";",
+				key, sym->name, addr - sym->addr, addr);
+		else
+			fprintf(profile->f, "%s;?;;0x%" PRIxPTR ";", key, hit->ip);
+		fprintf(profile->f, "%" PRIu64 ";%.1f\n",
+			hit->count, 100.0 * hit->count / profile->nsamples);
+	}
+
+	/* reset */
+	if (profile->hits != NULL)
+		memset(profile->hits, 0, profile->maxhits * sizeof(profile_hit_t));
+	profile->nhits = 0;
+	profile->nsamples = 0;
+
+	return fflush(profile->f) == 0 ? 0 : -1;
+}
+
+
+void profile_destroy(profile_t *profile)
+{
+	if (profile == NULL)
+		return;
+
+	if (profile->f != NULL)
+		fclose(profile->f);
+	if (profile->ring != MAP_FAILED)
+		munmap(profile->ring, profile->ring_len);
+	if (profile->fd >= 0)
+		close(profile->fd);
+	for (unsigned int i = 0; i < profile->nsyms; i++)
+		free(profile->syms[i].name);
+	free(profile->syms);
+	free(profile->hits);
+	free(profile);
+}
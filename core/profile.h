@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*
+ * Sampling profiler (hot spots of implementations)
+ *
+ * The instruction pointer is sampled by a perf event (perf_event_open;
+ * user space cycles or, if not available, cpu-clock) enabled around the
+ * measured execution of each implementation. Samples are read from the
+ * mmap ring buffer after each execution, accumulated per instruction and
+ * resolved against the symbol table of the running binary
+ * (/proc/self/exe) -> no external perf tooling is needed.
+ *
+ * Report (csv; one block of rows per implementation, hottest first):
+ *   set;algorithm(parameters);implementation;symbol;offset;address;samples;share [%]
+ *     symbol  .. function containing the instruction ("?" .. not in the
+ *                binary, e.g. jit code or shared libraries)
+ *     offset  .. offset of the instruction in symbol
+ *     address .. address of the instruction in the binary (objdump -d;
+ *                runtime address if symbol is "?")
+ */
+
+
+/* event sample periods */
+#define PROFILE_PERIOD_CYCLES		10007	// cycles (prime -> no aliasing with loops)
+#define PROFILE_PERIOD_CLOCK		10000	// ns (cpu-clock fallback)
+
+/* ring buffer size (data pages; power of 2) */
+#define PROFILE_RING_PAGES		128
+
+/* maximum rows reported per implementation */
+#define PROFILE_REPORT_MAX		20
+
+
+/* function symbol of the binary (link-time address) */
+typedef struct profile_sym {
+	uintptr_t addr;
+	uintptr_t size;
+	char *name;
+} profile_sym_t;
+
+
+/* samples of an instruction (entry of hash table; ip 0 .. empty) */
+typedef struct profile_hit {
+	uintptr_t ip;				// runtime address
+	uint64_t count;
+} profile_hit_t;
+
+
+typedef struct profile {
+	FILE *f;				// report
+	int fd;					// perf event
+	void *ring;				// metadata page + data pages
+	size_t ring_len;
+	size_t page_size;
+	const char *event;			// name of event
+	uint64_t period;			// sample period of event
+
+	uintptr_t bias;				// load address of the binary (PIE)
+	profile_sym_t *syms;			// sorted by address
+	unsigned int nsyms;
+
+	profile_hit_t *hits;			// samples of running implementation
+	unsigned int nhits;
+	unsigned int maxhits;			// size of table (power of 2)
+	uint64_t nsamples;
+} profile_t;
+
+
+/*
+ * create profiler and report file (truncated if exists)
+ * return: NULL on error (errno; e.g. EACCES .. perf events not permitted,
+ *         see /proc/sys/kernel/perf_event_paranoid)
+ */
+profile_t *profile_create(const char *path);
+
+
+/*
+ * start sampling
+ * return: 0 on success; <0 on error (errno)
+ */
+int profile_start(profile_t *profile);
+
+
+/*
+ * stop sampling and accumulate samples of the ring buffer
+ * return: 0 on success; <0 on error (errno)
+ */
+int profile_stop(profile_t *profile);
+
+
+/*
+ * write hot spots of the accumulated samples to report and reset them
+ * key .. "<set>;<algorithm>(<parameters>);<implementation>"
+ * return: 0 on success; <0 on error (errno)
+ */
+int profile_report(profile_t *profile, const char *key);
+
+
+/* close report and destroy profiler */
+void profile_destroy(profile_t *profile);
+
+#endif /* PROFILE_H */
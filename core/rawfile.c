@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <core/rawfile.h>
+
+
+/* write header (nentries and index_offset from raw) */
+static int rawfile_write_header(rawfile_t *raw, uint64_t index_offset)
+{
+	rawfile_header_t header;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, RAWFILE_MAGIC, sizeof(RAWFILE_MAGIC));
+	header.version = RAWFILE_VERSION;
+	header.entry_size = sizeof(rawfile_entry_t);
+	header.nentries = index_offset ? raw->nentries : 0;
+	header.index_offset = index_offset;
+
+	if (fseek(raw->f, 0, SEEK_SET) < 0)
+		return -1;
+	if (fwrite(&header, sizeof(header), 1, raw->f) != 1)
+		return -1;
+
+	return 0;
+}
+
+
+static void rawfile_destroy(rawfile_t *raw)
+{
+	if (raw == NULL)
+		return;
+	if (raw->f != NULL)
+		fclose(raw->f);
+	free(raw->entries);
+	free(raw);
+}
+
+
+
+/*
+ * API
+ */
+
+rawfile_t *rawfile_create(const char *path)
+{
+	if (path == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	rawfile_t *raw = calloc(1, sizeof(rawfile_t));
+	if (raw == NULL)
+		return NULL;
+
+	raw->f = fopen(path, "w+b");
+	if (raw->f == NULL)
+		goto __err;
+
+	/* preliminary header (no entries) */
+	if (rawfile_write_header(raw, 0) < 0)
+		goto __err;
+	raw->offset = sizeof(rawfile_header_t);
+
+	return raw;
+
+__err:
+	rawfile_destroy(raw);
+	return NULL;
+}
+
+
+long rawfile_add(rawfile_t *raw, const char *key, const long long *samples,
+		 const long long *timestamps, unsigned int nsamples)
+{
+	if (raw == NULL || key == NULL || (samples == NULL && nsamples > 0)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* grow index */
+	if (raw->nentries == raw->maxentries) {
+		uint64_t max = raw->maxentries ? raw->maxentries * 2 : 64;
+		rawfile_entry_t *entries = realloc(raw->entries, max * sizeof(rawfile_entry_t));
+		if (entries == NULL)
+			return -1;
+		raw->entries = entries;
+		raw->maxentries = max;
+	}
+
+	/* samples and timestamps */
+	if (nsamples > 0 && fwrite(samples, sizeof(int64_t), nsamples, raw->f) != nsamples)
+		return -1;
+	if (timestamps != NULL && nsamples > 0 &&
+	    fwrite(timestamps, sizeof(int64_t), nsamples, raw->f) != nsamples)
+		return -1;
+
+	rawfile_entry_t *e = &raw->entries[raw->nentries];
+	memset(e, 0, sizeof(*e));
+	e->offset = raw->offset;
+	e->nsamples = nsamples;
+	strncpy(e->key, key, sizeof(e->key) - 1);
+
+	raw->offset += (uint64_t)nsamples * sizeof(int64_t);
+	if (timestamps != NULL && nsamples > 0) {
+		e->ts_offset = raw->offset;
+		raw->offset += (uint64_t)nsamples * sizeof(int64_t);
+	}
+
+	return raw->nentries++;
+}
+
+
+int rawfile_close(rawfile_t *raw)
+{
+	int ret = -1;
+
+	if (raw == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* index */
+	uint64_t index_offset = raw->offset;
+	if (raw->nentries > 0 &&
+	    fwrite(raw->entries, sizeof(rawfile_entry_t), raw->nentries, raw->f) != raw->nentries)
+		goto __ret;
+
+	/* final header */
+	if (rawfile_write_header(raw, index_offset) < 0)
+		goto __ret;
+
+	ret = fclose(raw->f);
+	raw->f = NULL;
+
+__ret:
+	rawfile_destroy(raw);
+	return ret;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef RAWFILE_H
+#define RAWFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*
+ * Raw samples file
+ *
+ * Binary file containing all single measurements (samples) and their
+ * wall-clock start times (ns since epoch) of all implementations. All
+ * values are stored in native byte order; all offsets are in bytes from
+ * the start of the file and 8 byte aligned -> the file can be memory
+ * mapped and used without parsing.
+ *
+ * Layout:
+ *   rawfile_header_t	header
+ *   int64_t[]		samples of entry 0 [ns] (measurement order)
+ *   int64_t[]		timestamps of entry 0 [ns] (optional)
+ *   int64_t[]		samples of entry 1 [ns]
+ *   int64_t[]		timestamps of entry 1 [ns] (optional)
+ *   ...
+ *   rawfile_entry_t[]	index (header.nentries at header.index_offset)
+ *
+ * The header is written with nentries = 0 on create and updated on
+ * close -> files of killed/crashed runs are detected by nentries == 0.
+ */
+
+
+#define RAWFILE_MAGIC		"RVVRRAW"
+#define RAWFILE_VERSION		2
+#define RAWFILE_KEY_LEN		232
+
+
+typedef struct rawfile_header {
+	char magic[8];				// RAWFILE_MAGIC (zero terminated)
+	uint32_t version;			// RAWFILE_VERSION
+	uint32_t entry_size;			// sizeof(rawfile_entry_t)
+	uint64_t nentries;			// number of entries in index
+	uint64_t index_offset;			// offset of index
+	uint64_t reserved[4];
+} rawfile_header_t;
+
+
+typedef struct rawfile_entry {
+	uint64_t offset;			// offset of samples
+	uint64_t nsamples;			// number of samples
+	uint64_t ts_offset;			// offset of timestamps (0 .. none)
+	char key[RAWFILE_KEY_LEN];		// "<set>;<algorithm>(<parameters>);<implementation>"
+} rawfile_entry_t;
+
+
+typedef struct rawfile {
+	FILE *f;
+	uint64_t offset;			// current write offset
+
+	// index (written on close)
+	rawfile_entry_t *entries;
+	uint64_t nentries;
+	uint64_t maxentries;
+} rawfile_t;
+
+
+/*
+ * create raw samples file (truncated if exists)
+ * return: NULL on error (errno)
+ */
+rawfile_t *rawfile_create(const char *path);
+
+
+/*
+ * add samples of an implementation
+ * key .. identification of the implementation (truncated to
+ *        RAWFILE_KEY_LEN - 1 characters)
+ * timestamps .. wall-clock start time of each sample (NULL .. none)
+ * return: >=0 .. index of entry; <0 .. error (errno)
+ */
+long rawfile_add(rawfile_t *raw, const char *key, const long long *samples,
+		 const long long *timestamps, unsigned int nsamples);
+
+
+/*
+ * write index, update header and close file
+ * (raw is destroyed also on error)
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int rawfile_close(rawfile_t *raw);
+
+
+#endif /* RAWFILE_H */
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <core/sysinfo.h>
+#include <core/rescache.h>
+
+
+/* separator of build id in machine key (see sysinfo_get_machine_key) */
+#define MACHINE_KEY_BUILD_SEP	",build="
+
+
+static void entry_destroy(rescache_entry_t *e)
+{
+	if (e == NULL)
+		return;
+	free(e->machine_key);
+	free(e->runcfg);
+	free(e->row);
+	free(e);
+}
+
+
+static rescache_entry_t *entry_create(const char *machine_key, const char *runcfg, const char *row)
+{
+	rescache_entry_t *e = calloc(1, sizeof(rescache_entry_t));
+	if (e == NULL)
+		return NULL;
+
+	e->machine_key = strdup(machine_key);
+	e->runcfg = strdup(runcfg);
+	e->row = strdup(row);
+	if (e->machine_key == NULL || e->runcfg == NULL || e->row == NULL) {
+		entry_destroy(e);
+		return NULL;
+	}
+
+	return e;
+}
+
+
+static void entry_append(rescache_t *rescache, rescache_entry_t *e)
+{
+	if (rescache->entries_tail == NULL)
+		/* first element */
+		rescache->entries_head = e;
+	else
+		rescache->entries_tail->next = e;
+	rescache->entries_tail = e;
+}
+
+
+/* does row start with rowkey (followed by separator or end)? */
+static bool row_matches(const char *row, const char *rowkey)
+{
+	size_t len = strlen(rowkey);
+	return strncmp(row, rowkey, len) == 0 && (row[len] == ';' || row[len] == '\0');
+}
+
+
+/* length of the row key (first three fields) of row */
+static size_t row_key_len(const char *row)
+{
+	const char *p = row;
+	for (int i = 0; i < 3; i++) {
+		p = strchr(p, ';');
+		if (p == NULL)
+			return strlen(row);
+		p++;
+	}
+	return p - row - 1;
+}
+
+
+/* entry of the same cpu/rvv/VLEN, but with other build id? */
+static bool machine_key_is_stale(const char *key, const char *machine_key)
+{
+	const char *sep = strstr(machine_key, MACHINE_KEY_BUILD_SEP);
+	if (sep == NULL)
+		return false;
+	size_t len = sep - machine_key + strlen(MACHINE_KEY_BUILD_SEP);
+
+	return strncmp(key, machine_key, len) == 0 && strcmp(key, machine_key) != 0;
+}
+
+
+static rescache_entry_t *entry_find(rescache_t *rescache, const char *runcfg, const char *rowkey)
+{
+	for (
+		rescache_entry_t *e = rescache->entries_head;
+		e != NULL;
+		e = e->next
+	)
+		if (
+			strcmp(e->machine_key, rescache->machine_key) == 0 &&
+			strcmp(e->runcfg, runcfg) == 0 &&
+			row_matches(e->row, rowkey)
+		)
+			return e;
+
+	return NULL;
+}
+
+
+/* parse a line of the cache file and add it as entry */
+static int rescache_parse_line(rescache_t *rescache, char *line)
+{
+	line[strcspn(line, "\r\n")] = '\0';
+
+	/* ignore empty lines */
+	if (line[0] == '\0')
+		return 0;
+
+	char *runcfg = strchr(line, ';');
+	if (runcfg == NULL)
+		goto __err_format;
+	*runcfg++ = '\0';
+
+	char *row = strchr(runcfg, ';');
+	if (row == NULL)
+		goto __err_format;
+	*row++ = '\0';
+
+	rescache_entry_t *e = entry_create(line, runcfg, row);
+	if (e == NULL)
+		return -1;
+	entry_append(rescache, e);
+
+	return 0;
+
+__err_format:
+	errno = EBADMSG;
+	return -1;
+}
+
+
+
+/*
+ * API
+ */
+
+rescache_t *rescache_load(const char *path)
+{
+	char machine_key[SYSINFO_STR_LEN * 3];
+
+	if (path == NULL || strlen(path) == 0) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (sysinfo_get_machine_key(machine_key, sizeof(machine_key)) < 0)
+		return NULL;
+
+	rescache_t *rescache = calloc(1, sizeof(rescache_t));
+	if (rescache == NULL)
+		return NULL;
+
+	rescache->path = strdup(path);
+	rescache->machine_key = strdup(machine_key);
+	if (rescache->path == NULL || rescache->machine_key == NULL)
+		goto __err;
+
+	FILE *f = fopen(path, "r");
+	if (f == NULL) {
+		/* not existing -> start with empty cache */
+		if (errno == ENOENT)
+			return rescache;
+		goto __err;
+	}
+
+	char *line = NULL;
+	size_t line_len = 0;
+	while (getline(&line, &line_len, f) != -1) {
+		if (rescache_parse_line(rescache, line) < 0) {
+			free(line);
+			fclose(f);
+			goto __err;
+		}
+	}
+	free(line);
+	fclose(f);
+
+	return rescache;
+
+__err:
+	rescache_destroy(rescache);
+	return NULL;
+}
+
+
+void rescache_destroy(rescache_t *rescache)
+{
+	if (rescache == NULL)
+		return;
+
+	rescache_entry_t *e = rescache->entries_head;
+	while (e != NULL) {
+		rescache_entry_t *n = e->next;
+		entry_destroy(e);
+		e = n;
+	}
+
+	free(rescache->path);
+	free(rescache->machine_key);
+	free(rescache);
+}
+
+
+int rescache_save(rescache_t *rescache)
+{
+	if (rescache == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* write to temporary file and replace afterwards (atomic update) */
+	size_t tmp_path_len = strlen(rescache->path) + 5;
+	char *tmp_path = malloc(tmp_path_len);
+	if (tmp_path == NULL)
+		return -1;
+	snprintf(tmp_path, tmp_path_len, "%s.tmp", rescache->path);
+
+	FILE *f = fopen(tmp_path, "w");
+	if (f == NULL)
+		goto __err_free;
+
+	for (
+		rescache_entry_t *e = rescache->entries_head;
+		e != NULL;
+		e = e->next
+	) {
+		/* drop entries of older builds on the same machine */
+		if (machine_key_is_stale(e->machine_key, rescache->machine_key))
+			continue;
+
+		if (fprintf(f, "%s;%s;%s\n", e->machine_key, e->runcfg, e->row) < 0) {
+			fclose(f);
+			goto __err_unlink;
+		}
+	}
+
+	if (fclose(f) != 0)
+		goto __err_unlink;
+
+	if (rename(tmp_path, rescache->path) < 0)
+		goto __err_unlink;
+
+	free(tmp_path);
+	return 0;
+
+__err_unlink:
+	remove(tmp_path);
+__err_free:
+	free(tmp_path);
+	return -1;
+}
+
+
+const char *rescache_lookup(rescache_t *rescache, const char *runcfg, const char *rowkey)
+{
+	if (rescache == NULL || runcfg == NULL || rowkey == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	rescache_entry_t *e = entry_find(rescache, runcfg, rowkey);
+	if (e == NULL)
+		return NULL;
+
+	rescache->hits++;
+
+	/* skip row key and separator */
+	const char *fields = e->row + strlen(rowkey);
+	if (*fields == ';')
+		fields++;
+	return fields;
+}
+
+
+int rescache_store(rescache_t *rescache, const char *runcfg, const char *row)
+{
+	if (rescache == NULL || runcfg == NULL || row == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* extract row key */
+	size_t rowkey_len = row_key_len(row);
+	char *rowkey = strndup(row, rowkey_len);
+	if (rowkey == NULL)
+		return -1;
+
+	/* replace row of existing entry */
+	rescache_entry_t *e = entry_find(rescache, runcfg, rowkey);
+	free(rowkey);
+	if (e != NULL) {
+		char *new_row = strdup(row);
+		if (new_row == NULL)
+			return -1;
+		free(e->row);
+		e->row = new_row;
+		rescache->stores++;
+		return 0;
+	}
+
+	/* add new entry */
+	e = entry_create(rescache->machine_key, runcfg, row);
+	if (e == NULL)
+		return -1;
+	entry_append(rescache, e);
+	rescache->stores++;
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef RESCACHE_H
+#define RESCACHE_H
+
+
+/*
+ * Persistent results cache
+ *
+ * Stores the csv result rows of implementations in a file. Each entry is
+ * keyed by
+ *   * machine key (cpu id, rvv draft, VLEN, build id -> see sysinfo.h)
+ *   * run configuration (iterations, random seed, ...)
+ *   * row key (set;algorithm(parameters);implementation)
+ *
+ * File format (one entry per line):
+ *   <machine key>;<run configuration>;<csv result row>
+ *
+ * Entries of other machines are preserved on save. Entries of the same
+ * cpu/rvv/VLEN, but another build id are stale and dropped on save.
+ */
+
+
+typedef struct rescache_entry {
+	char *runcfg;				// run configuration
+	char *machine_key;			// machine key
+	char *row;				// csv result row
+	struct rescache_entry *next;
+} rescache_entry_t;
+
+
+typedef struct rescache {
+	char *path;				// file path
+	char *machine_key;			// key of the running machine
+
+	// linked list of entries
+	rescache_entry_t *entries_head;
+	rescache_entry_t *entries_tail;
+
+	unsigned int hits;			// number of successful lookups
+	unsigned int stores;			// number of new/updated entries
+} rescache_t;
+
+
+/*
+ * load cache from file
+ * a non-existing file results in an empty cache (will be created on save)
+ * return: NULL on error (errno)
+ */
+rescache_t *rescache_load(const char *path);
+
+
+/*
+ * destroy cache (does not save!)
+ */
+void rescache_destroy(rescache_t *rescache);
+
+
+/*
+ * save cache to file
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int rescache_save(rescache_t *rescache);
+
+
+/*
+ * lookup result row for the running machine
+ * rowkey .. set;algorithm(parameters);implementation
+ * return: remaining fields of the result row after rowkey
+ *         (runs;fails;nmeasure;...), or NULL if not found
+ */
+const char *rescache_lookup(rescache_t *rescache, const char *runcfg, const char *rowkey);
+
+
+/*
+ * store (add or replace) result row for the running machine
+ * row .. full csv result row (set;algorithm(parameters);implementation;...)
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int rescache_store(rescache_t *rescache, const char *runcfg, const char *row);
+
+
+#endif /* RESCACHE_H */
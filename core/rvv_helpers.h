@@ -13,6 +13,17 @@
 #define RVVRADAR_RVV_SUPPORT_VER_08		2
 #define RVVRADAR_RVV_SUPPORT_VER_09_10_100	3
 
+/*
+ * Fat binary
+ * rvv kernels (*_rvv*.c) are built once per rvv draft supported by the
+ * toolchain (RVVRADAR_RVV_DRAFTS in config.mk). RVVRADAR_RVV_SUPPORT is
+ * set to the draft of the object built, and all other code is built with
+ * the highest draft.
+ * Kernels are defined with RVV_SYM -> the suffix of the draft is appended
+ * to their symbols. Algorithms declare them with RVV_DECLARE and select
+ * the variant of the running cpu with RVV_SELECT.
+ */
+
 /* build time replacement of mnemonics */
 #if RVVRADAR_RVV_SUPPORT
 
@@ -20,33 +31,99 @@
 #define VLE8_V		"vlbu.v"
 #define VLE16_V		"vlhu.v"
 #define VLE32_V		"vlwu.v"
+#define VLE64_V		"vle.v"
 #define VSE8_V		"vsb.v"
 #define VSE16_V		"vsh.v"
 #define VSE32_V		"vsw.v"
+#define VSE64_V		"vse.v"
+#define VLSE8_V		"vlsbu.v"
+#define VLSEG3E8_V	"vlseg3bu.v"
 #define VNSRL_WI	"vnsrl.vi"
+#define RVV_SYM(_name_)		_name_##_v07
 
 #elif RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_08
 #define VLE8_V		"vlbu.v"
 #define VLE16_V		"vlhu.v"
 #define VLE32_V		"vlwu.v"
+#define VLE64_V		"vle.v"
 #define VSE8_V		"vsb.v"
 #define VSE16_V		"vsh.v"
 #define VSE32_V		"vsw.v"
+#define VSE64_V		"vse.v"
+#define VLSE8_V		"vlsbu.v"
+#define VLSEG3E8_V	"vlseg3bu.v"
 #define VNSRL_WI	"vnsrl.wi"
+#define RVV_SYM(_name_)		_name_##_v08
 
 #elif RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_09_10_100
 #define VLE8_V		"vle8.v"
 #define VLE16_V		"vle16.v"
 #define VLE32_V		"vle32.v"
+#define VLE64_V		"vle64.v"
 #define VSE8_V		"vse8.v"
 #define VSE16_V		"vse16.v"
 #define VSE32_V		"vse32.v"
+#define VSE64_V		"vse64.v"
+#define VLSE8_V		"vlse8.v"
+#define VLSEG3E8_V	"vlseg3e8.v"
 #define VNSRL_WI	"vnsrl.wi"
+#define RVV_SYM(_name_)		_name_##_v10
 
 #else
 #error "unsupported RVV version -- check RVVRADAR_RVV_SUPPORT!"
 
 #endif /* RVVRADAR_RVV_SUPPORT */
-#endif /* RVVRADAR_RV_SUPPORT */
+
+
+/*
+ * declare kernel _name_ with arguments _args_ for all drafts
+ * (weak -> NULL if not built for a draft)
+ */
+#define RVV_DECLARE(_name_, _args_) \
+	extern void _name_##_v07 _args_ __attribute__((weak)); \
+	extern void _name_##_v08 _args_ __attribute__((weak)); \
+	extern void _name_##_v10 _args_ __attribute__((weak))
+
+/*
+ * variant of kernel _name_ matching the rvv draft of the running cpu
+ * (see sysinfo_get_rvv_draft; v0.7 and v0.8 are binary compatible for the
+ * instructions used -> v0.7 preferred; mnemonics above differ, encodings
+ * do not. Instructions whose encoding changed, e.g. vext.x.v of v0.7 vs.
+ * vmv.x.s of v0.8, must not be used in kernels)
+ * return: NULL .. not built for this draft (implementation is not
+ *         registered)
+ */
+#define RVV_SELECT(_name_) \
+	(sysinfo_get_rvv_draft() == RVVRADAR_RVV_SUPPORT_VER_09_10_100 ? \
+	 _name_##_v10 : \
+	 (_name_##_v07 != NULL ? _name_##_v07 : _name_##_v08))
+
+/*
+ * kernels expanded from templates (*_rvv_gen.c.in; see Makefile)
+ * The buildsystem passes the combinations of parameters of template <name>
+ * (e.g. memcpy_impl for algorithms/memcpy/impl_rvv_gen.c.in) as
+ * RVVRADAR_RVV_GEN_<name>(_X_) -> _X_(<sew>, <lmul>, <unroll>, <tail>) for
+ * each combination. Kernels are named <kernel>_e<sew>_m<lmul>_u<unroll>_<tail>.
+ * Combinations not fitting into the vector registers are not built (NULL
+ * on RVV_SELECT -> not registered).
+ */
+#define RVV_GEN_FOREACH(_name_, _X_)	RVVRADAR_RVV_GEN_##_name_(_X_)
+
+#endif /* RVVRADAR_RVV_SUPPORT */
+
+
+/*
+ * rvv C intrinsics (riscv_vector.h; v0.12 API with __riscv_ prefix)
+ * Only available for v1.0 -> kernels using them are only built for this
+ * draft (not registered on cpus with older drafts; see RVV_SELECT)
+ */
+#if (\
+	RVVRADAR_RVV_SUPPORT == RVVRADAR_RVV_SUPPORT_VER_09_10_100 && \
+	defined(__riscv_v_intrinsic) && __riscv_v_intrinsic >= 12000 \
+    )
+#define RVVRADAR_RVV_INTRINSICS		1
+#else
+#define RVVRADAR_RVV_INTRINSICS		0
+#endif /* RVVRADAR_RVV_SUPPORT */
 
 #endif /* RVV_HELPERS_H */
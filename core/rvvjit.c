@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <core/rvv_helpers.h>
+#include <core/sysinfo.h>
+#include <core/rvvjit.h>
+
+
+/* opcodes */
+#define OPC_OP		0x33
+#define OPC_OP_IMM	0x13
+#define OPC_BRANCH	0x63
+#define OPC_JALR	0x67
+#define OPC_LOAD_FP	0x07	// vector loads
+#define OPC_STORE_FP	0x27	// vector stores
+#define OPC_OP_V	0x57
+
+/* funct3 of OP-V */
+#define OPIVV		0x0
+#define OPMVV		0x2
+#define OPIVI		0x3
+#define OPCFG		0x7
+
+
+bool rvvjit_supported(void)
+{
+#if RVVRADAR_RVV_SUPPORT && defined(__riscv) && __riscv_xlen == 64
+	return (sysinfo_get_isa() & SYSINFO_ISA_RVV) &&
+	       sysinfo_get_rvv_draft() == RVVRADAR_RVV_SUPPORT_VER_09_10_100;
+#else
+	return false;
+#endif
+}
+
+
+static size_t rvvjit_code_bytes(void)
+{
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t bytes = RVVJIT_MAX_INSNS * sizeof(uint32_t);
+
+	return (bytes + page - 1) / page * page;
+}
+
+
+rvvjit_t *rvvjit_create(void)
+{
+	rvvjit_t *jit = calloc(1, sizeof(rvvjit_t));
+	if (jit == NULL)
+		return NULL;
+
+	jit->code = mmap(NULL, rvvjit_code_bytes(), PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (jit->code == MAP_FAILED) {
+		free(jit);
+		return NULL;
+	}
+	jit->size = RVVJIT_MAX_INSNS;
+
+	return jit;
+}
+
+
+void rvvjit_destroy(rvvjit_t *jit)
+{
+	if (jit == NULL)
+		return;
+
+	munmap(jit->code, rvvjit_code_bytes());
+	free(jit);
+}
+
+
+void *rvvjit_finalize(rvvjit_t *jit)
+{
+	void *entry = jit->code;
+
+	if (jit->error) {
+		fprintf(stderr, "%s: ERROR: kernel exceeds %u instructions\n",
+			__FILE__, jit->size);
+		rvvjit_destroy(jit);
+		errno = ENOSPC;
+		return NULL;
+	}
+
+	/* W^X: no longer writable from now on */
+	if (mprotect(jit->code, rvvjit_code_bytes(), PROT_READ | PROT_EXEC) < 0) {
+		rvvjit_destroy(jit);
+		return NULL;
+	}
+	__builtin___clear_cache((char *)jit->code, (char *)(jit->code + jit->pos));
+
+	free(jit);
+	return entry;
+}
+
+
+void rvvjit_emit(rvvjit_t *jit, uint32_t insn)
+{
+	if (jit->pos >= jit->size) {
+		jit->error = 1;
+		return;
+	}
+	jit->code[jit->pos++] = insn;
+}
+
+
+/*
+ * encodings
+ */
+
+static uint32_t enc_r(unsigned int funct7, unsigned int rs2, unsigned int rs1,
+		      unsigned int funct3, unsigned int rd, unsigned int opcode)
+{
+	return (funct7 << 25) | ((rs2 & 0x1f) << 20) | ((rs1 & 0x1f) << 15) |
+	       (funct3 << 12) | ((rd & 0x1f) << 7) | opcode;
+}
+
+
+static uint32_t enc_i(int imm, unsigned int rs1, unsigned int funct3,
+		      unsigned int rd, unsigned int opcode)
+{
+	return (((uint32_t)imm & 0xfff) << 20) | ((rs1 & 0x1f) << 15) |
+	       (funct3 << 12) | ((rd & 0x1f) << 7) | opcode;
+}
+
+
+/* offset in bytes (multiple of 2; +-4KiB) */
+static uint32_t enc_b(int offset, unsigned int rs2, unsigned int rs1, unsigned int funct3)
+{
+	uint32_t imm = offset;
+
+	return (((imm >> 12) & 0x1) << 31) | (((imm >> 5) & 0x3f) << 25) |
+	       ((rs2 & 0x1f) << 20) | ((rs1 & 0x1f) << 15) | (funct3 << 12) |
+	       (((imm >> 1) & 0xf) << 8) | (((imm >> 11) & 0x1) << 7) | OPC_BRANCH;
+}
+
+
+/* OP-V arithmetic (unmasked) */
+static uint32_t enc_v(unsigned int funct6, unsigned int vs2, unsigned int vs1_imm,
+		      unsigned int funct3, unsigned int vd)
+{
+	return (funct6 << 26) | (1 << 25) | ((vs2 & 0x1f) << 20) |
+	       ((vs1_imm & 0x1f) << 15) | (funct3 << 12) | ((vd & 0x1f) << 7) | OPC_OP_V;
+}
+
+
+/* vtype (v0.10/v1.0): vma=0, vta=0, vsew[5:3], vlmul[2:0] */
+static uint32_t enc_vtype(unsigned int sew, unsigned int lmul)
+{
+	return ((__builtin_ctz(sew) - 3) << 3) | __builtin_ctz(lmul);
+}
+
+
+/* width field of unit-stride loads/stores */
+static uint32_t enc_width(unsigned int eew)
+{
+	switch (eew) {
+	case 8:
+		return 0x0;
+	case 16:
+		return 0x5;
+	case 32:
+		return 0x6;
+	default:
+		return 0x7;
+	}
+}
+
+
+/*
+ * labels and branches
+ */
+
+unsigned int rvvjit_label(rvvjit_t *jit)
+{
+	return jit->pos;
+}
+
+
+void rvvjit_branch(rvvjit_t *jit, unsigned int cond, unsigned int rs1, unsigned int rs2, unsigned int label)
+{
+	int offset = ((int)label - (int)jit->pos) * 4;
+	rvvjit_emit(jit, enc_b(offset, rs2, rs1, cond));
+}
+
+
+unsigned int rvvjit_branch_fwd(rvvjit_t *jit, unsigned int cond, unsigned int rs1, unsigned int rs2)
+{
+	unsigned int at = jit->pos;
+
+	/* offset patched by rvvjit_resolve */
+	rvvjit_emit(jit, enc_b(0, rs2, rs1, cond));
+	return at;
+}
+
+
+void rvvjit_resolve(rvvjit_t *jit, unsigned int at)
+{
+	if (at >= jit->pos)
+		return;
+
+	uint32_t insn = jit->code[at];
+	unsigned int rs1 = (insn >> 15) & 0x1f;
+	unsigned int rs2 = (insn >> 20) & 0x1f;
+	unsigned int cond = (insn >> 12) & 0x7;
+
+	jit->code[at] = enc_b((jit->pos - at) * 4, rs2, rs1, cond);
+}
+
+
+/*
+ * scalar instructions
+ */
+
+void rvvjit_add(rvvjit_t *jit, unsigned int rd, unsigned int rs1, unsigned int rs2)
+{
+	rvvjit_emit(jit, enc_r(0x00, rs2, rs1, 0x0, rd, OPC_OP));
+}
+
+
+void rvvjit_sub(rvvjit_t *jit, unsigned int rd, unsigned int rs1, unsigned int rs2)
+{
+	rvvjit_emit(jit, enc_r(0x20, rs2, rs1, 0x0, rd, OPC_OP));
+}
+
+
+void rvvjit_addi(rvvjit_t *jit, unsigned int rd, unsigned int rs1, int imm)
+{
+	rvvjit_emit(jit, enc_i(imm, rs1, 0x0, rd, OPC_OP_IMM));
+}
+
+
+void rvvjit_slli(rvvjit_t *jit, unsigned int rd, unsigned int rs1, unsigned int shamt)
+{
+	rvvjit_emit(jit, enc_i(shamt & 0x3f, rs1, 0x1, rd, OPC_OP_IMM));
+}
+
+
+void rvvjit_ret(rvvjit_t *jit)
+{
+	/* jalr zero, 0(ra) */
+	rvvjit_emit(jit, enc_i(0, RVVJIT_RA, 0x0, RVVJIT_ZERO, OPC_JALR));
+}
+
+
+/*
+ * vector instructions
+ */
+
+void rvvjit_vsetvli(rvvjit_t *jit, unsigned int rd, unsigned int rs1, unsigned int sew, unsigned int lmul)
+{
+	rvvjit_emit(jit, (enc_vtype(sew, lmul) << 20) | ((rs1 & 0x1f) << 15) |
+		    (OPCFG << 12) | ((rd & 0x1f) << 7) | OPC_OP_V);
+}
+
+
+void rvvjit_vsetivli(rvvjit_t *jit, unsigned int rd, unsigned int avl, unsigned int sew, unsigned int lmul)
+{
+	rvvjit_emit(jit, (0x3 << 30) | (enc_vtype(sew, lmul) << 20) | ((avl & 0x1f) << 15) |
+		    (OPCFG << 12) | ((rd & 0x1f) << 7) | OPC_OP_V);
+}
+
+
+void rvvjit_vle(rvvjit_t *jit, unsigned int eew, unsigned int vd, unsigned int rs1)
+{
+	/* nf=0, mew=0, mop=0 (unit-stride), vm=1, lumop=0 */
+	rvvjit_emit(jit, (1 << 25) | ((rs1 & 0x1f) << 15) | (enc_width(eew) << 12) |
+		    ((vd & 0x1f) << 7) | OPC_LOAD_FP);
+}
+
+
+void rvvjit_vse(rvvjit_t *jit, unsigned int eew, unsigned int vs3, unsigned int rs1)
+{
+	rvvjit_emit(jit, (1 << 25) | ((rs1 & 0x1f) << 15) | (enc_width(eew) << 12) |
+		    ((vs3 & 0x1f) << 7) | OPC_STORE_FP);
+}
+
+
+void rvvjit_vadd_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int vs1)
+{
+	rvvjit_emit(jit, enc_v(0x00, vs2, vs1, OPIVV, vd));
+}
+
+
+void rvvjit_vsrl_vi(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int imm)
+{
+	rvvjit_emit(jit, enc_v(0x28, vs2, imm, OPIVI, vd));
+}
+
+
+void rvvjit_vnsrl_wi(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int imm)
+{
+	rvvjit_emit(jit, enc_v(0x2c, vs2, imm, OPIVI, vd));
+}
+
+
+void rvvjit_vwaddu_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int vs1)
+{
+	rvvjit_emit(jit, enc_v(0x30, vs2, vs1, OPMVV, vd));
+}
+
+
+void rvvjit_vwadd_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int vs1)
+{
+	rvvjit_emit(jit, enc_v(0x31, vs2, vs1, OPMVV, vd));
+}
+
+
+void rvvjit_vwmul_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int vs1)
+{
+	rvvjit_emit(jit, enc_v(0x3b, vs2, vs1, OPMVV, vd));
+}
+
+
+void rvvjit_vwmacc_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs1, unsigned int vs2)
+{
+	rvvjit_emit(jit, enc_v(0x3d, vs2, vs1, OPMVV, vd));
+}
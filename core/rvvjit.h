@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef RVVJIT_H
+#define RVVJIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*
+ * Tiny RVV JIT
+ *
+ * Minimal emitter of RISC-V (RV64) and RVV machine code for kernels
+ * specialized at runtime (e.g. to VLEN or bpp). Code is emitted into
+ * anonymous mmap'd pages, which are made executable (and no longer
+ * writable) and the icache is flushed on rvvjit_finalize.
+ *
+ * Only the v0.10/v1.0 encodings are emitted (vtype layout and vsetivli
+ * differ from older drafts) -> kernels are only generated if the running
+ * cpu implements this draft (see rvvjit_supported).
+ *
+ * Kernels are generated by the algorithms (impl_jit.c) and live until the
+ * process terminates. Emitter errors (code size exceeded) are collected
+ * and reported on rvvjit_finalize.
+ */
+
+
+/* maximum size of a kernel (instructions) */
+#define RVVJIT_MAX_INSNS	1024
+
+
+/* integer registers (ABI names) */
+#define RVVJIT_ZERO	0
+#define RVVJIT_RA	1
+#define RVVJIT_T0	5
+#define RVVJIT_T1	6
+#define RVVJIT_T2	7
+#define RVVJIT_A0	10
+#define RVVJIT_A1	11
+#define RVVJIT_A2	12
+#define RVVJIT_A3	13
+#define RVVJIT_A4	14
+#define RVVJIT_T3	28
+#define RVVJIT_T4	29
+#define RVVJIT_T5	30
+#define RVVJIT_T6	31
+
+
+/* branch conditions (funct3 of RISC-V branches) */
+#define RVVJIT_BEQ	0x0
+#define RVVJIT_BNE	0x1
+#define RVVJIT_BLT	0x4
+#define RVVJIT_BGE	0x5
+#define RVVJIT_BLTU	0x6
+#define RVVJIT_BGEU	0x7
+
+
+typedef struct rvvjit {
+	uint32_t *code;		// start of code (mmap'd pages)
+	unsigned int size;	// size of code (instructions)
+	unsigned int pos;	// number of instructions emitted
+	int error;		// emitter error (code size exceeded)
+} rvvjit_t;
+
+
+/*
+ * can kernels be generated and executed on the running cpu?
+ * (RV64 build and rvv v0.10/v1.0 cpu)
+ */
+bool rvvjit_supported(void);
+
+
+/*
+ * create emitter (writable code pages)
+ * return: jit on success; NULL on error (errno)
+ */
+rvvjit_t *rvvjit_create(void);
+
+
+/*
+ * finish code (read/exec, icache flush) and destroy emitter
+ * the code stays mapped for the lifetime of the process
+ * return: entry of code on success; NULL on error (errno; code is unmapped)
+ */
+void *rvvjit_finalize(rvvjit_t *jit);
+
+
+/* destroy emitter and unmap code (on generator errors) */
+void rvvjit_destroy(rvvjit_t *jit);
+
+
+/* emit raw instruction */
+void rvvjit_emit(rvvjit_t *jit, uint32_t insn);
+
+
+/*
+ * labels and branches
+ * rvvjit_label returns the current position (target of backward
+ * branches). Forward branches are emitted with rvvjit_branch_fwd and
+ * patched to the current position with rvvjit_resolve.
+ */
+unsigned int rvvjit_label(rvvjit_t *jit);
+void rvvjit_branch(rvvjit_t *jit, unsigned int cond, unsigned int rs1, unsigned int rs2, unsigned int label);
+unsigned int rvvjit_branch_fwd(rvvjit_t *jit, unsigned int cond, unsigned int rs1, unsigned int rs2);
+void rvvjit_resolve(rvvjit_t *jit, unsigned int at);
+
+
+/* scalar instructions */
+void rvvjit_add(rvvjit_t *jit, unsigned int rd, unsigned int rs1, unsigned int rs2);
+void rvvjit_sub(rvvjit_t *jit, unsigned int rd, unsigned int rs1, unsigned int rs2);
+void rvvjit_addi(rvvjit_t *jit, unsigned int rd, unsigned int rs1, int imm);
+void rvvjit_slli(rvvjit_t *jit, unsigned int rd, unsigned int rs1, unsigned int shamt);
+void rvvjit_ret(rvvjit_t *jit);
+
+
+/*
+ * vector instructions
+ * sew: 8, 16, 32, 64; lmul: 1, 2, 4, 8; tail/mask undisturbed
+ * operands in order of the assembler syntax (e.g. vadd.vv vd, vs2, vs1)
+ */
+void rvvjit_vsetvli(rvvjit_t *jit, unsigned int rd, unsigned int rs1, unsigned int sew, unsigned int lmul);
+void rvvjit_vsetivli(rvvjit_t *jit, unsigned int rd, unsigned int avl, unsigned int sew, unsigned int lmul);
+void rvvjit_vle(rvvjit_t *jit, unsigned int eew, unsigned int vd, unsigned int rs1);
+void rvvjit_vse(rvvjit_t *jit, unsigned int eew, unsigned int vs3, unsigned int rs1);
+void rvvjit_vadd_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int vs1);
+void rvvjit_vsrl_vi(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int imm);
+void rvvjit_vnsrl_wi(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int imm);
+void rvvjit_vwaddu_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int vs1);
+void rvvjit_vwadd_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int vs1);
+void rvvjit_vwmul_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs2, unsigned int vs1);
+void rvvjit_vwmacc_vv(rvvjit_t *jit, unsigned int vd, unsigned int vs1, unsigned int vs2);
+
+#endif /* RVVJIT_H */
@@ -0,0 +1,472 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <link.h>
+#include <elf.h>
+#include <time.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <sys/auxv.h>
+
+#include <core/rvv_helpers.h>
+#include <core/sysinfo.h>
+
+
+#define CPUINFO_PATH	"/proc/cpuinfo"
+#define CLOCKSOURCE_PATH	"/sys/devices/system/clocksource/clocksource0/current_clocksource"
+
+
+/*
+ * get value of first line in /proc/cpuinfo starting with key
+ * (leading and trailing whitespaces are removed)
+ * return: 0 .. found; <0 .. not found or error
+ */
+static int cpuinfo_get_value(const char *key, char *buf, size_t len)
+{
+	char line[SYSINFO_STR_LEN];
+	int ret = -1;
+
+	FILE *f = fopen(CPUINFO_PATH, "r");
+	if (f == NULL)
+		return -1;
+
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (strncmp(line, key, strlen(key)) != 0)
+			continue;
+
+		char *val = strchr(line, ':');
+		if (val == NULL)
+			continue;
+
+		/* strip whitespaces */
+		val++;
+		while (*val == ' ' || *val == '\t')
+			val++;
+		val[strcspn(val, "\r\n")] = '\0';
+
+		snprintf(buf, len, "%s", val);
+		ret = 0;
+		break;
+	}
+
+	fclose(f);
+	return ret;
+}
+
+
+/* replace characters, which would break line based result files */
+static void sanitize(char *str)
+{
+	for (; *str != '\0'; str++)
+		if (*str == ';' || *str == '\n' || *str == '\r')
+			*str = ',';
+}
+
+
+int sysinfo_get_cpu_id(char *buf, size_t len)
+{
+	char mvendorid[64], marchid[64], mimpid[64];
+
+	if (buf == NULL || len == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (
+		cpuinfo_get_value("mvendorid", mvendorid, sizeof(mvendorid)) == 0 &&
+		cpuinfo_get_value("marchid", marchid, sizeof(marchid)) == 0 &&
+		cpuinfo_get_value("mimpid", mimpid, sizeof(mimpid)) == 0
+	)
+		/* RISC-V */
+		snprintf(buf, len, "mvendorid=%s,marchid=%s,mimpid=%s",
+			 mvendorid, marchid, mimpid);
+	else if (cpuinfo_get_value("model name", buf, len) < 0)
+		/* x86 (model name) and everything else */
+		snprintf(buf, len, "unknown");
+
+	sanitize(buf);
+	return 0;
+}
+
+
+#if RVVRADAR_RVV_SUPPORT
+
+/* hwcap bit of single letter extension (see arch/riscv/include/uapi/asm/hwcap.h) */
+#define HWCAP_ISA(_letter_)	(1UL << ((_letter_) - 'A'))
+
+/* csr numbers of vtype (all drafts) and vlenb (v0.9 and later) */
+#define CSR_VTYPE		0xc21
+#define CSR_VLENB		0xc22
+
+static sigjmp_buf trial_env;
+
+
+static void trial_sigill_handler(int sig)
+{
+	siglongjmp(trial_env, 1);
+}
+
+
+/*
+ * vsetvli with e8/m1 (returns vl)
+ * Encoded by hand -> same instruction for all drafts (vtype 0 is e8/m1 in
+ * all of them) and independent of the draft of the assembler.
+ */
+static unsigned long rvv_vsetvli_e8_m1(unsigned long avl)
+{
+	register unsigned long vl asm("a0");
+	register unsigned long a1 asm("a1") = avl;
+
+	/* vsetvli a0, a1, e8, m1 */
+	asm volatile (".4byte		0x0005f557" : "=r" (vl) : "r" (a1));
+	return vl;
+}
+
+
+/*
+ * vsetvli with vtype 0x04 (returns vtype)
+ * The layout of vtype changed with v0.9 (vlmul[2:0], vsew[5:3]; before:
+ * vlmul[1:0], vsew[4:2]): 0x04 is e16/m1 in v0.7/v0.8, but the reserved
+ * vlmul 0b100 in v0.9 and later -> vill (msb) is set.
+ */
+static unsigned long rvv_vsetvli_vtype_probe(void)
+{
+	register unsigned long a1 asm("a1") = 1;
+	unsigned long vtype;
+
+	/* vsetvli a0, a1, 0x04 */
+	asm volatile (".4byte		0x0045f557" : : "r" (a1) : "a0");
+	asm volatile ("csrr		%0, %1" : "=r" (vtype) : "i" (CSR_VTYPE));
+	return vtype;
+}
+
+
+static unsigned long rvv_csrr_vlenb(void)
+{
+	unsigned long vlenb;
+	asm volatile ("csrr		%0, %1" : "=r" (vlenb) : "i" (CSR_VLENB));
+	return vlenb;
+}
+
+
+static void trial_vsetvli(void)
+{
+	rvv_vsetvli_e8_m1(1);
+}
+
+
+static volatile unsigned long trial_vtype_value;
+
+static void trial_vtype(void)
+{
+	trial_vtype_value = rvv_vsetvli_vtype_probe();
+}
+
+
+/*
+ * execute a trial function guarded by a SIGILL handler
+ * return: 1 .. supported; 0 .. not supported
+ */
+static int trial(void (*fn)(void))
+{
+	struct sigaction sa, oldsa;
+	volatile int supported = 0;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = trial_sigill_handler;
+	sigemptyset(&sa.sa_mask);
+	if (sigaction(SIGILL, &sa, &oldsa) < 0)
+		return 0;
+
+	if (sigsetjmp(trial_env, 1) == 0) {
+		fn();
+		supported = 1;
+	}
+
+	sigaction(SIGILL, &oldsa, NULL);
+	return supported;
+}
+
+
+/*
+ * probe rvv draft of the running cpu
+ * return: RVVRADAR_RVV_SUPPORT_*
+ */
+static unsigned int rvv_probe_draft(void)
+{
+	/* kernel reports V (v1.0; some vendor kernels also for v0.7) */
+	if (!(getauxval(AT_HWCAP) & HWCAP_ISA('V')) && !trial(trial_vsetvli))
+		return RVVRADAR_RVV_SUPPORT_NO;
+
+	/*
+	 * vtype layout of v0.9 and later (see rvv_vsetvli_vtype_probe)
+	 * vlenb can not be used: the v0.7.1 cores of T-Head (C906/C910)
+	 * implement it as well
+	 */
+	if (trial(trial_vtype) &&
+	    (trial_vtype_value >> (sizeof(unsigned long) * 8 - 1)))
+		return RVVRADAR_RVV_SUPPORT_VER_09_10_100;
+
+	/* v0.7 and v0.8 are binary compatible for the instructions used */
+	return RVVRADAR_RVV_SUPPORT_VER_07;
+}
+
+
+/* rvv draft of the running cpu (probed once) */
+static unsigned int rvv_cpu_draft(void)
+{
+	static int probed = 0;
+	static unsigned int draft = RVVRADAR_RVV_SUPPORT_NO;
+
+	if (!probed) {
+		draft = rvv_probe_draft();
+		probed = 1;
+	}
+	return draft;
+}
+
+#endif /* RVVRADAR_RVV_SUPPORT */
+
+
+unsigned int sysinfo_get_isa(void)
+{
+	static int probed = 0;
+	static unsigned int isa = 0;
+
+	if (probed)
+		return isa;
+	probed = 1;
+
+#if RVVRADAR_RV_SUPPORT
+	/* binary is running -> base instructions are available */
+	isa |= SYSINFO_ISA_RV;
+#endif /* RVVRADAR_RV_SUPPORT */
+
+#if RVVRADAR_RVV_SUPPORT
+	if (rvv_cpu_draft() != RVVRADAR_RVV_SUPPORT_NO)
+		isa |= SYSINFO_ISA_RVV;
+#endif /* RVVRADAR_RVV_SUPPORT */
+
+#if RVVRADAR_X86_SUPPORT
+	/* cpuid (and xgetbv for os support of avx registers) */
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2"))
+		isa |= SYSINFO_ISA_SSE2;
+	if (__builtin_cpu_supports("ssse3"))
+		isa |= SYSINFO_ISA_SSSE3;
+	if (__builtin_cpu_supports("avx2"))
+		isa |= SYSINFO_ISA_AVX2;
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+		isa |= SYSINFO_ISA_AVX512;
+#endif /* RVVRADAR_X86_SUPPORT */
+
+	return isa;
+}
+
+
+int sysinfo_get_isa_str(unsigned int isa, char *buf, size_t len)
+{
+	static const struct {
+		unsigned int isa;
+		const char *name;
+	} names[] = {
+		{ SYSINFO_ISA_RV,	"rv"	},
+		{ SYSINFO_ISA_RVV,	"rvv"	},
+		{ SYSINFO_ISA_SSE2,	"sse2"	},
+		{ SYSINFO_ISA_SSSE3,	"ssse3"	},
+		{ SYSINFO_ISA_AVX2,	"avx2"	},
+		{ SYSINFO_ISA_AVX512,	"avx512" },
+	};
+	int pos = 0;
+
+	if (isa == 0)
+		return snprintf(buf, len, "none");
+
+	buf[0] = '\0';
+	for (int i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+		if (isa & names[i].isa)
+			pos += snprintf(buf + pos, pos < len ? len - pos : 0,
+					"%s%s", pos ? "," : "", names[i].name);
+
+	return pos;
+}
+
+
+unsigned int sysinfo_get_vlen(void)
+{
+#if RVVRADAR_RVV_SUPPORT
+	/* vector instructions would trap (SIGILL) */
+	if (!(sysinfo_get_isa() & SYSINFO_ISA_RVV))
+		return 0;
+
+	if (rvv_cpu_draft() == RVVRADAR_RVV_SUPPORT_VER_09_10_100)
+		return rvv_csrr_vlenb() * 8;
+
+	/* no vlenb in older drafts -> VLMAX of e8/m1 is VLEN in bytes */
+	return rvv_vsetvli_e8_m1(~0UL) * 8;
+#else /* RVVRADAR_RVV_SUPPORT */
+	return 0;
+#endif /* RVVRADAR_RVV_SUPPORT */
+}
+
+
+unsigned int sysinfo_get_rvv_draft(void)
+{
+#if RVVRADAR_RVV_SUPPORT
+	if (rvv_cpu_draft() != RVVRADAR_RVV_SUPPORT_NO)
+		return rvv_cpu_draft();
+#endif /* RVVRADAR_RVV_SUPPORT */
+
+	/* no vector unit -> highest draft built */
+	return RVVRADAR_RVV_SUPPORT;
+}
+
+
+const char *sysinfo_get_rvv_draft_str(void)
+{
+	switch (sysinfo_get_rvv_draft()) {
+	case RVVRADAR_RVV_SUPPORT_VER_07:
+		return "v0.7";
+	case RVVRADAR_RVV_SUPPORT_VER_08:
+		return "v0.8";
+	case RVVRADAR_RVV_SUPPORT_VER_09_10_100:
+		return "v0.9/v0.10/v1.0";
+	default:
+		return "none";
+	}
+}
+
+
+/* private data for build_id_phdr_callback */
+struct build_id_search {
+	char *buf;
+	size_t len;
+	int found;
+};
+
+
+/* search GNU build-id note in the program headers of the executable */
+static int build_id_phdr_callback(struct dl_phdr_info *info, size_t size, void *data)
+{
+	struct build_id_search *s = data;
+
+	for (int i = 0; i < info->dlpi_phnum; i++) {
+		const ElfW(Phdr) *phdr = &info->dlpi_phdr[i];
+		if (phdr->p_type != PT_NOTE)
+			continue;
+
+		const char *note = (const char *)(info->dlpi_addr + phdr->p_vaddr);
+		const char *note_end = note + phdr->p_memsz;
+		while (note + sizeof(ElfW(Nhdr)) <= note_end) {
+			const ElfW(Nhdr) *nhdr = (const ElfW(Nhdr) *)note;
+			const char *name = note + sizeof(ElfW(Nhdr));
+			const unsigned char *desc = (const unsigned char *)
+						    (name + ((nhdr->n_namesz + 3) & ~3));
+
+			if (
+				nhdr->n_type == NT_GNU_BUILD_ID &&
+				nhdr->n_namesz == sizeof("GNU") &&
+				memcmp(name, "GNU", sizeof("GNU")) == 0
+			) {
+				s->buf[0] = '\0';
+				for (int j = 0; j < nhdr->n_descsz && (j * 2 + 3) <= s->len; j++)
+					sprintf(&s->buf[j * 2], "%02x", desc[j]);
+				s->found = 1;
+				return 1;
+			}
+
+			note = (const char *)desc + ((nhdr->n_descsz + 3) & ~3);
+		}
+	}
+
+	/* first entry is always the executable -> stop here */
+	return 1;
+}
+
+
+int sysinfo_get_build_id(char *buf, size_t len)
+{
+	if (buf == NULL || len == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	struct build_id_search s = {
+		.buf = buf,
+		.len = len,
+		.found = 0,
+	};
+	dl_iterate_phdr(build_id_phdr_callback, &s);
+
+	/* no build-id -> fallback to version and build time */
+	if (!s.found)
+		snprintf(buf, len, "%s %s %s", RVVRADAR_VERSION_STR, __DATE__, __TIME__);
+
+	sanitize(buf);
+	return 0;
+}
+
+
+int sysinfo_get_machine_key(char *buf, size_t len)
+{
+	char cpu_id[SYSINFO_STR_LEN];
+	char build_id[SYSINFO_STR_LEN];
+
+	if (buf == NULL || len == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (sysinfo_get_cpu_id(cpu_id, sizeof(cpu_id)) < 0)
+		return -1;
+	if (sysinfo_get_build_id(build_id, sizeof(build_id)) < 0)
+		return -1;
+
+	snprintf(buf, len, "cpu=%s,rvv=%s,vlen=%u,build=%s",
+		 cpu_id,
+		 sysinfo_get_rvv_draft_str(),
+		 sysinfo_get_vlen(),
+		 build_id);
+
+	return 0;
+}
+
+
+const char *sysinfo_get_build_flags_str(void)
+{
+	return "compiler=" __VERSION__ " " RVVRADAR_BUILD_FLAGS_STR;
+}
+
+
+int sysinfo_get_clock_str(char *buf, size_t len)
+{
+	char clocksource[64] = "unknown";
+	struct timespec res = {0};
+
+	if (buf == NULL || len == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	FILE *f = fopen(CLOCKSOURCE_PATH, "r");
+	if (f != NULL) {
+		if (fgets(clocksource, sizeof(clocksource), f) == NULL)
+			snprintf(clocksource, sizeof(clocksource), "unknown");
+		clocksource[strcspn(clocksource, "\r\n")] = '\0';
+		fclose(f);
+	}
+	clock_getres(CLOCK_MONOTONIC, &res);
+
+	snprintf(buf, len, "CLOCK_MONOTONIC,res=%lins,clocksource=%s",
+		 res.tv_sec * 1000000000L + res.tv_nsec, clocksource);
+
+	sanitize(buf);
+	return 0;
+}
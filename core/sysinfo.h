@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+#ifndef SYSINFO_H
+#define SYSINFO_H
+
+#include <stddef.h>
+
+
+/*
+ * maximum length of identification strings (including termination)
+ */
+#define SYSINFO_STR_LEN		256
+
+
+/*
+ * get identification string of the cpu
+ *
+ * taken from /proc/cpuinfo
+ *   * RISC-V: mvendorid/marchid/mimpid
+ *   * x86: model name
+ *   * other: "unknown"
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int sysinfo_get_cpu_id(char *buf, size_t len);
+
+
+/*
+ * ISA extensions (bitmask; see sysinfo_get_isa)
+ * x86 implementations are built with target attributes (e.g.
+ * __attribute__((target("avx2")))) instead of global -m flags -> the
+ * binary runs on every x86 cpu; implementations requiring extensions
+ * not supported by the cpu are skipped (see impl_req_t in algset.h)
+ */
+#define SYSINFO_ISA_RV		(1 << 0)	// RISC-V (base integer instructions)
+#define SYSINFO_ISA_RVV		(1 << 1)	// RISC-V vector extension (see sysinfo_get_rvv_draft)
+#define SYSINFO_ISA_SSE2	(1 << 2)	// x86 SSE2
+#define SYSINFO_ISA_SSSE3	(1 << 3)	// x86 SSSE3
+#define SYSINFO_ISA_AVX2	(1 << 4)	// x86 AVX2
+#define SYSINFO_ISA_AVX512	(1 << 5)	// x86 AVX-512 (F and BW)
+
+
+/*
+ * get ISA extensions supported by the running cpu (SYSINFO_ISA_*)
+ *
+ * Only extensions the binary was built for are probed (once; result is
+ * cached):
+ *   * RVV: hwcap of the kernel or a guarded trial instruction (vsetvli;
+ *     SIGILL -> not supported); the draft is probed by the layout of
+ *     vtype (vill of a vtype reserved since v0.9)
+ *   * x86: cpuid (__builtin_cpu_supports)
+ */
+unsigned int sysinfo_get_isa(void);
+
+
+/*
+ * get string of ISA extensions (e.g. "rv,rvv"; "none" if empty)
+ * return: same as snprintf
+ */
+int sysinfo_get_isa_str(unsigned int isa, char *buf, size_t len);
+
+
+/*
+ * get the vector register length (VLEN) in bits
+ * return: >0 .. VLEN; 0 .. no RVV support (build or running cpu)
+ */
+unsigned int sysinfo_get_vlen(void);
+
+
+/*
+ * get rvv draft of the kernels to use (RVVRADAR_RVV_SUPPORT_*; see
+ * RVV_SELECT in rvv_helpers.h)
+ *   * draft of the running cpu; v0.7 and v0.8 can not be told apart and
+ *     are binary compatible for the instructions used -> v0.7
+ *   * highest draft the binary was built for, if the cpu has no vector
+ *     unit (rvv implementations are skipped then; see impl_req_t)
+ *   * RVVRADAR_RVV_SUPPORT_NO, if built without rvv support
+ */
+unsigned int sysinfo_get_rvv_draft(void);
+
+
+/*
+ * get human readable string of the rvv draft (see sysinfo_get_rvv_draft)
+ * return: static string (never NULL)
+ */
+const char *sysinfo_get_rvv_draft_str(void);
+
+
+/*
+ * get build id of the running binary as hex string
+ *
+ * uses the GNU build-id note of the executable if available, and falls
+ * back to version and build time otherwise
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int sysinfo_get_build_id(char *buf, size_t len);
+
+
+/*
+ * get compiler version and flags the binary was built with
+ * (see BUILD_FLAGS_STR in Makefile)
+ * return: static string (never NULL)
+ */
+const char *sysinfo_get_build_flags_str(void);
+
+
+/*
+ * get description of the clock used for measurements
+ * (clock id, resolution and kernel clocksource)
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int sysinfo_get_clock_str(char *buf, size_t len);
+
+
+/*
+ * get machine key for the running binary on the running cpu
+ *
+ * combines cpu id, rvv draft, VLEN and build id into a single string
+ * which can be used to identify stored results
+ * return: 0 .. ok; <0 .. error (errno)
+ */
+int sysinfo_get_machine_key(char *buf, size_t len);
+
+
+#endif /* SYSINFO_H */
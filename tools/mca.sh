@@ -0,0 +1,323 @@
+#!/bin/bash
+
+# Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+# Static throughput estimation of implementations with llvm-mca
+#
+# For each function defined in the given objects of implementations
+# (impl_* files), the hot loop is extracted from the disassembly (largest
+# innermost loop: body from the target of a backward branch up to the
+# branch, without nested loops) and analyzed by llvm-mca with the given
+# scheduling model. Functions without loop are skipped.
+# Output (csv on stdout):
+#   object;symbol;algorithm;implementation;loop_insns;cycles_per_iteration;
+#   block_rthroughput;ipc;bottleneck;max_pressure
+#     algorithm      .. prefix of algorithm(parameters) in results
+#     implementation .. name of the implementation (see alg.c)
+#     bottleneck     .. none, resource (throughput bound) or latency (data
+#                       dependencies) (llvm-mca -bottleneck-analysis)
+#     max_pressure   .. resource with the highest pressure per iteration
+# With -r, the given results (csv of RVVRadar) are printed instead, with
+# columns mca_cycles_per_iteration, mca_bottleneck and mca_max_pressure
+# appended to each row of an analyzed implementation.
+
+# defaults
+OBJDUMP="objdump"
+NM="nm"
+LLVM_MCA="llvm-mca"
+TRIPLE="x86_64"
+CPU="skylake-avx512"
+MCA_ARGS=""
+ITERATIONS=100
+RESULTS=""
+
+
+usage()
+{
+  cat <<_ACEOF
+Usage: $0 [OPTION]... <object>...
+
+Estimates cycles per iteration of the hot loop of each implementation in
+the given objects with llvm-mca (csv on stdout).
+
+Options:
+  -h              display this help and exit
+  -t <triple>     target triple of llvm-mca [$TRIPLE]
+  -c <cpu>        cpu (scheduling model) of llvm-mca [$CPU]
+  -m <args>       additional arguments of llvm-mca (e.g. -mattr=+v)
+  -i <n>          iterations simulated by llvm-mca [$ITERATIONS]
+  -d <objdump>    objdump of the target [$OBJDUMP]
+  -n <nm>         nm of the target [$NM]
+  -l <llvm-mca>   llvm-mca [$LLVM_MCA]
+  -r <results>    print results (csv of RVVRadar) with estimations
+
+Example:
+  $0 -t riscv64 -c sifive-x280 -m -mattr=+v .obj/release/algorithms/*/*impl_rvv*_draft3.o
+_ACEOF
+}
+
+
+# extract hot loop of function
+# stdin .. disassembly of function (objdump -d --no-show-raw-insn)
+# stdout .. instructions of loop (assembly; branch targets replaced by labels)
+extract_loop()
+{
+	awk '
+	function hex(s,    i, c, v) {
+		v = 0
+		s = tolower(s)
+		for (i = 1; i <= length(s); i++) {
+			c = index("0123456789abcdef", substr(s, i, 1))
+			v = v * 16 + c - 1
+		}
+		return v
+	}
+	/^ *[0-9a-f]+:\t/ {
+		split($0, f, "\t")
+		a = f[1]
+		sub(/^ */, "", a)
+		sub(/:$/, "", a)
+		t = f[2]
+		for (i = 3; i in f; i++)
+			t = t " " f[i]
+		sub(/[ \t]*#.*$/, "", t)
+		sub(/[ \t]*$/, "", t)
+		if (t == "" || t ~ /^\(bad\)/)
+			next
+		n++
+		addr[n] = hex(a)
+		idx[addr[n]] = n
+		insn[n] = t
+		target[n] = -1
+		if (match(t, /[0-9a-f]+ <[^>]*>$/)) {
+			split(substr(t, RSTART), g, " ")
+			target[n] = hex(g[1])
+		}
+	}
+	END {
+		# backward branches (loops) -> start of loop
+		for (i = 1; i <= n; i++) {
+			start[i] = 0
+			if (target[i] >= 0 && target[i] <= addr[i] && (target[i] in idx))
+				start[i] = idx[target[i]]
+		}
+
+		# largest innermost loop (first on equal size)
+		best = 0
+		for (i = 1; i <= n; i++) {
+			if (start[i] == 0)
+				continue
+			inner = 1
+			for (j = start[i]; j < i; j++)
+				if (start[j] >= start[i])
+					inner = 0
+			if (inner && (best == 0 || i - start[i] > best_len)) {
+				best = i
+				best_len = i - start[i]
+			}
+		}
+		if (best == 0)
+			exit 1
+
+		print ".Lloop:"
+		for (i = start[best]; i <= best; i++) {
+			t = insn[i]
+			if (target[i] >= 0) {
+				label = target[i] == addr[start[best]] ? ".Lloop" : ".Lexit"
+				sub(/[0-9a-f]+ <[^>]*>$/, label, t)
+			}
+			print t
+		}
+	}'
+}
+
+
+# summary of llvm-mca output
+# stdin .. output of llvm-mca -bottleneck-analysis
+# stdout .. cycles_per_iteration;block_rthroughput;ipc;bottleneck;max_pressure
+parse_mca()
+{
+	awk '
+	/^Iterations:/		{ iterations = $2 }
+	/^Total Cycles:/	{ cycles = $3 }
+	/^IPC:/			{ ipc = $2 }
+	/^Block RThroughput:/	{ rthroughput = $3 }
+	/^No resource or data dependency bottlenecks/ { bottleneck = "none" }
+	/^ *Resource Pressure +\[/ {
+		match($0, /[0-9.]+%/)
+		rp = substr($0, RSTART, RLENGTH - 1) + 0
+	}
+	/^ *Data Dependencies: +\[/ {
+		match($0, /[0-9.]+%/)
+		dd = substr($0, RSTART, RLENGTH - 1) + 0
+	}
+	/^Resources:/		{ section = "resources"; next }
+	/^Resource pressure per iteration:/ { section = "pressure"; next }
+	/^$/ {
+		if (section != "pressure" || values)
+			section = ""
+		next
+	}
+	section == "resources" && /^\[/ {
+		name[$1] = $3
+		next
+	}
+	section == "pressure" && /^\[/ {
+		ncols = split($0, cols, " ")
+		next
+	}
+	section == "pressure" {
+		values = 1
+		max = -1
+		for (i = 1; i <= NF && i <= ncols; i++)
+			if ($i != "-" && $i + 0 > max) {
+				max = $i + 0
+				res = name[cols[i]]
+			}
+		section = ""
+	}
+	END {
+		if (iterations == 0)
+			exit 1
+		if (bottleneck == "")
+			bottleneck = rp >= dd ? "resource" : "latency"
+		printf "%.2f;%s;%s;%s;%s\n", cycles / iterations, rthroughput, ipc, bottleneck, res
+	}'
+}
+
+
+# implementation names of symbols (see impl_add in alg.c)
+# $1 .. alg.c
+# stdout .. <symbol> <name> (symbols without rvv draft suffix)
+impl_names()
+{
+	sed -n 's/.*impl_add(alg, *"\([^"]*\)",.*[()]\([A-Za-z_][A-Za-z0-9_]*\)[)]*;.*/\2 \1/p' "$1"
+}
+
+
+# implementation name of a symbol
+# $1 .. symbol; $2 .. alg.c
+impl_name()
+{
+	local base=$(echo "$1" | sed -e 's/_v\(07\|08\|10\)$//')
+	local name=$(impl_names "$2" | awk -v s="$base" '$1 == s { $1 = ""; sub(/^ /, ""); print; exit }')
+
+	# implementations registered by macros (see c_variants.h, rvv_helpers.h, stream, uarch)
+	[[ -z $name ]] && name=$(echo "$base" | sed -n \
+		-e 's/.*_c_byte_\(.*\)$/c byte \1/p' \
+		-e 's/.*_vext_\([0-9]*\)$/vext \1bit/p' \
+		-e 's/.*_rvv_gen_e\([0-9]*\)_m\([0-9]*\)_u\([0-9]*\)_\(.*\)$/rvv gen e\1 m\2 u\3 \4/p' \
+		-e 's/^stream_[a-z]*_c_\(.*\)$/c \1/p' \
+		-e 's/^stream_[a-z]*_rvv_\(m[0-9]*\)$/rvv \1/p' \
+		-e 's/^uarch_[a-z]*_m[0-9]*_lat$/rvv latency/p' \
+		-e 's/^uarch_[a-z]*_m[0-9]*_tput$/rvv throughput/p')
+	echo "$name"
+}
+
+
+# prefix of algorithm(parameters) of a symbol in results
+# $1 .. object; $2 .. alg.c; $3 .. symbol
+alg_prefix()
+{
+	# literal name of alg_create
+	local name=$(grep -A1 "alg_create(" "$2" | sed -n 's/^[[:space:]]*"\([^"]*\)",.*/\1/p' | head -n 1)
+	if [[ -n $name ]]; then
+		echo "$name("
+		return
+	fi
+
+	# name printed to namestr (e.g. stream_%s), if the symbol starts with it
+	local fmt=$(sed -n 's/.*snprintf(namestr, [0-9]*, "\([^"]*\)".*/\1/p' "$2" | head -n 1)
+	local re=$(echo "$fmt" | sed -e 's/%s/[a-z][a-z]*/g' -e 's/%u/[0-9][0-9]*/g')
+	name=$(echo "$3" | sed -n "s/^\($re\)_.*/\1/p")
+	if [[ -n $fmt && -n $name ]]; then
+		echo "$name("
+		return
+	fi
+
+	# <algorithm>_<filter> (png filters)
+	if [[ $(basename $1) == *_impl* ]]; then
+		echo "$(basename $(dirname $1))_$(basename $1 | sed -e 's/_impl.*//')"
+		return
+	fi
+
+	# family of namestr (e.g. stream_)
+	echo "${fmt%%%*}"
+}
+
+
+while getopts "ht:c:m:i:d:n:l:r:" opt; do
+	case $opt in
+	t)	TRIPLE="$OPTARG" ;;
+	c)	CPU="$OPTARG" ;;
+	m)	MCA_ARGS="$OPTARG" ;;
+	i)	ITERATIONS="$OPTARG" ;;
+	d)	OBJDUMP="$OPTARG" ;;
+	n)	NM="$OPTARG" ;;
+	l)	LLVM_MCA="$OPTARG" ;;
+	r)	RESULTS="$OPTARG" ;;
+	h)	usage; exit 0 ;;
+	*)	usage; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+if [[ $# -eq 0 ]]; then
+	echo "Error: Missing objects!" >&2
+	usage
+	exit 1
+fi
+
+table=$(mktemp) || exit 1
+trap "rm -f $table" EXIT
+
+echo "object;symbol;algorithm;implementation;loop_insns;cycles_per_iteration;block_rthroughput;ipc;bottleneck;max_pressure" > $table
+for obj in "$@"; do
+	src_dir=$(dirname $obj | sed -e 's|^.*/\(algorithms/\)|\1|')
+	algc="$src_dir/alg.c"
+
+	for sym in $($NM --defined-only $obj | awk '$2 ~ /^[Tt]$/ { print $3 }'); do
+		loop=$($OBJDUMP -d --no-show-raw-insn --disassemble=$sym $obj | extract_loop) || continue
+		insns=$(($(echo "$loop" | wc -l) - 1))
+		mca=$(echo "$loop" | $LLVM_MCA -mtriple=$TRIPLE -mcpu=$CPU $MCA_ARGS \
+			-iterations=$ITERATIONS -bottleneck-analysis 2> /dev/null | parse_mca)
+		if [[ -z $mca ]]; then
+			echo "Warning: llvm-mca failed on $sym ($obj)" >&2
+			continue
+		fi
+		echo "$obj;$sym;$(alg_prefix $obj $algc $sym);$(impl_name $sym $algc);$insns;$mca" >> $table
+	done
+done
+
+if [[ -z $RESULTS ]]; then
+	cat $table
+	exit 0
+fi
+
+# append estimations to results (by algorithm prefix and implementation)
+awk -F';' '
+	BEGIN { OFS = ";" }
+	FNR == NR {
+		if (FNR > 1 && $4 != "") {
+			n++
+			prefix[n] = $3
+			impl[n] = $4
+			est[n] = $6 OFS $9 OFS $10
+		}
+		next
+	}
+	FNR == 1 {
+		print $0, "mca_cycles_per_iteration", "mca_bottleneck", "mca_max_pressure"
+		next
+	}
+	{
+		e = OFS OFS
+		for (i = 1; i <= n; i++)
+			if ($3 == impl[i] && index($2, prefix[i]) == 1) {
+				e = est[i]
+				break
+			}
+		print $0, e
+	}' $table "$RESULTS"
@@ -0,0 +1,151 @@
+#!/bin/bash
+
+# Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+# Memory hierarchy baseline
+#
+# Converts the results of the stream and ptrchase algorithms (csv of
+# RVVRadar) to bandwidth and load-to-use latency and assigns each working
+# set (len in bytes) to the smallest cache level holding it. Cache sizes are
+# read from sysfs of the running machine (data and unified caches of cpu0)
+# or given by option. Output (csv on stdout):
+#   algorithm;implementation;working_set [bytes];level;bandwidth [GB/s];latency [ns]
+#     bandwidth .. bytes moved per run / tdmedian (stream)
+#     latency   .. tdmedian / loads per run (ptrchase)
+#     level     .. L<n> or DRAM (working set larger than all caches)
+# With -l, the mean per cache level, algorithm and implementation is
+# printed instead:
+#   level;algorithm;implementation;working_sets;bandwidth [GB/s];latency [ns]
+
+# defaults
+CACHES=""
+PER_LEVEL=0
+
+
+usage()
+{
+  cat <<_ACEOF
+Usage: $0 [OPTION]... [<results>]
+
+Converts the results (csv of RVVRadar; stdin if not given) of the stream
+and ptrchase algorithms to bandwidth and latency per cache level (csv).
+
+Options:
+  -h              display this help and exit
+  -c <sizes>      cache sizes in bytes from L1 (e.g. "32768 1048576")
+                  [sysfs of cpu0]
+  -l              print mean per cache level
+
+Example:
+  ./RVVRadar -x stream -x ptrchase -s 4096 -e 1073741824 -i 10 -q | $0 -l
+_ACEOF
+}
+
+
+# sizes of data and unified caches of cpu0 in bytes (ascending level)
+sysfs_caches()
+{
+	local dir
+	for dir in /sys/devices/system/cpu/cpu0/cache/index*; do
+		[[ -f $dir/size ]] || continue
+		[[ $(cat $dir/type) == Instruction ]] && continue
+		echo "$(cat $dir/level) $(cat $dir/size)"
+	done | sort -n | awk '{
+		s = $2
+		m = 1
+		if (s ~ /K$/) m = 1024
+		if (s ~ /M$/) m = 1024 * 1024
+		if (s ~ /G$/) m = 1024 * 1024 * 1024
+		sub(/[KMG]$/, "", s)
+		printf "%s%u", (NR > 1 ? " " : ""), s * m
+	}'
+}
+
+
+while getopts "hc:l" opt; do
+	case $opt in
+	c)	CACHES="$OPTARG" ;;
+	l)	PER_LEVEL=1 ;;
+	h)	usage; exit 0 ;;
+	*)	usage; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+[[ -z $CACHES ]] && CACHES=$(sysfs_caches)
+if [[ -z $CACHES ]]; then
+	echo "Warning: no cache sizes (sysfs); all levels are DRAM (see -c)!" >&2
+fi
+
+awk -F';' -v caches="$CACHES" -v per_level=$PER_LEVEL '
+BEGIN {
+	OFS = ";"
+	ncaches = split(caches, cache, " ")
+}
+function param(s, name,    v) {
+	if (!match(s, "[(,]" name "=[^,)]*"))
+		return ""
+	v = substr(s, RSTART + 1, RLENGTH - 1)
+	sub(/^[^=]*=/, "", v)
+	return v
+}
+function level(ws,    i) {
+	for (i = 1; i <= ncaches; i++)
+		if (ws + 0 <= cache[i] + 0)
+			return "L" i
+	return "DRAM"
+}
+FNR == 1 {
+	for (i = 1; i <= NF; i++)
+		col[$i] = i
+	if (!("tdmedian [ns]" in col)) {
+		print "Error: no results (tdmedian) in input" > "/dev/stderr"
+		err = 1
+		exit 1
+	}
+	if (!per_level)
+		print "algorithm", "implementation", "working_set [bytes]", "level", "bandwidth [GB/s]", "latency [ns]"
+	next
+}
+$2 ~ /^(stream_[a-z]*|ptrchase)\(/ {
+	if ($col["status"] != "ok" || $col["fails"] > 0 || $col["tdmedian [ns]"] <= 0)
+		next
+	alg = $2
+	sub(/\(.*/, "", alg)
+	t = $col["tdmedian [ns]"]
+	ws = param($2, "len")
+	bw = ""
+	lat = ""
+	if (alg == "ptrchase")
+		lat = t / param($2, "loads")
+	else
+		bw = param($2, "bytes") / t
+	lvl = level(ws)
+
+	if (!per_level) {
+		print alg, $3, ws, lvl, bw == "" ? "" : sprintf("%.2f", bw), lat == "" ? "" : sprintf("%.2f", lat)
+		next
+	}
+
+	key = lvl OFS alg OFS $3
+	if (!(key in n))
+		keys[nkeys++] = key
+	n[key]++
+	if (bw != "")
+		bw_sum[key] += bw
+	if (lat != "")
+		lat_sum[key] += lat
+}
+END {
+	if (err || !per_level)
+		exit err
+	print "level", "algorithm", "implementation", "working_sets", "bandwidth [GB/s]", "latency [ns]"
+	for (k = 0; k < nkeys; k++) {
+		key = keys[k]
+		print key, n[key],
+		      (key in bw_sum) ? sprintf("%.2f", bw_sum[key] / n[key]) : "",
+		      (key in lat_sum) ? sprintf("%.2f", lat_sum[key] / n[key]) : ""
+	}
+}' "${1:--}"
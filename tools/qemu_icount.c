@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * QEMU TCG plugin: instruction counts of RVVRadar implementations
+ *
+ * Counts the instructions executed between the start and stop markers of
+ * RVVRadar (see core/icount.h) in the classes scalar, vector config,
+ * vector load/store and vector arithmetic. On each stop marker, the counts
+ * are appended as line "<scalar> <vconfig> <vmem> <varith>\n" to the
+ * counts file and read by RVVRadar (--icount).
+ *
+ * Build (host compiler; see target icount_plugin in Makefile):
+ *   make icount_plugin QEMU_PLUGIN_INCLUDE=<dir containing qemu-plugin.h>
+ *
+ * Usage:
+ *   qemu-riscv64 -cpu rv64,v=true,vlen=256 \
+ *     -plugin tools/libqemu_icount.so,out=icount.txt \
+ *     ./RVVRadar --icount icount.txt ...
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <qemu-plugin.h>
+
+#include <core/icount.h>
+
+
+QEMU_PLUGIN_EXPORT int qemu_plugin_version = QEMU_PLUGIN_VERSION;
+
+
+/* classes of instructions (index of counts) */
+enum icount_class {
+	ICOUNT_SCALAR,
+	ICOUNT_VCONFIG,
+	ICOUNT_VMEM,
+	ICOUNT_VARITH,
+	ICOUNT_CLASSES,
+};
+
+/* major opcodes */
+#define OPC_LOAD_FP	0x07	// scalar fp and vector loads
+#define OPC_STORE_FP	0x27	// scalar fp and vector stores
+#define OPC_OP_V	0x57	// vector arithmetic and configuration
+#define OPCFG		0x7	// funct3 of vector configuration
+
+/* markers and counted instructions (udata of callbacks) */
+#define UDATA_START	((void *)(uintptr_t)(ICOUNT_CLASSES + 0))
+#define UDATA_STOP	((void *)(uintptr_t)(ICOUNT_CLASSES + 1))
+
+
+static FILE *out;
+static bool active;
+static uint64_t counts[ICOUNT_CLASSES];
+
+
+/* first (up to) four bytes of an instruction */
+static uint32_t insn_word(struct qemu_plugin_insn *insn)
+{
+	size_t len = qemu_plugin_insn_size(insn);
+	uint32_t word = 0;
+
+	if (len > sizeof(word))
+		len = sizeof(word);
+#if QEMU_PLUGIN_VERSION >= 3
+	qemu_plugin_insn_data(insn, &word, len);
+#else /* QEMU_PLUGIN_VERSION */
+	memcpy(&word, qemu_plugin_insn_data(insn), len);
+#endif /* QEMU_PLUGIN_VERSION */
+
+	return word;
+}
+
+
+/*
+ * class of an instruction
+ * The width field of loads/stores distinguishes vector (0, 5, 6, 7) and
+ * scalar fp accesses (1-4) in all rvv drafts.
+ */
+static enum icount_class insn_class(struct qemu_plugin_insn *insn)
+{
+	/* compressed instructions are scalar */
+	if (qemu_plugin_insn_size(insn) < 4)
+		return ICOUNT_SCALAR;
+
+	uint32_t word = insn_word(insn);
+	unsigned int funct3 = (word >> 12) & 0x7;
+
+	switch (word & 0x7f) {
+	case OPC_OP_V:
+		return funct3 == OPCFG ? ICOUNT_VCONFIG : ICOUNT_VARITH;
+	case OPC_LOAD_FP:
+	case OPC_STORE_FP:
+		if (funct3 == 0 || funct3 >= 5)
+			return ICOUNT_VMEM;
+		return ICOUNT_SCALAR;
+	default:
+		return ICOUNT_SCALAR;
+	}
+}
+
+
+static void vcpu_insn_exec(unsigned int vcpu_index, void *udata)
+{
+	uintptr_t c = (uintptr_t)udata;
+
+	if (udata == UDATA_START) {
+		memset(counts, 0, sizeof(counts));
+		active = true;
+		return;
+	}
+
+	if (udata == UDATA_STOP) {
+		if (!active)
+			return;
+		active = false;
+		/* complete line before the guest continues (see icount_read) */
+		fprintf(out, "%" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+			counts[ICOUNT_SCALAR], counts[ICOUNT_VCONFIG],
+			counts[ICOUNT_VMEM], counts[ICOUNT_VARITH]);
+		fflush(out);
+		return;
+	}
+
+	if (active)
+		counts[c]++;
+}
+
+
+static void vcpu_tb_trans(qemu_plugin_id_t id, struct qemu_plugin_tb *tb)
+{
+	size_t n = qemu_plugin_tb_n_insns(tb);
+
+	for (size_t i = 0; i < n; i++) {
+		struct qemu_plugin_insn *insn = qemu_plugin_tb_get_insn(tb, i);
+		void *udata;
+
+		if (qemu_plugin_insn_size(insn) == 4 && insn_word(insn) == ICOUNT_MARKER_START)
+			udata = UDATA_START;
+		else if (qemu_plugin_insn_size(insn) == 4 && insn_word(insn) == ICOUNT_MARKER_STOP)
+			udata = UDATA_STOP;
+		else
+			udata = (void *)(uintptr_t)insn_class(insn);
+
+		qemu_plugin_register_vcpu_insn_exec_cb(insn, vcpu_insn_exec,
+						       QEMU_PLUGIN_CB_NO_REGS, udata);
+	}
+}
+
+
+static void plugin_exit(qemu_plugin_id_t id, void *p)
+{
+	if (out != NULL)
+		fclose(out);
+	out = NULL;
+}
+
+
+QEMU_PLUGIN_EXPORT int qemu_plugin_install(qemu_plugin_id_t id,
+					   const qemu_info_t *info,
+					   int argc, char **argv)
+{
+	const char *path = NULL;
+
+	for (int i = 0; i < argc; i++) {
+		if (strncmp(argv[i], "out=", 4) == 0)
+			path = argv[i] + 4;
+		else {
+			fprintf(stderr, "qemu_icount: invalid argument \"%s\"\n", argv[i]);
+			return -1;
+		}
+	}
+
+	if (path == NULL) {
+		fprintf(stderr, "qemu_icount: missing argument out=<file>\n");
+		return -1;
+	}
+
+	if (strcmp(info->target_name, "riscv64") != 0 &&
+	    strcmp(info->target_name, "riscv32") != 0) {
+		fprintf(stderr, "qemu_icount: unsupported target %s\n", info->target_name);
+		return -1;
+	}
+
+	/* truncated -> counts of this run only */
+	out = fopen(path, "w");
+	if (out == NULL) {
+		perror("qemu_icount: can not open counts file");
+		return -1;
+	}
+
+	qemu_plugin_register_vcpu_tb_trans_cb(id, vcpu_tb_trans);
+	qemu_plugin_register_atexit_cb(id, plugin_exit, NULL);
+
+	return 0;
+}
@@ -0,0 +1,96 @@
+#!/bin/bash
+
+# Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+# Latency and reciprocal throughput of vector instruction classes
+#
+# Converts the results of the uarch algorithm (csv of RVVRadar) to cycles
+# per instruction. The time of one cycle is taken from the scalar add chain
+# measured with the same parameters (one dependent add per cycle; see
+# algorithms/uarch/alg.c). Output (csv on stdout):
+#   insn;lmul;len;ns_per_cycle;latency [cycles];rthroughput [cycles]
+#     latency     .. rvv latency (dependent chain) / add chain
+#     rthroughput .. rvv throughput (independent instructions) / add chain
+#     (empty if the implementation was not run, e.g. combination of insn and
+#     lmul not available, or failed)
+
+
+usage()
+{
+  cat <<_ACEOF
+Usage: $0 [OPTION]... [<results>]
+
+Converts the results (csv of RVVRadar; stdin if not given) of the uarch
+algorithm to latency and reciprocal throughput in cycles (csv).
+
+Options:
+  -h              display this help and exit
+
+Example:
+  ./RVVRadar -x uarch -s 4096 -e 4096 -i 100 -q | $0
+_ACEOF
+}
+
+
+while getopts "h" opt; do
+	case $opt in
+	h)	usage; exit 0 ;;
+	*)	usage; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+awk -F';' '
+BEGIN {
+	OFS = ";"
+}
+FNR == 1 {
+	for (i = 1; i <= NF; i++)
+		col[$i] = i
+	if (!("tdmedian [ns]" in col)) {
+		print "Error: no results (tdmedian) in input" > "/dev/stderr"
+		err = 1
+		exit 1
+	}
+	next
+}
+$2 ~ /^uarch_[a-z]+_m[0-9]+\(/ {
+	key = $2
+	if (!(key in seen)) {
+		seen[key] = 1
+		keys[nkeys++] = key
+	}
+	if ($col["status"] != "ok" || $col["fails"] > 0)
+		next
+	t[key, $3] = $col["tdmedian [ns]"]
+}
+function param(s, name,    v) {
+	if (!match(s, "[(,]" name "=[^,)]*"))
+		return ""
+	v = substr(s, RSTART + 1, RLENGTH - 1)
+	sub(/^[^=]*=/, "", v)
+	return v
+}
+function cycles(key, impl) {
+	if (!((key, impl) in t))
+		return ""
+	return sprintf("%.2f", t[key, impl] / t[key, "scalar add chain"])
+}
+END {
+	if (err)
+		exit 1
+	print "insn", "lmul", "len", "ns_per_cycle", "latency [cycles]", "rthroughput [cycles]"
+	for (k = 0; k < nkeys; k++) {
+		key = keys[k]
+		if (!((key, "scalar add chain") in t) || t[key, "scalar add chain"] <= 0) {
+			print "Warning: no reference (scalar add chain) for " key > "/dev/stderr"
+			continue
+		}
+		len = param(key, "len")
+		print param(key, "insn"), param(key, "lmul"), len,
+		      sprintf("%.3f", t[key, "scalar add chain"] / len),
+		      cycles(key, "rvv latency"), cycles(key, "rvv throughput")
+	}
+}' "${1:--}"
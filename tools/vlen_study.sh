@@ -0,0 +1,172 @@
+#!/bin/bash
+
+# Copyright (C) 2021 Manfred Schlaegl <manfred.schlaegl@gmx.at>
+#
+# SPDX-License-Identifier: GPL-3.0-only
+
+# VLEN scaling study
+#
+# Runs RVVRadar under qemu-riscv64 once per emulated VLEN with the
+# instruction count plugin (see tools/qemu_icount.c) and verification
+# enabled, and combines the results to a scaling table (csv on stdout):
+#   algorithm(parameters);implementation;insns_vlen<v>...;fails;speedup;scaling
+#     insns_vlen<v> .. instructions per run at VLEN v (empty if skipped)
+#     fails         .. failed runs over all VLENs
+#     speedup       .. insns at smallest / insns at largest VLEN
+#     scaling       .. vlen    speedup grows with VLEN (>= 3/4 of ideal; log)
+#                      partial speedup >= 1/4 of ideal
+#                      flat    bound by scalar code or dependencies between
+#                              elements (e.g. one pixel per vector)
+#                      fail    failed runs on at least one VLEN
+# Results of the single runs are kept in the output directory.
+
+# defaults
+VLENS="128 256 512 1024"
+QEMU="qemu-riscv64"
+QEMU_CPU="rv64,v=true,vlen=@VLEN@"
+PLUGIN="$(dirname $0)/libqemu_icount.so"
+BIN="./RVVRadar"
+OUTDIR="vlen_study"
+
+
+usage()
+{
+  cat <<_ACEOF
+Usage: $0 [OPTION]... -- <RVVRadar options>
+
+Runs RVVRadar under qemu for each VLEN and prints a combined scaling table
+(csv) of instruction counts per run. RVVRadar is run with the given
+options plus --verify, --quiet and --icount.
+
+Options:
+  -h              display this help and exit
+  -l <vlens>      emulated VLENs [$VLENS]
+  -q <qemu>       qemu user mode emulator [$QEMU]
+  -c <cpu>        qemu cpu (@VLEN@ is replaced) [$QEMU_CPU]
+  -p <plugin>     instruction count plugin [$PLUGIN]
+  -b <binary>     RVVRadar binary (riscv64) [$BIN]
+  -o <dir>        directory for results per VLEN [$OUTDIR]
+
+Example:
+  $0 -l "128 256 512" -- -x png_filters:bpp=1,3,4,8 -s 1024 -i 3
+_ACEOF
+}
+
+
+# combine results (csv; one file per VLEN in order of VLENS) to table
+# $@ .. result files
+combine()
+{
+	awk -F';' -v vlens="$VLENS" '
+	BEGIN {
+		nv = split(vlens, vlen, " ")
+		OFS = ";"
+	}
+	FNR == 1 {
+		f++
+		for (i = 1; i <= NF; i++)
+			col[$i] = i
+		if (!("icount_scalar" in col)) {
+			print "Error: no instruction counts in " FILENAME > "/dev/stderr"
+			err = 1
+			exit 1
+		}
+		next
+	}
+	{
+		key = $2 OFS $3
+		if (!(key in seen)) {
+			seen[key] = 1
+			keys[nkeys++] = key
+		}
+		insns[key, f] = $col["icount_scalar"] + $col["icount_vconfig"] + \
+				$col["icount_vmem"] + $col["icount_varith"]
+		fails[key] += $col["fails"]
+	}
+	END {
+		if (err || nkeys == 0)
+			exit 1
+		printf "algorithm(parameters)" OFS "implementation"
+		for (v = 1; v <= nv; v++)
+			printf OFS "insns_vlen%s", vlen[v]
+		print OFS "fails" OFS "speedup" OFS "scaling"
+
+		for (k = 0; k < nkeys; k++) {
+			key = keys[k]
+			printf "%s", key
+			first = 0
+			last = 0
+			for (v = 1; v <= nv; v++) {
+				if ((key, v) in insns) {
+					printf OFS "%u", insns[key, v]
+					if (first == 0)
+						first = v
+					last = v
+				} else
+					printf OFS
+			}
+
+			speedup = ""
+			scaling = ""
+			if (fails[key] > 0)
+				scaling = "fail"
+			else if (first > 0 && last > first && insns[key, last] > 0) {
+				speedup = insns[key, first] / insns[key, last]
+				ideal = vlen[last] / vlen[first]
+				eff = speedup > 1 ? log(speedup) / log(ideal) : 0
+				if (eff >= 0.75)
+					scaling = "vlen"
+				else if (eff >= 0.25)
+					scaling = "partial"
+				else
+					scaling = "flat"
+				speedup = sprintf("%.2f", speedup)
+			}
+			print OFS fails[key] OFS speedup OFS scaling
+		}
+	}' "$@"
+}
+
+
+while getopts "hl:q:c:p:b:o:" opt; do
+	case $opt in
+	l)	VLENS="$OPTARG" ;;
+	q)	QEMU="$OPTARG" ;;
+	c)	QEMU_CPU="$OPTARG" ;;
+	p)	PLUGIN="$OPTARG" ;;
+	b)	BIN="$OPTARG" ;;
+	o)	OUTDIR="$OPTARG" ;;
+	h)	usage; exit 0 ;;
+	*)	usage; exit 1 ;;
+	esac
+done
+shift $((OPTIND - 1))
+
+if [[ $# -eq 0 ]]; then
+	echo "Error: Missing RVVRadar options!" >&2
+	usage
+	exit 1
+fi
+if [[ ! -f $PLUGIN ]]; then
+	echo "Error: Plugin $PLUGIN not found (make icount_plugin)!" >&2
+	exit 1
+fi
+
+mkdir -p "$OUTDIR" || exit 1
+
+results=()
+for vlen in $VLENS; do
+	cpu=${QEMU_CPU//@VLEN@/$vlen}
+	icount="$OUTDIR/icount_vlen$vlen.txt"
+	result="$OUTDIR/result_vlen$vlen.csv"
+
+	echo "VLEN $vlen: $QEMU -cpu $cpu $BIN $@" >&2
+	if ! $QEMU -cpu "$cpu" -plugin "$PLUGIN,out=$icount" \
+		"$BIN" "$@" --verify --quiet --icount "$icount" > "$result"; then
+		echo "Error: Run with VLEN $vlen failed (see $result)!" >&2
+		exit 1
+	fi
+	results+=("$result")
+done
+
+combine "${results[@]}" | tee "$OUTDIR/scaling.csv"